@@ -0,0 +1,377 @@
+#include "animation.h"
+#include <math.h>
+
+// Tick a little early rather than a whole frame late
+#define TICK_SLACK_US 2000
+
+typedef struct {
+    guint id;
+    GtkWidget *widget;            // Referenced for the animation's lifetime
+    GdkFrameClock *clock;         // Bound while the widget is mapped
+    gulong map_handler;
+    gulong unmap_handler;
+    gpointer user_data;
+
+    // Transition
+    gint64 duration;              // us
+    gint64 start;                 // Frame time of the first step (0 = not started)
+    AnimationEasing easing;
+    AnimationStepFunc step;
+    AnimationDoneFunc done;
+
+    // Ticker
+    GSourceFunc tick;
+    gint64 interval;              // us, 0 = every frame
+    gint64 next_tick;
+
+    gboolean removed;             // Cancelled from inside its own callback
+} Animation;
+
+typedef struct {
+    GdkFrameClock *clock;
+    gulong update_handler;
+    gboolean updating;            // Holding gdk_frame_clock_begin_updating()
+    guint wake_source;            // Timeout to the next ticker when nothing needs every frame
+} ClockBinding;
+
+static GList *animations = NULL;
+static GList *bindings = NULL;
+static guint next_id = 1;
+static Animation *running = NULL;         // Innermost animation whose callback is on the stack
+static ClockBinding *dispatching = NULL;  // Clock whose update is being handled
+
+static void on_clock_update(GdkFrameClock *clock, gpointer user_data);
+
+// ========================================
+// EASING
+// ========================================
+
+gdouble animation_ease_linear(gdouble t) {
+    return t;
+}
+
+gdouble animation_ease_out_sine(gdouble t) {
+    return sin(t * G_PI / 2.0);
+}
+
+gdouble animation_ease_out_cubic(gdouble t) {
+    gdouble u = 1.0 - t;
+    return 1.0 - u * u * u;
+}
+
+gdouble animation_ease_in_out_cubic(gdouble t) {
+    if (t < 0.5) return 4.0 * t * t * t;
+    gdouble u = -2.0 * t + 2.0;
+    return 1.0 - u * u * u / 2.0;
+}
+
+// ========================================
+// CLOCK BINDINGS
+// ========================================
+
+static Animation* find_animation(guint id) {
+    for (GList *l = animations; l; l = l->next) {
+        Animation *anim = l->data;
+        if (anim->id == id) return anim;
+    }
+    return NULL;
+}
+
+static ClockBinding* find_binding(GdkFrameClock *clock) {
+    for (GList *l = bindings; l; l = l->next) {
+        ClockBinding *binding = l->data;
+        if (binding->clock == clock) return binding;
+    }
+    return NULL;
+}
+
+static gboolean on_wake(gpointer user_data) {
+    ClockBinding *binding = (ClockBinding *)user_data;
+    binding->wake_source = 0;
+    gdk_frame_clock_request_phase(binding->clock, GDK_FRAME_CLOCK_PHASE_UPDATE);
+    return G_SOURCE_REMOVE;
+}
+
+// Update every frame, wake for the next ticker, or let go of the clock
+static void reschedule(ClockBinding *binding) {
+    // Done once the update handler returns
+    if (binding == dispatching) return;
+
+    gboolean any = FALSE;
+    gboolean every_frame = FALSE;
+    gint64 next_tick = G_MAXINT64;
+    for (GList *l = animations; l; l = l->next) {
+        Animation *anim = l->data;
+        if (anim->clock != binding->clock) continue;
+        any = TRUE;
+        if (anim->tick && anim->interval > 0) {
+            next_tick = MIN(next_tick, anim->next_tick);
+        } else {
+            every_frame = TRUE;
+        }
+    }
+
+    if (binding->wake_source > 0) {
+        g_source_remove(binding->wake_source);
+        binding->wake_source = 0;
+    }
+    if (every_frame != binding->updating) {
+        if (every_frame) {
+            gdk_frame_clock_begin_updating(binding->clock);
+        } else {
+            gdk_frame_clock_end_updating(binding->clock);
+        }
+        binding->updating = every_frame;
+    }
+
+    if (!any) {
+        g_signal_handler_disconnect(binding->clock, binding->update_handler);
+        g_object_unref(binding->clock);
+        bindings = g_list_remove(bindings, binding);
+        g_free(binding);
+        return;
+    }
+
+    if (!every_frame) {
+        gint64 wait = next_tick - g_get_monotonic_time();
+        guint ms = wait > 0 ? (guint)((wait + 999) / 1000) : 0;
+        binding->wake_source = g_timeout_add(ms, on_wake, binding);
+    }
+}
+
+static void bind_clock(Animation *anim) {
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(anim->widget);
+    if (!clock || anim->clock) return;
+
+    anim->clock = g_object_ref(clock);
+    anim->start = 0;
+    anim->next_tick = g_get_monotonic_time() + anim->interval;
+
+    ClockBinding *binding = find_binding(clock);
+    if (!binding) {
+        binding = g_new0(ClockBinding, 1);
+        binding->clock = g_object_ref(clock);
+        binding->update_handler = g_signal_connect(clock, "update",
+                                                   G_CALLBACK(on_clock_update), binding);
+        bindings = g_list_prepend(bindings, binding);
+    }
+    reschedule(binding);
+}
+
+static void unbind_clock(Animation *anim) {
+    if (!anim->clock) return;
+
+    GdkFrameClock *clock = anim->clock;
+    anim->clock = NULL;
+
+    ClockBinding *binding = find_binding(clock);
+    if (binding) {
+        reschedule(binding);
+    }
+    g_object_unref(clock);
+}
+
+// ========================================
+// LIFETIME
+// ========================================
+
+static void free_animation(Animation *anim) {
+    g_signal_handler_disconnect(anim->widget, anim->map_handler);
+    g_signal_handler_disconnect(anim->widget, anim->unmap_handler);
+    g_object_unref(anim->widget);
+    g_free(anim);
+}
+
+static void remove_animation(Animation *anim) {
+    animations = g_list_remove(animations, anim);
+    unbind_clock(anim);
+
+    if (anim == running) {
+        anim->removed = TRUE;
+    } else {
+        free_animation(anim);
+    }
+}
+
+// Removed before `done` so it can start another animation in its place
+static void finish_transition(Animation *anim) {
+    AnimationDoneFunc done = anim->done;
+    gpointer user_data = anim->user_data;
+
+    remove_animation(anim);
+    if (done) {
+        done(user_data);
+    }
+}
+
+// Jump to the end (the widget left the screen)
+static void complete_transition(Animation *anim) {
+    Animation *outer = running;
+    running = anim;
+    anim->step(1.0, anim->user_data);
+    running = outer;
+
+    if (anim->removed) {
+        free_animation(anim);
+        return;
+    }
+    finish_transition(anim);
+}
+
+static void on_widget_map(GtkWidget *widget, gpointer user_data) {
+    bind_clock((Animation *)user_data);
+}
+
+static void on_widget_unmap(GtkWidget *widget, gpointer user_data) {
+    Animation *anim = (Animation *)user_data;
+
+    // Finished by run_animation() once its callback returns
+    if (anim == running) {
+        unbind_clock(anim);
+        return;
+    }
+
+    if (anim->tick) {
+        unbind_clock(anim);
+    } else {
+        complete_transition(anim);
+    }
+}
+
+static Animation* new_animation(GtkWidget *widget, gpointer user_data) {
+    Animation *anim = g_new0(Animation, 1);
+    anim->id = next_id++;
+    anim->widget = g_object_ref(widget);
+    anim->user_data = user_data;
+    anim->map_handler = g_signal_connect(widget, "map", G_CALLBACK(on_widget_map), anim);
+    anim->unmap_handler = g_signal_connect(widget, "unmap", G_CALLBACK(on_widget_unmap), anim);
+    animations = g_list_append(animations, anim);
+    return anim;
+}
+
+// ========================================
+// FRAME DISPATCH
+// ========================================
+
+static void run_animation(Animation *anim, gint64 frame_time) {
+    Animation *outer = running;
+    gboolean finished;
+
+    if (anim->tick) {
+        if (anim->interval > 0) {
+            if (frame_time + TICK_SLACK_US < anim->next_tick) return;
+
+            // Skip ticks missed while the main loop was busy rather than bursting
+            anim->next_tick += anim->interval;
+            if (anim->next_tick <= frame_time) {
+                anim->next_tick = frame_time + anim->interval;
+            }
+        }
+        running = anim;
+        finished = !anim->tick(anim->user_data);
+        running = outer;
+    } else {
+        if (anim->start == 0) {
+            anim->start = frame_time;
+        }
+        gdouble t = CLAMP((gdouble)(frame_time - anim->start) / anim->duration, 0.0, 1.0);
+        running = anim;
+        anim->step(anim->easing ? anim->easing(t) : t, anim->user_data);
+        running = outer;
+        finished = t >= 1.0;
+    }
+
+    if (anim->removed) {
+        free_animation(anim);
+        return;
+    }
+
+    if (anim->tick) {
+        if (finished) {
+            remove_animation(anim);
+        }
+    } else if (finished) {
+        finish_transition(anim);
+    } else if (!anim->clock) {
+        // Unmapped by its own step
+        complete_transition(anim);
+    }
+}
+
+static void on_clock_update(GdkFrameClock *clock, gpointer user_data) {
+    ClockBinding *binding = (ClockBinding *)user_data;
+    gint64 frame_time = gdk_frame_clock_get_frame_time(clock);
+
+    // Callbacks may start or cancel animations; walk a snapshot of ids
+    GArray *ids = g_array_new(FALSE, FALSE, sizeof(guint));
+    for (GList *l = animations; l; l = l->next) {
+        Animation *anim = l->data;
+        if (anim->clock == clock) {
+            g_array_append_val(ids, anim->id);
+        }
+    }
+
+    dispatching = binding;
+    for (guint i = 0; i < ids->len; i++) {
+        Animation *anim = find_animation(g_array_index(ids, guint, i));
+        if (anim && anim->clock == clock) {
+            run_animation(anim, frame_time);
+        }
+    }
+    dispatching = NULL;
+    g_array_free(ids, TRUE);
+
+    reschedule(binding);
+}
+
+// ========================================
+// PUBLIC API
+// ========================================
+
+guint animation_start(GtkWidget *widget, guint duration_ms, AnimationEasing easing,
+                      AnimationStepFunc step, AnimationDoneFunc done, gpointer user_data) {
+    g_return_val_if_fail(GTK_IS_WIDGET(widget) && step, 0);
+
+    // Nothing on screen to animate
+    if (duration_ms == 0 || !gtk_widget_get_mapped(widget)) {
+        step(1.0, user_data);
+        if (done) {
+            done(user_data);
+        }
+        return 0;
+    }
+
+    Animation *anim = new_animation(widget, user_data);
+    anim->duration = (gint64)duration_ms * 1000;
+    anim->easing = easing;
+    anim->step = step;
+    anim->done = done;
+    bind_clock(anim);
+    return anim->id;
+}
+
+guint animation_add_ticker(GtkWidget *widget, guint interval_ms, GSourceFunc tick, gpointer user_data) {
+    g_return_val_if_fail(GTK_IS_WIDGET(widget) && tick, 0);
+
+    Animation *anim = new_animation(widget, user_data);
+    anim->tick = tick;
+    anim->interval = (gint64)interval_ms * 1000;
+    if (gtk_widget_get_mapped(widget)) {
+        bind_clock(anim);
+    }
+    return anim->id;
+}
+
+void animation_cancel(guint id) {
+    if (id == 0) return;
+
+    Animation *anim = find_animation(id);
+    if (anim) {
+        remove_animation(anim);
+    }
+}
+
+void animation_clear(guint *id) {
+    animation_cancel(*id);
+    *id = 0;
+}
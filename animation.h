@@ -0,0 +1,60 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Frame-Clock Animation Scheduler
+ *
+ * Every animation and periodic display update runs here instead of on its
+ * own g_timeout, driven by the GdkFrameClock of the widget it animates so
+ * that steps land on frames rather than drifting against vsync:
+ *  - transitions run for a duration and report eased progress 0 → 1 once
+ *    per frame (the last call is always exactly 1.0);
+ *  - tickers call back every `interval_ms` (0 = every frame) until they
+ *    return G_SOURCE_REMOVE.
+ *
+ * A clock is only kept updating while something on it needs every frame;
+ * tickers with an interval wake it with a single timeout to the earliest
+ * one. Nothing runs for widgets that are not mapped: transitions jump to
+ * their end and tickers wait for the widget to be mapped again, so a
+ * hidden, idle HyprWave has no timer wakeups at all.
+ *
+ * GTK main thread only.
+ */
+
+typedef gdouble (*AnimationEasing)(gdouble t);
+
+// Eased progress in [0, 1]
+typedef void (*AnimationStepFunc)(gdouble progress, gpointer user_data);
+
+// The transition reached 1.0 (not called when cancelled)
+typedef void (*AnimationDoneFunc)(gpointer user_data);
+
+gdouble animation_ease_linear(gdouble t);
+gdouble animation_ease_out_sine(gdouble t);
+gdouble animation_ease_out_cubic(gdouble t);
+gdouble animation_ease_in_out_cubic(gdouble t);
+
+/**
+ * Start a transition on `widget`'s frame clock.
+ *
+ * If the widget is not mapped the step is called with 1.0 and `done` runs
+ * before this returns.
+ *
+ * @param easing NULL for linear
+ * @return Animation id, or 0 if it already finished
+ */
+guint animation_start(GtkWidget *widget, guint duration_ms, AnimationEasing easing,
+                      AnimationStepFunc step, AnimationDoneFunc done, gpointer user_data);
+
+// Call `tick` every `interval_ms` (0 = every frame) while `widget` is mapped
+guint animation_add_ticker(GtkWidget *widget, guint interval_ms, GSourceFunc tick, gpointer user_data);
+
+// Stop an animation or ticker without calling `done` (0 and finished ids are ignored)
+void animation_cancel(guint id);
+
+// Cancel *id and set it to 0
+void animation_clear(guint *id);
+
+#endif // ANIMATION_H
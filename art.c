@@ -12,9 +12,48 @@ void clear_album_art_container(GtkWidget *container) {
     }
 }
 
-GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size) {
-    if (!art_url || strlen(art_url) == 0 || !container) return NULL;
+// ========================================
+// TEXTURE CACHE
+// ========================================
+
+// Both sizes (main view and notification) of the last few tracks, so rapid
+// skips and back-and-forth stay decoded
+#define ART_CACHE_ENTRIES 12
+
+typedef struct {
+    gchar *url;
+    gint size;
+    guint64 mtime;                // file:// only: players that reuse one cover file
+    GdkPixbuf *pixbuf;            // Kept to scale smaller sizes from
+    GdkTexture *texture;
+} ArtCacheEntry;
+
+static GQueue art_cache = G_QUEUE_INIT;   // Most recently used first
 
+static void free_cache_entry(ArtCacheEntry *entry) {
+    g_free(entry->url);
+    g_object_unref(entry->pixbuf);
+    g_object_unref(entry->texture);
+    g_free(entry);
+}
+
+// Modification time of a file:// URL, 0 if unknown or gone
+static guint64 art_file_mtime(const gchar *art_url) {
+    if (!g_str_has_prefix(art_url, "file://")) return 0;
+
+    GFile *file = g_file_new_for_uri(art_url);
+    GFileInfo *info = g_file_query_info(file, G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                                        G_FILE_QUERY_INFO_NONE, NULL, NULL);
+    guint64 mtime = 0;
+    if (info) {
+        mtime = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+        g_object_unref(info);
+    }
+    g_object_unref(file);
+    return mtime;
+}
+
+static GdkPixbuf* decode_art(const gchar *art_url, gint size) {
     GdkPixbuf *pixbuf = NULL;
 
     if (g_str_has_prefix(art_url, "file://")) {
@@ -45,9 +84,77 @@ GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *containe
         g_object_unref(file);
     }
 
+    return pixbuf;
+}
+
+GdkTexture* art_load_texture(const gchar *art_url, gint size) {
+    if (!art_url || strlen(art_url) == 0) return NULL;
+
+    guint64 mtime = art_file_mtime(art_url);
+    ArtCacheEntry *larger = NULL;
+    GList *next;
+    for (GList *l = art_cache.head; l; l = next) {
+        ArtCacheEntry *entry = l->data;
+        next = l->next;
+        if (g_strcmp0(entry->url, art_url) != 0) continue;
+
+        // Rewritten in place; a deleted file keeps what was decoded
+        if (mtime != 0 && entry->mtime != 0 && mtime != entry->mtime) {
+            g_queue_delete_link(&art_cache, l);
+            free_cache_entry(entry);
+            continue;
+        }
+
+        if (entry->size == size) {
+            g_queue_unlink(&art_cache, l);
+            g_queue_push_head_link(&art_cache, l);
+            return g_object_ref(entry->texture);
+        }
+        if (entry->size > size && (!larger || entry->size < larger->size)) {
+            larger = entry;
+        }
+    }
+
+    // Scale from a decode we already have: the source may be a temp file
+    // that is gone by now (Chromium deletes its art quickly)
+    GdkPixbuf *pixbuf = larger
+        ? gdk_pixbuf_scale_simple(larger->pixbuf, size, size, GDK_INTERP_BILINEAR)
+        : decode_art(art_url, size);
     if (!pixbuf) return NULL;
 
-    GdkTexture *texture = gdk_texture_new_for_pixbuf(pixbuf);
+    ArtCacheEntry *entry = g_new0(ArtCacheEntry, 1);
+    entry->url = g_strdup(art_url);
+    entry->size = size;
+    entry->mtime = larger ? larger->mtime : mtime;
+    entry->pixbuf = pixbuf;
+    entry->texture = gdk_texture_new_for_pixbuf(pixbuf);
+
+    g_queue_push_head(&art_cache, entry);
+    while (g_queue_get_length(&art_cache) > ART_CACHE_ENTRIES) {
+        free_cache_entry(g_queue_pop_tail(&art_cache));
+    }
+
+    return g_object_ref(entry->texture);
+}
+
+// ========================================
+// CONTAINERS
+// ========================================
+
+GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size) {
+    if (!art_url || strlen(art_url) == 0 || !container) return NULL;
+
+    GdkTexture *texture = art_load_texture(art_url, size);
+    if (!texture) return NULL;
+
+    // Metadata updates repeat the same art; keep the picture already showing it
+    GtkWidget *current = gtk_widget_get_first_child(container);
+    if (current && GTK_IS_PICTURE(current) &&
+        gtk_picture_get_paintable(GTK_PICTURE(current)) == GDK_PAINTABLE(texture)) {
+        g_object_unref(texture);
+        return current;
+    }
+
     GtkWidget *image = gtk_picture_new_for_paintable(GDK_PAINTABLE(texture));
     gtk_widget_set_size_request(image, size, size);
 
@@ -69,7 +176,6 @@ GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *containe
     gtk_box_append(GTK_BOX(container), image);
 
     g_object_unref(texture);
-    g_object_unref(pixbuf);
 
     return image;
 }
@@ -8,6 +8,10 @@
 // The caller owns the container but the widget is automatically added
 GtkWidget* load_album_art_to_container(const gchar *art_url, GtkWidget *container, gint size);
 
+// Decoded album art, shared by every view that shows the same URL
+// Returns a new reference to a texture of at least `size` pixels, or NULL on failure
+GdkTexture* art_load_texture(const gchar *art_url, gint size);
+
 // Clear all children from an album art container
 void clear_album_art_container(GtkWidget *container);
 
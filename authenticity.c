@@ -0,0 +1,179 @@
+#include "authenticity.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SILENCE_RMS 1e-3f               // Frames below -60 dBFS are not analyzed
+#define REF_LOW_HZ 50.0                 // Reference level: mean of 50 Hz - 5 kHz
+#define REF_HIGH_HZ 5000.0
+#define CLIFF_SEARCH_HZ 10000.0         // Lowest cutoff considered
+#define CLIFF_DB 30.0                   // Drop from a band to everything 1 kHz+ above it
+#define CLIFF_CONTENT_DB 60.0           // The band below a cliff must be within this of the reference
+#define LOSSY_BELOW_HZ 20000.0          // Cliffs below this are lossy-encoder low-passes
+#define CD_NYQUIST_HZ 22050.0
+#define HIRES_CHECK_LOW_HZ 23000.0      // Ultrasonic content search range
+#define HIRES_CHECK_HIGH_HZ 40000.0
+#define HIRES_CONTENT_DB 75.0           // Ultrasonic bands within this of the reference are content
+#define BITS_USED_RATIO 0.01            // Share of samples that must need the extra bits
+
+void authenticity_init(Authenticity *auth) {
+    memset(auth, 0, sizeof(*auth));
+}
+
+void authenticity_configure(Authenticity *auth, uint32_t rate, uint32_t channels) {
+    auth->rate = rate;
+    auth->channels = channels;
+    if (rate == 0 || channels == 0) {
+        auth->rate = 0;
+        return;
+    }
+
+    // ~47 Hz bins at any rate
+    uint32_t n = fft_floor_pow2(rate / 24);
+    fft_plan(&auth->plan, n);
+    for (uint32_t i = 0; i < n; i++) {
+        auth->window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / (n - 1)));
+    }
+
+    authenticity_reset(auth);
+}
+
+void authenticity_reset(Authenticity *auth) {
+    memset(auth->ltas, 0, sizeof(auth->ltas));
+    auth->ltas_frames = 0;
+    auth->frame_fill = 0;
+    auth->samples = 0;
+    auth->samples_24 = 0;
+    auth->samples_fine = 0;
+}
+
+static void analyze_frame(Authenticity *auth) {
+    const uint32_t n = auth->plan.n;
+
+    float energy = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        energy += auth->frame[i] * auth->frame[i];
+    }
+    if (energy < SILENCE_RMS * SILENCE_RMS * n) return;
+
+    for (uint32_t i = 0; i < n; i++) {
+        auth->re[i] = auth->frame[i] * auth->window[i];
+    }
+    fft_forward_real(&auth->plan, auth->re, auth->im);
+
+    for (uint32_t k = 0; k <= n / 2; k++) {
+        auth->ltas[k] += (double)auth->re[k] * auth->re[k] + (double)auth->im[k] * auth->im[k];
+    }
+    auth->ltas_frames++;
+}
+
+void authenticity_process(Authenticity *auth, const float *samples, size_t n_frames, uint32_t stride) {
+    if (auth->rate == 0 || auth->plan.n == 0) return;
+
+    const uint32_t channels = auth->channels;
+    const float scale = 1.0f / (float)channels;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * stride;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; c++) {
+            float x = frame[c];
+            sum += x;
+            if (x == 0.0f || !(fabsf(x) < 128.0f)) continue;
+
+            // Where on the 16/24-bit grids does this sample sit?
+            float y = x * 8388608.0f;
+            auth->samples++;
+            if (y != (float)(int32_t)y) {
+                auth->samples_fine++;
+            } else if ((int32_t)y & 0xFF) {
+                auth->samples_24++;
+            }
+        }
+
+        auth->frame[auth->frame_fill++] = sum * scale;
+        if (auth->frame_fill == auth->plan.n) {
+            analyze_frame(auth);
+            auth->frame_fill = 0;
+        }
+    }
+}
+
+// Mean power (dB) of the LTAS over [lo, hi) Hz
+static double band_db(const Authenticity *auth, double lo, double hi) {
+    const double bin_hz = (double)auth->rate / auth->plan.n;
+    uint32_t first = (uint32_t)ceil(lo / bin_hz);
+    uint32_t last = (uint32_t)ceil(hi / bin_hz);
+    if (last > auth->plan.n / 2 + 1) last = auth->plan.n / 2 + 1;
+    if (last <= first) return -300.0;
+
+    double sum = 0.0;
+    for (uint32_t k = first; k < last; k++) {
+        sum += auth->ltas[k];
+    }
+    return 10.0 * log10(sum / ((last - first) * (double)auth->ltas_frames) + 1e-30);
+}
+
+void authenticity_get_report(const Authenticity *auth, AuthenticityReport *report) {
+    memset(report, 0, sizeof(*report));
+    if (auth->rate == 0) return;
+
+    if (auth->samples >= auth->rate) {
+        if (auth->samples_fine > auth->samples * BITS_USED_RATIO) {
+            report->bits = 32;
+        } else if (auth->samples_24 > auth->samples * BITS_USED_RATIO) {
+            report->bits = 24;
+        } else {
+            report->bits = 16;
+        }
+    }
+
+    report->seconds = (double)auth->ltas_frames * auth->plan.n / auth->rate;
+    if (report->seconds < AUTHENTICITY_MIN_SECONDS) return;
+
+    const double nyquist = auth->rate / 2.0;
+    int n_bands = (int)(nyquist / AUTHENTICITY_BAND_HZ);
+    if (n_bands > AUTHENTICITY_MAX_BANDS) n_bands = AUTHENTICITY_MAX_BANDS;
+
+    double levels[AUTHENTICITY_MAX_BANDS];
+    for (int b = 0; b < n_bands; b++) {
+        levels[b] = band_db(auth, b * AUTHENTICITY_BAND_HZ, (b + 1) * AUTHENTICITY_BAND_HZ);
+    }
+    double ref = band_db(auth, REF_LOW_HZ, REF_HIGH_HZ);
+
+    // Highest band with real content that everything 1 kHz and more above falls well below
+    double above = -300.0;
+    int first = (int)(CLIFF_SEARCH_HZ / AUTHENTICITY_BAND_HZ);
+    for (int b = n_bands - 3; b >= first; b--) {
+        if (levels[b + 2] > above) above = levels[b + 2];
+        if (levels[b] >= ref - CLIFF_CONTENT_DB && levels[b] - above >= CLIFF_DB) {
+            report->cutoff_hz = (b + 1) * AUTHENTICITY_BAND_HZ;
+            break;
+        }
+    }
+
+    if (report->cutoff_hz > 0.0 && report->cutoff_hz < LOSSY_BELOW_HZ) {
+        report->verdict = AUTHENTICITY_LOSSY;
+        return;
+    }
+    if (nyquist <= 24000.0) {
+        report->verdict = AUTHENTICITY_CLEAN;
+        return;
+    }
+
+    // Hi-res rate: a CD-style shelf or nothing above 22.05 kHz means upsampled
+    if (report->cutoff_hz > 0.0 && report->cutoff_hz <= CD_NYQUIST_HZ + AUTHENTICITY_BAND_HZ) {
+        report->verdict = AUTHENTICITY_UPSAMPLED;
+        return;
+    }
+    double ultrasonic = -300.0;
+    double top = fmin(HIRES_CHECK_HIGH_HZ, nyquist - 2.0 * AUTHENTICITY_BAND_HZ);
+    for (double f = HIRES_CHECK_LOW_HZ; f + AUTHENTICITY_BAND_HZ <= top; f += AUTHENTICITY_BAND_HZ) {
+        double level = band_db(auth, f, f + AUTHENTICITY_BAND_HZ);
+        if (level > ultrasonic) ultrasonic = level;
+    }
+    report->verdict = ultrasonic >= ref - HIRES_CONTENT_DB ? AUTHENTICITY_HIRES : AUTHENTICITY_UPSAMPLED;
+}
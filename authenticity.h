@@ -0,0 +1,78 @@
+#ifndef AUTHENTICITY_H
+#define AUTHENTICITY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fft.h"
+
+/**
+ * Hi-Res Authenticity Analysis
+ *
+ * Per-track, bounded-memory checks on the native-rate capture:
+ *  - a long-term average spectrum (back-to-back Hann FFT frames of
+ *    ~21 ms, silent ones skipped) is searched for a hard
+ *    low-pass "cliff" (lossy encoders: ~16 kHz / 19-20 kHz; CD-rate
+ *    sources upsampled to hi-res: 20-22 kHz) and, at rates above 48 kHz,
+ *    for any real content above 22.05 kHz;
+ *  - every sample is checked against the 16- and 24-bit grids to find the
+ *    bit depth actually in use (float = altered by volume or DSP).
+ *
+ * Memory is fixed regardless of track length. Plain C with no GTK, GLib or
+ * PipeWire dependency; never allocates.
+ */
+
+#define AUTHENTICITY_MIN_SECONDS 5.0    // Analyzed audio needed before a verdict
+#define AUTHENTICITY_BAND_HZ 500.0      // Resolution of the cutoff search
+#define AUTHENTICITY_MAX_BANDS 200      // 500 Hz bands up to 100 kHz
+
+typedef enum {
+    AUTHENTICITY_UNKNOWN,               // Not enough audio yet
+    AUTHENTICITY_CLEAN,                 // <= 48 kHz with no lossy cutoff
+    AUTHENTICITY_HIRES,                 // Real content above 22.05 kHz
+    AUTHENTICITY_UPSAMPLED,             // Hi-res rate, CD-rate content
+    AUTHENTICITY_LOSSY,                 // Hard cutoff below 20 kHz
+} AuthenticityVerdict;
+
+typedef struct {
+    AuthenticityVerdict verdict;
+    double cutoff_hz;                   // Detected cliff, 0 if none
+    int bits;                           // 16, 24, or 32 for float/processed; 0 = unknown
+    double seconds;                     // Non-silent audio analyzed so far
+} AuthenticityReport;
+
+typedef struct {
+    uint32_t rate;                      // 0 until configured
+    uint32_t channels;
+
+    FftPlan plan;
+    float window[FFT_MAX_SIZE];
+    float frame[FFT_MAX_SIZE];          // Mono frame being collected
+    uint32_t frame_fill;
+    float re[FFT_MAX_SIZE];
+    float im[FFT_MAX_SIZE];
+
+    double ltas[FFT_MAX_SIZE / 2 + 1];  // Summed power per bin
+    uint32_t ltas_frames;
+
+    // Bit-depth usage (non-zero samples only)
+    uint64_t samples;
+    uint64_t samples_24;                // Need more than 16 bits
+    uint64_t samples_fine;              // Off the 24-bit grid
+} Authenticity;
+
+// Zero all state; the analyzer ignores input until authenticity_configure()
+void authenticity_init(Authenticity *auth);
+
+// Apply a negotiated format (restarts the analysis)
+void authenticity_configure(Authenticity *auth, uint32_t rate, uint32_t channels);
+
+// Forget everything learned about the current track
+void authenticity_reset(Authenticity *auth);
+
+// Feed interleaved F32 frames with `stride` floats per frame (>= channels)
+void authenticity_process(Authenticity *auth, const float *samples, size_t n_frames, uint32_t stride);
+
+// Classify what has been seen so far (cheap enough to call ~1/s)
+void authenticity_get_report(const Authenticity *auth, AuthenticityReport *report);
+
+#endif // AUTHENTICITY_H
@@ -0,0 +1,820 @@
+/**
+ * Visualizer DSP Bench
+ *
+ * Offline harness for the visualizer analysis (visualizer_dsp.c, loudness.c,
+ * spectrogram.c, goniometer.c). Links the DSP without GTK or
+ * PipeWire, feeds deterministic synthetic signals (and optional WAV files)
+ * through it at several quantum sizes and reports:
+ *   - ns per input frame
+ *   - heap allocations made while processing (must be 0 for the RT path)
+ *   - mean per-band output, for golden-file comparison
+ *
+ * Usage:
+ *   visualizer_bench [--rate HZ] [--analysis-rate HZ] [--planar]
+ *                    [--quantum N]... [--wav FILE]...
+ *                    [--golden FILE | --write-golden FILE]
+ */
+
+#define _GNU_SOURCE
+#include "../authenticity.h"
+#include "../chroma.h"
+#include "../goniometer.h"
+#include "../loudness.h"
+#include "../oscilloscope.h"
+#include "../spectrogram.h"
+#include "../visualizer_dsp.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_SECONDS 4
+#define BENCH_CHANNELS 2
+#define MAX_QUANTA 16
+#define MAX_WAVS 16
+#define MAX_SYNTHETIC 16
+#define GOLDEN_TOLERANCE 1e-4
+
+// ========================================
+// ALLOCATION COUNTING
+// ========================================
+
+// Interpose the allocator so allocations made inside the DSP are visible.
+// Forwards to glibc's internal entry points.
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static int counting_allocations = 0;
+static unsigned long allocation_count = 0;
+
+void *malloc(size_t size) {
+    if (counting_allocations) allocation_count++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    if (counting_allocations) allocation_count++;
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (counting_allocations) allocation_count++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+// ========================================
+// SIGNAL GENERATION
+// ========================================
+
+typedef struct {
+    char name[64];
+    float *samples;      // Interleaved
+    size_t n_frames;
+    uint32_t channels;
+    uint32_t rate;
+} Signal;
+
+// Deterministic PRNG (xorshift32) so golden output is reproducible
+static uint32_t rng_state = 0x12345678u;
+
+static float rand_uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (float)rng_state / 4294967296.0f * 2.0f - 1.0f;
+}
+
+static Signal signal_new(const char *name, uint32_t rate, uint32_t channels, size_t n_frames) {
+    Signal sig;
+    snprintf(sig.name, sizeof(sig.name), "%s", name);
+    sig.rate = rate;
+    sig.channels = channels;
+    sig.n_frames = n_frames;
+    sig.samples = calloc(n_frames * channels, sizeof(float));
+    return sig;
+}
+
+static void signal_set_frame(Signal *sig, size_t f, float value) {
+    for (uint32_t c = 0; c < sig->channels; c++) {
+        sig->samples[f * sig->channels + c] = value;
+    }
+}
+
+static Signal make_silence(uint32_t rate) {
+    return signal_new("silence", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+}
+
+static Signal make_sine(uint32_t rate, double freq, double amplitude) {
+    char name[64];
+    snprintf(name, sizeof(name), "sine_%.0fhz", freq);
+    Signal sig = signal_new(name, rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        signal_set_frame(&sig, f, (float)(amplitude * sin(2.0 * M_PI * freq * f / rate)));
+    }
+    return sig;
+}
+
+// Pink noise via Paul Kellet's refined filter on white noise
+static Signal make_pink_noise(uint32_t rate) {
+    Signal sig = signal_new("pink_noise", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    float b0 = 0, b1 = 0, b2 = 0, b3 = 0, b4 = 0, b5 = 0, b6 = 0;
+    rng_state = 0x12345678u;
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        float white = rand_uniform();
+        b0 = 0.99886f * b0 + white * 0.0555179f;
+        b1 = 0.99332f * b1 + white * 0.0750759f;
+        b2 = 0.96900f * b2 + white * 0.1538520f;
+        b3 = 0.86650f * b3 + white * 0.3104856f;
+        b4 = 0.55000f * b4 + white * 0.5329522f;
+        b5 = -0.7616f * b5 - white * 0.0168980f;
+        float pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f;
+        b6 = white * 0.115926f;
+        signal_set_frame(&sig, f, pink * 0.11f);
+    }
+    return sig;
+}
+
+// Logarithmic sweep 20 Hz -> 20 kHz (clamped below Nyquist)
+static Signal make_sweep(uint32_t rate) {
+    Signal sig = signal_new("log_sweep", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    double f0 = 20.0;
+    double f1 = fmin(20000.0, rate * 0.45);
+    double duration = (double)BENCH_SECONDS;
+    double k = log(f1 / f0);
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        double t = (double)f / rate;
+        double phase = 2.0 * M_PI * f0 * duration / k * (exp(t / duration * k) - 1.0);
+        signal_set_frame(&sig, f, (float)(0.5 * sin(phase)));
+    }
+    return sig;
+}
+
+// 110 Hz square overdriven into hard clipping
+static Signal make_clipped_square(uint32_t rate) {
+    Signal sig = signal_new("clipped_square", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        double s = 4.0 * sin(2.0 * M_PI * 110.0 * f / rate);
+        if (s > 1.0) s = 1.0;
+        if (s < -1.0) s = -1.0;
+        signal_set_frame(&sig, f, (float)s);
+    }
+    return sig;
+}
+
+// Decorrelated white noise in L and R (correlation ~0)
+static Signal make_wide_noise(uint32_t rate) {
+    Signal sig = signal_new("wide_noise", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    rng_state = 0x9e3779b9u;
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        sig.samples[f * BENCH_CHANNELS] = 0.3f * rand_uniform();
+        sig.samples[f * BENCH_CHANNELS + 1] = 0.3f * rand_uniform();
+    }
+    return sig;
+}
+
+// 1 kHz with R = -L (correlation -1, cancels in a mono downmix)
+static Signal make_polarity_flip(uint32_t rate) {
+    Signal sig = signal_new("polarity_flip", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        float v = (float)(0.5 * sin(2.0 * M_PI * 1000.0 * f / rate));
+        sig.samples[f * BENCH_CHANNELS] = v;
+        sig.samples[f * BENCH_CHANNELS + 1] = -v;
+    }
+    return sig;
+}
+
+// C major triad (C4, E4, G4) over a C3 bass, for the key finder
+static Signal make_c_major_triad(uint32_t rate) {
+    static const double notes[] = { 130.81, 261.63, 329.63, 392.00 };
+    Signal sig = signal_new("c_major_triad", rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        double v = 0.0;
+        for (size_t i = 0; i < sizeof(notes) / sizeof(notes[0]); i++) {
+            v += 0.15 * sin(2.0 * M_PI * notes[i] * f / rate);
+        }
+        signal_set_frame(&sig, f, (float)v);
+    }
+    return sig;
+}
+
+// Dense 100 Hz comb up to top_hz with fixed pseudo-random phases, quantized
+// to 16 bits: stands in for a band-limited source (lossy low-pass, CD rate)
+static Signal make_band_limited(uint32_t rate, const char *name, double top_hz) {
+    Signal sig = signal_new(name, rate, BENCH_CHANNELS, (size_t)rate * BENCH_SECONDS);
+    double phases[256];
+    int n_tones = 0;
+    rng_state = 0x2545f491u;
+    for (double f = 100.0; f <= top_hz && n_tones < 256; f += 100.0) {
+        phases[n_tones++] = M_PI * (1.0 + rand_uniform());
+    }
+
+    // The comb repeats every 10 ms; synthesize one period and tile it
+    size_t period = rate % 100 == 0 ? rate / 100 : sig.n_frames;
+    for (size_t f = 0; f < sig.n_frames; f++) {
+        float v;
+        if (f >= period) {
+            v = sig.samples[(f - period) * sig.channels];
+        } else {
+            double acc = 0.0;
+            for (int i = 0; i < n_tones; i++) {
+                acc += 0.008 * sin(2.0 * M_PI * 100.0 * (i + 1) * f / rate + phases[i]);
+            }
+            v = (float)(round(acc * 32768.0) / 32768.0);
+        }
+        signal_set_frame(&sig, f, v);
+    }
+    return sig;
+}
+
+// ========================================
+// WAV LOADING
+// ========================================
+
+static uint32_t read_le(const unsigned char *p, int bytes) {
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+// Load PCM 16/24/32-bit or IEEE float WAV into an interleaved float signal
+static int load_wav(const char *path, Signal *out) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "bench: cannot open %s\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char *data = malloc((size_t)size);
+    if (!data || fread(data, 1, (size_t)size, fp) != (size_t)size) {
+        fclose(fp);
+        free(data);
+        return -1;
+    }
+    fclose(fp);
+
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "bench: %s is not a RIFF/WAVE file\n", path);
+        free(data);
+        return -1;
+    }
+
+    uint32_t format = 0, channels = 0, rate = 0, bits = 0;
+    const unsigned char *pcm = NULL;
+    uint32_t pcm_size = 0;
+
+    long pos = 12;
+    while (pos + 8 <= size) {
+        uint32_t chunk_size = read_le(data + pos + 4, 4);
+        const unsigned char *chunk = data + pos + 8;
+        if (pos + 8 + (long)chunk_size > size) chunk_size = (uint32_t)(size - pos - 8);
+
+        if (memcmp(data + pos, "fmt ", 4) == 0 && chunk_size >= 16) {
+            format = read_le(chunk, 2);
+            channels = read_le(chunk + 2, 2);
+            rate = read_le(chunk + 4, 4);
+            bits = read_le(chunk + 14, 2);
+            if (format == 0xFFFE && chunk_size >= 26) {
+                format = read_le(chunk + 24, 2);  // WAVE_FORMAT_EXTENSIBLE subformat
+            }
+        } else if (memcmp(data + pos, "data", 4) == 0) {
+            pcm = chunk;
+            pcm_size = chunk_size;
+        }
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    int bytes = (int)bits / 8;
+    if (!pcm || channels == 0 || rate == 0 || bytes == 0 ||
+        !((format == 1 && (bits == 16 || bits == 24 || bits == 32)) ||
+          (format == 3 && bits == 32))) {
+        fprintf(stderr, "bench: %s: unsupported WAV (format %u, %u bits)\n", path, format, bits);
+        free(data);
+        return -1;
+    }
+
+    const char *base = strrchr(path, '/');
+    *out = signal_new(base ? base + 1 : path, rate, channels, pcm_size / (bytes * channels));
+
+    size_t n = out->n_frames * channels;
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char *p = pcm + i * bytes;
+        if (format == 3) {
+            float v;
+            memcpy(&v, p, sizeof(v));
+            out->samples[i] = v;
+        } else {
+            int32_t v = (int32_t)(read_le(p, bytes) << (32 - bits));
+            out->samples[i] = (float)v / 2147483648.0f;
+        }
+    }
+
+    free(data);
+    return 0;
+}
+
+// ========================================
+// RUNNER
+// ========================================
+
+typedef struct {
+    uint32_t analysis_rate;
+    int planar;
+} BenchOptions;
+
+typedef struct {
+    double ns_per_frame;
+    unsigned long allocations;
+    double band_mean[VIZ_DSP_BANDS];
+} BenchResult;
+
+static double now_ns(void);
+
+// Loudness meter over the whole signal at one quantum: timing plus final readings
+static void run_loudness(const Signal *sig, size_t quantum) {
+    static LoudnessMeter meter;
+    loudness_init(&meter);
+    loudness_configure(&meter, sig->rate, sig->channels);
+
+    double elapsed = 0.0;
+    size_t processed = 0;
+    allocation_count = 0;
+    for (size_t offset = 0; offset + quantum <= sig->n_frames; offset += quantum) {
+        counting_allocations = 1;
+        double start = now_ns();
+        loudness_process(&meter, sig->samples + offset * sig->channels, quantum, sig->channels);
+        elapsed += now_ns() - start;
+        counting_allocations = 0;
+        processed += quantum;
+    }
+
+    LoudnessReadings r;
+    loudness_get_readings(&meter, &r);
+    printf("%-20s %8zu %12.2f %8lu %8.2f %8.2f %8.2f %8.2f\n", sig->name, quantum,
+           processed ? elapsed / processed : 0.0, allocation_count,
+           r.momentary, r.short_term, r.integrated, r.true_peak);
+}
+
+// Spectrogram over the whole signal: timing plus the loudest row on average
+static void run_spectrogram(const Signal *sig, size_t quantum) {
+    static Spectrogram spec;
+    static double row_sum[SPECTROGRAM_ROWS];
+    spectrogram_init(&spec);
+    spectrogram_configure(&spec, sig->rate, sig->channels);
+    memset(row_sum, 0, sizeof(row_sum));
+
+    double elapsed = 0.0;
+    size_t processed = 0;
+    unsigned long columns = 0;
+    allocation_count = 0;
+    for (size_t offset = 0; offset + quantum <= sig->n_frames; offset += quantum) {
+        counting_allocations = 1;
+        double start = now_ns();
+        spectrogram_process(&spec, sig->samples + offset * sig->channels, quantum, sig->channels);
+        elapsed += now_ns() - start;
+        counting_allocations = 0;
+        processed += quantum;
+
+        for (uint32_t c = 0; c < spec.pending_count; c++) {
+            for (int r = 0; r < SPECTROGRAM_ROWS; r++) row_sum[r] += spec.pending[c][r];
+        }
+        columns += spec.pending_count;
+        spectrogram_clear_pending(&spec);
+    }
+
+    int loudest = 0;
+    for (int r = 1; r < SPECTROGRAM_ROWS; r++) {
+        if (row_sum[r] > row_sum[loudest]) loudest = r;
+    }
+    double bin_hz = (double)sig->rate / spec.plan.n;
+    double level = columns ? row_sum[loudest] / columns : 0.0;
+    printf("%-20s %8zu %12.2f %8lu %8lu %5u-%-6u %8.1f\n", sig->name, quantum,
+           processed ? elapsed / processed : 0.0, allocation_count, columns,
+           (unsigned)(spec.row_first[loudest] * bin_hz), (unsigned)(spec.row_last[loudest] * bin_hz),
+           SPECTROGRAM_FLOOR_DB * (1.0 - level / 255.0));
+}
+
+// Goniometer over the whole signal: timing, final correlation and scope coverage
+static void run_goniometer(const Signal *sig, size_t quantum) {
+    static Goniometer gonio;
+    goniometer_init(&gonio);
+    goniometer_configure(&gonio, sig->rate, sig->channels);
+
+    double elapsed = 0.0;
+    size_t processed = 0;
+    allocation_count = 0;
+    for (size_t offset = 0; offset + quantum <= sig->n_frames; offset += quantum) {
+        counting_allocations = 1;
+        double start = now_ns();
+        goniometer_process(&gonio, sig->samples + offset * sig->channels, quantum, sig->channels);
+        elapsed += now_ns() - start;
+        counting_allocations = 0;
+        processed += quantum;
+    }
+
+    goniometer_render(&gonio);
+    unsigned lit = 0;
+    for (int i = 0; i < GONIOMETER_SIZE * GONIOMETER_SIZE; i++) {
+        if (gonio.image[i] > 0) lit++;
+    }
+    printf("%-20s %8zu %12.2f %8lu %8.3f %7.1f%%\n", sig->name, quantum,
+           processed ? elapsed / processed : 0.0, allocation_count, gonio.correlation,
+           100.0 * lit / (GONIOMETER_SIZE * GONIOMETER_SIZE));
+}
+
+// Renders at display rate into 300 columns; jitter is the mean column
+// change between consecutive renders (0 = the trace stands still)
+static void run_oscilloscope(const Signal *sig, size_t quantum) {
+    static Oscilloscope scope;
+    static float prev_max[OSCILLOSCOPE_MAX_COLUMNS];
+    const uint32_t columns = 300;
+    oscilloscope_init(&scope);
+    oscilloscope_configure(&scope, sig->rate, sig->channels);
+
+    double elapsed = 0.0;
+    size_t processed = 0;
+    size_t since_render = 0;
+    unsigned renders = 0, triggered = 0, compared = 0;
+    double jitter = 0.0;
+    allocation_count = 0;
+    for (size_t offset = 0; offset + quantum <= sig->n_frames; offset += quantum) {
+        counting_allocations = 1;
+        double start = now_ns();
+        oscilloscope_process(&scope, sig->samples + offset * sig->channels, quantum, sig->channels);
+        elapsed += now_ns() - start;
+        counting_allocations = 0;
+        processed += quantum;
+
+        since_render += quantum;
+        if (since_render < sig->rate / 60) continue;
+        since_render = 0;
+
+        counting_allocations = 1;
+        oscilloscope_render(&scope, columns);
+        counting_allocations = 0;
+
+        if (renders > 0) {
+            double diff = 0.0;
+            for (uint32_t c = 0; c < columns; c++) diff += fabsf(scope.col_max[c] - prev_max[c]);
+            jitter += diff / columns;
+            compared++;
+        }
+        memcpy(prev_max, scope.col_max, columns * sizeof(float));
+        renders++;
+        triggered += scope.triggered ? 1 : 0;
+    }
+
+    printf("%-20s %8zu %12.2f %8lu %7.1f%% %8.4f\n", sig->name, quantum,
+           processed ? elapsed / processed : 0.0, allocation_count,
+           renders ? 100.0 * triggered / renders : 0.0, compared ? jitter / compared : 0.0);
+}
+
+// Strongest pitch class and estimated key at the end of the signal
+static void run_chroma(const Signal *sig, size_t quantum) {
+    static Chroma chroma;
+    chroma_init(&chroma);
+    chroma_configure(&chroma, sig->rate, sig->channels);
+
+    double elapsed = 0.0;
+    size_t processed = 0;
+    allocation_count = 0;
+    for (size_t offset = 0; offset + quantum <= sig->n_frames; offset += quantum) {
+        counting_allocations = 1;
+        double start = now_ns();
+        chroma_process(&chroma, sig->samples + offset * sig->channels, quantum, sig->channels);
+        elapsed += now_ns() - start;
+        counting_allocations = 0;
+        processed += quantum;
+    }
+
+    int strongest = 0;
+    for (int c = 1; c < CHROMA_CLASSES; c++) {
+        if (chroma.chroma[c] > chroma.chroma[strongest]) strongest = c;
+    }
+    printf("%-20s %8zu %12.2f %8lu %8u %6s %-9s %6.2f\n", sig->name, quantum,
+           processed ? elapsed / processed : 0.0, allocation_count, chroma.kernel_entries,
+           chroma.chroma[strongest] > 0.0f ? chroma_class_name(strongest) : "-",
+           chroma.key >= 0 ? chroma_key_name(chroma.key) : "-", chroma.key_confidence);
+}
+
+static void run_authenticity(const Signal *sig, size_t quantum) {
+    static const char *verdicts[] = {
+        [AUTHENTICITY_UNKNOWN] = "unknown",
+        [AUTHENTICITY_CLEAN] = "clean",
+        [AUTHENTICITY_HIRES] = "hi-res",
+        [AUTHENTICITY_UPSAMPLED] = "upsampled",
+        [AUTHENTICITY_LOSSY] = "lossy",
+    };
+    static Authenticity auth;
+    authenticity_init(&auth);
+    authenticity_configure(&auth, sig->rate, sig->channels);
+
+    // Loop the signal: a verdict needs more audio than one pass holds
+    const int passes = (int)ceil(AUTHENTICITY_MIN_SECONDS * 1.5 / BENCH_SECONDS);
+    double elapsed = 0.0;
+    size_t processed = 0;
+    allocation_count = 0;
+    for (int pass = 0; pass < passes; pass++) {
+        for (size_t offset = 0; offset < sig->n_frames; offset += quantum) {
+            size_t n = sig->n_frames - offset < quantum ? sig->n_frames - offset : quantum;
+            counting_allocations = 1;
+            double start = now_ns();
+            authenticity_process(&auth, sig->samples + offset * sig->channels, n, sig->channels);
+            elapsed += now_ns() - start;
+            counting_allocations = 0;
+            processed += n;
+        }
+    }
+
+    AuthenticityReport report;
+    authenticity_get_report(&auth, &report);
+    printf("%-20s %8zu %12.2f %8lu %10s %8.0f %5d\n", sig->name, quantum,
+           processed ? elapsed / processed : 0.0, allocation_count,
+           verdicts[report.verdict], report.cutoff_hz, report.bits);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static BenchResult run_signal(const Signal *sig, size_t quantum, const BenchOptions *opts) {
+    BenchResult result;
+    memset(&result, 0, sizeof(result));
+
+    static VizDsp dsp;
+    viz_dsp_init(&dsp);
+    viz_dsp_configure(&dsp, sig->rate, sig->channels, opts->analysis_rate);
+
+    // De-interleaved copy for planar runs (prepared outside the timed region)
+    float *planar = NULL;
+    if (opts->planar) {
+        planar = malloc(sig->n_frames * sig->channels * sizeof(float));
+        for (size_t f = 0; f < sig->n_frames; f++) {
+            for (uint32_t c = 0; c < sig->channels; c++) {
+                planar[c * sig->n_frames + f] = sig->samples[f * sig->channels + c];
+            }
+        }
+    }
+
+    size_t n_blocks = 0;
+    double elapsed = 0.0;
+
+    allocation_count = 0;
+    for (size_t offset = 0; offset + quantum <= sig->n_frames; offset += quantum) {
+        counting_allocations = 1;
+        double start = now_ns();
+        if (planar) {
+            const float *planes[VIZ_DSP_MAX_CHANNELS];
+            for (uint32_t c = 0; c < sig->channels && c < VIZ_DSP_MAX_CHANNELS; c++) {
+                planes[c] = planar + c * sig->n_frames + offset;
+            }
+            viz_dsp_process_planar(&dsp, planes, quantum);
+        } else {
+            viz_dsp_process_interleaved(&dsp, sig->samples + offset * sig->channels, quantum);
+        }
+        elapsed += now_ns() - start;
+        counting_allocations = 0;
+
+        for (int b = 0; b < VIZ_DSP_BANDS; b++) {
+            result.band_mean[b] += dsp.bars[b];
+        }
+        n_blocks++;
+    }
+
+    result.allocations = allocation_count;
+    if (n_blocks > 0) {
+        result.ns_per_frame = elapsed / (double)(n_blocks * quantum);
+        for (int b = 0; b < VIZ_DSP_BANDS; b++) {
+            result.band_mean[b] /= (double)n_blocks;
+        }
+    }
+
+    free(planar);
+    return result;
+}
+
+// Golden line: "<signal> q<quantum> <band0> ... <bandN>"
+static void format_golden_line(char *buf, size_t size, const char *name, size_t quantum,
+                               const BenchResult *result) {
+    int n = snprintf(buf, size, "%s q%zu", name, quantum);
+    for (int b = 0; b < VIZ_DSP_BANDS && n < (int)size; b++) {
+        n += snprintf(buf + n, size - n, " %.6f", result->band_mean[b]);
+    }
+}
+
+// Compare a generated line with the matching golden line; returns 0 on match
+static int compare_golden_line(FILE *golden, const char *line) {
+    char expected[4096];
+    if (!golden || !fgets(expected, sizeof(expected), golden)) {
+        return -1;
+    }
+
+    char name_a[128], name_b[128];
+    size_t q_a, q_b;
+    int off_a = 0, off_b = 0;
+    if (sscanf(line, "%127s q%zu%n", name_a, &q_a, &off_a) != 2 ||
+        sscanf(expected, "%127s q%zu%n", name_b, &q_b, &off_b) != 2 ||
+        strcmp(name_a, name_b) != 0 || q_a != q_b) {
+        return -1;
+    }
+
+    const char *pa = line + off_a;
+    const char *pb = expected + off_b;
+    for (int b = 0; b < VIZ_DSP_BANDS; b++) {
+        char *end_a, *end_b;
+        double va = strtod(pa, &end_a);
+        double vb = strtod(pb, &end_b);
+        if (end_a == pa || end_b == pb || fabs(va - vb) > GOLDEN_TOLERANCE) {
+            return -1;
+        }
+        pa = end_a;
+        pb = end_b;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opts = { .analysis_rate = 12000, .planar = 0 };
+    uint32_t rate = 48000;
+    size_t quanta[MAX_QUANTA];
+    int n_quanta = 0;
+    const char *wavs[MAX_WAVS];
+    int n_wavs = 0;
+    const char *golden_path = NULL;
+    int write_golden = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--analysis-rate") == 0 && i + 1 < argc) {
+            opts.analysis_rate = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--planar") == 0) {
+            opts.planar = 1;
+        } else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc && n_quanta < MAX_QUANTA) {
+            quanta[n_quanta++] = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc && n_wavs < MAX_WAVS) {
+            wavs[n_wavs++] = argv[++i];
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            golden_path = argv[++i];
+        } else if (strcmp(argv[i], "--write-golden") == 0 && i + 1 < argc) {
+            golden_path = argv[++i];
+            write_golden = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--rate HZ] [--analysis-rate HZ] [--planar] "
+                            "[--quantum N]... [--wav FILE]... "
+                            "[--golden FILE | --write-golden FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (n_quanta == 0) {
+        const size_t defaults[] = { 64, 256, 1024, 4096 };
+        for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+            quanta[n_quanta++] = defaults[i];
+        }
+    }
+
+    Signal signals[MAX_SYNTHETIC + MAX_WAVS];
+    int n_signals = 0;
+    signals[n_signals++] = make_silence(rate);
+    signals[n_signals++] = make_sine(rate, 100.0, 0.5);
+    signals[n_signals++] = make_sine(rate, 1000.0, 0.5);
+    signals[n_signals++] = make_sine(rate, 5000.0, 0.5);
+    signals[n_signals++] = make_pink_noise(rate);
+    signals[n_signals++] = make_sweep(rate);
+    signals[n_signals++] = make_clipped_square(rate);
+    signals[n_signals++] = make_wide_noise(rate);
+    signals[n_signals++] = make_polarity_flip(rate);
+    signals[n_signals++] = make_c_major_triad(rate);
+    signals[n_signals++] = make_band_limited(rate, "lossy_16k", 16000.0);
+    signals[n_signals++] = make_band_limited(rate, "cd_band_20k", fmin(20000.0, rate * 0.45));
+    const int n_synthetic = n_signals;
+    for (int i = 0; i < n_wavs; i++) {
+        if (load_wav(wavs[i], &signals[n_signals]) == 0) {
+            n_signals++;
+        }
+    }
+
+    FILE *golden = NULL;
+    if (golden_path) {
+        golden = fopen(golden_path, write_golden ? "w" : "r");
+        if (!golden) {
+            fprintf(stderr, "bench: cannot open golden file %s\n", golden_path);
+            return 2;
+        }
+    }
+
+    printf("Visualizer DSP bench: %u Hz in, analysis %u Hz, %s\n",
+           rate, opts.analysis_rate, opts.planar ? "planar" : "interleaved");
+    printf("%-20s %8s %12s %8s %8s\n", "signal", "quantum", "ns/frame", "allocs", "golden");
+
+    int failures = 0;
+    for (int s = 0; s < n_signals; s++) {
+        for (int q = 0; q < n_quanta; q++) {
+            BenchResult result = run_signal(&signals[s], quanta[q], &opts);
+
+            char line[4096];
+            format_golden_line(line, sizeof(line), signals[s].name, quanta[q], &result);
+
+            // WAV files are user input, never part of the golden set
+            const char *status = "-";
+            if (golden && s < n_synthetic) {
+                if (write_golden) {
+                    fprintf(golden, "%s\n", line);
+                    status = "written";
+                } else if (compare_golden_line(golden, line) == 0) {
+                    status = "ok";
+                } else {
+                    status = "FAIL";
+                    failures++;
+                }
+            }
+
+            if (result.allocations > 0) failures++;
+
+            printf("%-20s %8zu %12.2f %8lu %8s\n", signals[s].name, quanta[q],
+                   result.ns_per_frame, result.allocations, status);
+        }
+    }
+
+    // Per-band output for the largest quantum, for eyeballing and diffing
+    printf("\nPer-band mean output (quantum %zu):\n", quanta[n_quanta - 1]);
+    for (int s = 0; s < n_signals; s++) {
+        BenchResult result = run_signal(&signals[s], quanta[n_quanta - 1], &opts);
+        printf("%-20s", signals[s].name);
+        for (int b = 0; b < VIZ_DSP_BANDS; b++) {
+            printf(" %.2f", result.band_mean[b]);
+        }
+        printf("\n");
+    }
+
+    // Loudness meter (native rate, all channels)
+    printf("\nLoudness meter (quantum %zu):\n", quanta[n_quanta - 1]);
+    printf("%-20s %8s %12s %8s %8s %8s %8s %8s\n", "signal", "quantum", "ns/frame", "allocs",
+           "M LUFS", "S LUFS", "I LUFS", "TP dBTP");
+    for (int s = 0; s < n_signals; s++) {
+        run_loudness(&signals[s], quanta[n_quanta - 1]);
+    }
+
+    // Spectrogram columns (native rate, mono downmix)
+    printf("\nSpectrogram (quantum %zu):\n", quanta[n_quanta - 1]);
+    printf("%-20s %8s %12s %8s %8s %12s %8s\n", "signal", "quantum", "ns/frame", "allocs",
+           "columns", "loudest Hz", "dBFS");
+    for (int s = 0; s < n_signals; s++) {
+        run_spectrogram(&signals[s], quanta[n_quanta - 1]);
+    }
+
+    // Goniometer / correlation (channels 0 and 1)
+    printf("\nGoniometer (quantum %zu):\n", quanta[n_quanta - 1]);
+    printf("%-20s %8s %12s %8s %8s %8s\n", "signal", "quantum", "ns/frame", "allocs",
+           "corr", "lit");
+    for (int s = 0; s < n_signals; s++) {
+        run_goniometer(&signals[s], quanta[n_quanta - 1]);
+    }
+
+    // Chroma / key
+    printf("\nChroma (quantum %zu):\n", quanta[n_quanta - 1]);
+    printf("%-20s %8s %12s %8s %8s %6s %-9s %6s\n", "signal", "quantum", "ns/frame", "allocs",
+           "kernel", "class", "key", "conf");
+    for (int s = 0; s < n_signals; s++) {
+        run_chroma(&signals[s], quanta[n_quanta - 1]);
+    }
+
+    // Hi-res authenticity (cutoff in Hz, bits in use)
+    printf("\nAuthenticity (quantum %zu):\n", quanta[n_quanta - 1]);
+    printf("%-20s %8s %12s %8s %10s %8s %5s\n", "signal", "quantum", "ns/frame", "allocs",
+           "verdict", "cutoff", "bits");
+    for (int s = 0; s < n_signals; s++) {
+        run_authenticity(&signals[s], quanta[n_quanta - 1]);
+    }
+
+    // Oscilloscope trigger stability at display rate
+    printf("\nOscilloscope (quantum %zu):\n", quanta[n_quanta - 1]);
+    printf("%-20s %8s %12s %8s %8s %8s\n", "signal", "quantum", "ns/frame", "allocs",
+           "trig", "jitter");
+    for (int s = 0; s < n_signals; s++) {
+        run_oscilloscope(&signals[s], quanta[n_quanta - 1]);
+    }
+
+    if (golden) fclose(golden);
+    for (int s = 0; s < n_signals; s++) free(signals[s].samples);
+
+    if (failures > 0) {
+        printf("\n%d check(s) failed (golden mismatch or allocation on the processing path)\n",
+               failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include "chroma.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define LOWPASS_HZ 2500.0               // Above B6 (1976 Hz), well below the decimated Nyquist
+#define KERNEL_THRESHOLD 0.01           // Drop spectral kernel entries below this fraction of the peak
+#define ENERGY_FLOOR 1e-6f              // Display reference for quiet input (about -60 dBFS)
+#define KEY_GATE 1e-7f                  // Hops quieter than this do not teach the key finder
+
+// Krumhansl-Kessler probe-tone profiles, tonic first
+static const float major_profile[CHROMA_CLASSES] = {
+    6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f
+};
+static const float minor_profile[CHROMA_CLASSES] = {
+    6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f
+};
+
+static const char *class_names[CHROMA_CLASSES] = {
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+static const char *key_names[2 * CHROMA_CLASSES] = {
+    "C major", "C# major", "D major", "D# major", "E major", "F major",
+    "F# major", "G major", "G# major", "A major", "A# major", "B major",
+    "C minor", "C# minor", "D minor", "D# minor", "E minor", "F minor",
+    "F# minor", "G minor", "G# minor", "A minor", "A# minor", "B minor"
+};
+
+// RBJ low-pass section
+static void lowpass_design(ChromaBiquad *bq, double fc, double q, double rate) {
+    double w0 = 2.0 * M_PI * fc / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double cosw = cos(w0);
+    double a0 = 1.0 + alpha;
+
+    bq->b0 = (float)((1.0 - cosw) / 2.0 / a0);
+    bq->b1 = (float)((1.0 - cosw) / a0);
+    bq->b2 = bq->b0;
+    bq->a1 = (float)(-2.0 * cosw / a0);
+    bq->a2 = (float)((1.0 - alpha) / a0);
+    bq->z1 = bq->z2 = 0.0f;
+}
+
+static inline float biquad_run(ChromaBiquad *bq, float x) {
+    float y = bq->b0 * x + bq->z1;
+    bq->z1 = bq->b1 * x - bq->a1 * y + bq->z2;
+    bq->z2 = bq->b2 * x - bq->a2 * y;
+    return y;
+}
+
+// Spectral kernel of each CQ bin: FFT of a Hann-windowed complex exponential
+// aligned to the newest end of the frame, conjugated and pre-scaled so the
+// dot product with the frame's FFT yields the sine amplitude directly
+static void build_kernels(Chroma *chroma, double rate) {
+    const uint32_t n = chroma->plan.n;
+    const double q = 1.0 / (pow(2.0, 1.0 / 12.0) - 1.0);
+
+    chroma->kernel_entries = 0;
+    for (int k = 0; k < CHROMA_BINS; k++) {
+        double freq = CHROMA_MIN_HZ * pow(2.0, k / 12.0);
+        uint32_t len = (uint32_t)ceil(q * rate / freq);
+        if (len > n) len = n;
+
+        memset(chroma->re, 0, n * sizeof(float));
+        memset(chroma->im, 0, n * sizeof(float));
+        for (uint32_t i = 0; i < len; i++) {
+            double w = (0.5 - 0.5 * cos(2.0 * M_PI * (i + 0.5) / len)) / len;
+            double phase = 2.0 * M_PI * freq * i / rate;
+            chroma->re[n - len + i] = (float)(w * cos(phase));
+            chroma->im[n - len + i] = (float)(w * sin(phase));
+        }
+        fft_forward(&chroma->plan, chroma->re, chroma->im);
+
+        float peak = 0.0f;
+        for (uint32_t j = 0; j <= n / 2; j++) {
+            float mag = hypotf(chroma->re[j], chroma->im[j]);
+            if (mag > peak) peak = mag;
+        }
+
+        // 1/n from Parseval, 4 undoes the Hann mean (0.5) and the one-sided sine (0.5)
+        const float scale = 4.0f / n;
+        chroma->kernel_first[k] = (uint16_t)chroma->kernel_entries;
+        for (uint32_t j = 0; j <= n / 2 && chroma->kernel_entries < CHROMA_KERNEL_MAX; j++) {
+            if (hypotf(chroma->re[j], chroma->im[j]) < peak * KERNEL_THRESHOLD) continue;
+            uint32_t e = chroma->kernel_entries++;
+            chroma->kernel_bin[e] = (uint16_t)j;
+            chroma->kernel_re[e] = chroma->re[j] * scale;
+            chroma->kernel_im[e] = -chroma->im[j] * scale;
+        }
+        chroma->kernel_count[k] = (uint16_t)(chroma->kernel_entries - chroma->kernel_first[k]);
+    }
+}
+
+void chroma_init(Chroma *chroma) {
+    memset(chroma, 0, sizeof(*chroma));
+    chroma->key = -1;
+}
+
+void chroma_configure(Chroma *chroma, uint32_t rate, uint32_t channels) {
+    chroma->rate = rate;
+    chroma->channels = channels;
+    if (rate == 0 || channels == 0) {
+        chroma->rate = 0;
+        return;
+    }
+
+    chroma->decimation = rate / CHROMA_TARGET_RATE;
+    if (chroma->decimation < 1) chroma->decimation = 1;
+    double analysis_rate = (double)rate / chroma->decimation;
+
+    double fc = LOWPASS_HZ;
+    if (fc > 0.4 * analysis_rate) fc = 0.4 * analysis_rate;
+    lowpass_design(&chroma->lowpass[0], fc, 0.54119610, rate);
+    lowpass_design(&chroma->lowpass[1], fc, 1.30656296, rate);
+
+    // Long enough for the lowest bin's window
+    double q = 1.0 / (pow(2.0, 1.0 / 12.0) - 1.0);
+    uint32_t longest = (uint32_t)ceil(q * analysis_rate / CHROMA_MIN_HZ);
+    uint32_t n = fft_floor_pow2(longest);
+    if (n < longest && n < FFT_MAX_SIZE) n *= 2;
+    fft_plan(&chroma->plan, n);
+
+    chroma->hop = (uint32_t)(analysis_rate * CHROMA_HOP_MS / 1000.0);
+    if (chroma->hop == 0) chroma->hop = 1;
+    double dt = chroma->hop / analysis_rate;
+    chroma->smooth_coef = (float)exp(-dt / (CHROMA_SMOOTH_MS / 1000.0));
+    chroma->key_coef = (float)exp(-dt / (CHROMA_KEY_MS / 1000.0));
+
+    build_kernels(chroma, analysis_rate);
+    chroma_reset(chroma);
+}
+
+void chroma_reset(Chroma *chroma) {
+    for (int i = 0; i < 2; i++) {
+        chroma->lowpass[i].z1 = chroma->lowpass[i].z2 = 0.0f;
+    }
+    memset(chroma->history, 0, sizeof(chroma->history));
+    memset(chroma->energy, 0, sizeof(chroma->energy));
+    memset(chroma->profile, 0, sizeof(chroma->profile));
+    memset(chroma->chroma, 0, sizeof(chroma->chroma));
+    chroma->history_pos = 0;
+    chroma->hop_pos = 0;
+    chroma->decimate_pos = 0;
+    chroma->key = -1;
+    chroma->key_confidence = 0.0f;
+}
+
+// Pearson correlation of the long-term profile against all 24 rotations
+static void estimate_key(Chroma *chroma) {
+    float mean = 0.0f;
+    for (int c = 0; c < CHROMA_CLASSES; c++) mean += chroma->profile[c];
+    mean /= CHROMA_CLASSES;
+
+    float best = -2.0f;
+    int best_key = -1;
+    for (int mode = 0; mode < 2; mode++) {
+        const float *ref = mode ? minor_profile : major_profile;
+        float ref_mean = 0.0f;
+        for (int c = 0; c < CHROMA_CLASSES; c++) ref_mean += ref[c];
+        ref_mean /= CHROMA_CLASSES;
+
+        for (int tonic = 0; tonic < CHROMA_CLASSES; tonic++) {
+            float num = 0.0f, var_p = 0.0f, var_r = 0.0f;
+            for (int c = 0; c < CHROMA_CLASSES; c++) {
+                float p = chroma->profile[c] - mean;
+                float r = ref[(c - tonic + CHROMA_CLASSES) % CHROMA_CLASSES] - ref_mean;
+                num += p * r;
+                var_p += p * p;
+                var_r += r * r;
+            }
+            float denom = sqrtf(var_p * var_r);
+            float corr = denom > 0.0f ? num / denom : 0.0f;
+            if (corr > best) {
+                best = corr;
+                best_key = mode * CHROMA_CLASSES + tonic;
+            }
+        }
+    }
+
+    chroma->key = best_key;
+    chroma->key_confidence = best;
+}
+
+// FFT the latest frame, apply the sparse kernels and fold into pitch classes
+static void analyze(Chroma *chroma) {
+    const uint32_t n = chroma->plan.n;
+    const uint32_t mask = n - 1;
+
+    for (uint32_t i = 0; i < n; i++) {
+        chroma->re[i] = chroma->history[(chroma->history_pos + i) & mask];
+    }
+    fft_forward_real(&chroma->plan, chroma->re, chroma->im);
+
+    float frame[CHROMA_CLASSES] = { 0 };
+    float total = 0.0f;
+    for (int k = 0; k < CHROMA_BINS; k++) {
+        float acc_re = 0.0f, acc_im = 0.0f;
+        uint32_t end = chroma->kernel_first[k] + chroma->kernel_count[k];
+        for (uint32_t e = chroma->kernel_first[k]; e < end; e++) {
+            uint32_t j = chroma->kernel_bin[e];
+            acc_re += chroma->re[j] * chroma->kernel_re[e] - chroma->im[j] * chroma->kernel_im[e];
+            acc_im += chroma->re[j] * chroma->kernel_im[e] + chroma->im[j] * chroma->kernel_re[e];
+        }
+        float power = acc_re * acc_re + acc_im * acc_im;
+        frame[k % CHROMA_CLASSES] += power;
+        total += power;
+    }
+
+    float peak = 0.0f;
+    const float a = chroma->smooth_coef;
+    for (int c = 0; c < CHROMA_CLASSES; c++) {
+        chroma->energy[c] = a * chroma->energy[c] + (1.0f - a) * frame[c];
+        if (chroma->energy[c] > peak) peak = chroma->energy[c];
+    }
+
+    const float ref = peak > ENERGY_FLOOR ? peak : ENERGY_FLOOR;
+    for (int c = 0; c < CHROMA_CLASSES; c++) {
+        chroma->chroma[c] = sqrtf(chroma->energy[c] / ref);
+    }
+
+    // Every audible hop counts the same for the key, however loud
+    if (total > KEY_GATE) {
+        const float b = chroma->key_coef;
+        for (int c = 0; c < CHROMA_CLASSES; c++) {
+            chroma->profile[c] = b * chroma->profile[c] + (1.0f - b) * frame[c] / total;
+        }
+        estimate_key(chroma);
+    }
+
+    chroma->updates++;
+}
+
+void chroma_process(Chroma *chroma, const float *samples, size_t n_frames, uint32_t stride) {
+    if (chroma->rate == 0 || chroma->plan.n == 0) return;
+
+    const uint32_t channels = chroma->channels;
+    const uint32_t mask = chroma->plan.n - 1;
+    const float scale = 1.0f / (float)channels;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * stride;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; c++) {
+            sum += frame[c];
+        }
+        float x = biquad_run(&chroma->lowpass[1], biquad_run(&chroma->lowpass[0], sum * scale));
+
+        if (++chroma->decimate_pos < chroma->decimation) continue;
+        chroma->decimate_pos = 0;
+
+        chroma->history[chroma->history_pos] = x;
+        chroma->history_pos = (chroma->history_pos + 1) & mask;
+
+        if (++chroma->hop_pos >= chroma->hop) {
+            chroma->hop_pos = 0;
+            analyze(chroma);
+        }
+    }
+}
+
+const char *chroma_class_name(int pitch_class) {
+    if (pitch_class < 0 || pitch_class >= CHROMA_CLASSES) return "";
+    return class_names[pitch_class];
+}
+
+const char *chroma_key_name(int key) {
+    if (key < 0 || key >= 2 * CHROMA_CLASSES) return "";
+    return key_names[key];
+}
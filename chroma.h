@@ -0,0 +1,92 @@
+#ifndef CHROMA_H
+#define CHROMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fft.h"
+
+/**
+ * Chroma / Key Analysis
+ *
+ * Constant-Q transform with one bin per semitone from C2 to B6 (A4 = 440 Hz),
+ * computed the Brown-Puckette way: the input is low-passed and decimated to
+ * ~11 kHz, every CHROMA_HOP_MS one FFT is taken and each CQ bin is the dot
+ * product of that spectrum with a precomputed sparse spectral kernel.
+ * Bins are folded into 12 pitch classes (C = 0) and the key is estimated by
+ * correlating a long-term chroma average with the Krumhansl-Kessler major
+ * and minor profiles.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define CHROMA_CLASSES 12
+#define CHROMA_OCTAVES 5
+#define CHROMA_BINS (CHROMA_CLASSES * CHROMA_OCTAVES)
+#define CHROMA_MIN_HZ 65.406           // C2
+#define CHROMA_TARGET_RATE 11025       // Decimated analysis rate (at least)
+#define CHROMA_HOP_MS 50
+#define CHROMA_SMOOTH_MS 150.0         // Displayed chroma
+#define CHROMA_KEY_MS 8000.0           // Key-finding memory
+#define CHROMA_KERNEL_MAX 8192         // Sparse kernel entries across all bins
+
+typedef struct {
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+} ChromaBiquad;
+
+typedef struct {
+    uint32_t rate;                     // 0 until configured
+    uint32_t channels;
+
+    // Anti-alias low-pass (4th-order Butterworth) and decimation
+    ChromaBiquad lowpass[2];
+    uint32_t decimation;
+    uint32_t decimate_pos;
+
+    FftPlan plan;
+    float history[FFT_MAX_SIZE];       // Circular decimated mono input
+    uint32_t history_pos;
+    float re[FFT_MAX_SIZE];
+    float im[FFT_MAX_SIZE];
+    uint32_t hop;                      // Decimated frames per analysis
+    uint32_t hop_pos;
+
+    // Sparse spectral kernels: entries [kernel_first[k], +kernel_count[k])
+    uint16_t kernel_first[CHROMA_BINS];
+    uint16_t kernel_count[CHROMA_BINS];
+    uint16_t kernel_bin[CHROMA_KERNEL_MAX];
+    float kernel_re[CHROMA_KERNEL_MAX];
+    float kernel_im[CHROMA_KERNEL_MAX];
+    uint32_t kernel_entries;
+
+    float smooth_coef;                 // Per hop
+    float key_coef;
+    float energy[CHROMA_CLASSES];      // Smoothed pitch-class energy
+    float profile[CHROMA_CLASSES];     // Long-term normalized chroma for key finding
+
+    // Outputs, refreshed every hop
+    float chroma[CHROMA_CLASSES];      // 0..1, loudest class = 1
+    int key;                           // 0-11 = C..B major, 12-23 = C..B minor, -1 = unknown
+    float key_confidence;              // Profile correlation of the chosen key
+    uint32_t updates;                  // Incremented per hop
+} Chroma;
+
+// Zero all state; the analyzer ignores input until chroma_configure()
+void chroma_init(Chroma *chroma);
+
+// Apply a negotiated format: plans the decimator, FFT and sparse kernels
+void chroma_configure(Chroma *chroma, uint32_t rate, uint32_t channels);
+
+// Clear history, chroma and key memory (format is kept)
+void chroma_reset(Chroma *chroma);
+
+// Feed interleaved F32 frames with `stride` floats per frame (>= channels)
+void chroma_process(Chroma *chroma, const float *samples, size_t n_frames, uint32_t stride);
+
+// "C", "C#", ... for a pitch class
+const char *chroma_class_name(int pitch_class);
+
+// "A minor" etc., or "" for an unknown key
+const char *chroma_key_name(int key);
+
+#endif // CHROMA_H
@@ -0,0 +1,373 @@
+#include "dot_matrix.h"
+#include <pango/pangocairo.h>
+#include <math.h>
+
+#define LINE_HEIGHT 1.2           // Row pitch relative to the font's line height
+#define ATLAS_WIDTH 256           // Logical px; cells are packed in shelves
+#define ATLAS_PADDING 2           // Keeps texture filtering from bleeding between cells
+#define ATLAS_MAX_CELLS 256       // Evict cells no longer shown past this many
+
+typedef struct {
+    gdouble x;                    // Logical px in the atlas
+    gdouble y;
+    gdouble width;
+    gdouble height;
+} GlyphCell;
+
+struct _DotMatrix {
+    GtkWidget parent_instance;
+
+    guint rows;
+    GPtrArray *lines;             // Cells shown, one string per row
+    gboolean column;              // Scrolling a column rather than centered text
+    gint first_line;
+
+    // Glyph atlas
+    GHashTable *cells;            // Cell text → GlyphCell (NULL until rasterized)
+    GdkTexture *atlas;
+    gdouble atlas_width;          // Logical size of the atlas
+    gdouble atlas_height;
+    gint atlas_scale;             // Scale factor it was rasterized at
+    gboolean atlas_dirty;         // Cells waiting to be rasterized
+    PangoFontDescription *font;   // Font the cells were rasterized with
+
+    gdouble pitch;                // Row height, 0 until measured
+    gdouble cell_width;           // Width of a digit
+};
+
+G_DEFINE_FINAL_TYPE(DotMatrix, dot_matrix, GTK_TYPE_WIDGET)
+
+// ========================================
+// GLYPH ATLAS
+// ========================================
+
+// Drop every rasterized cell (font changed); they are redone on the next draw
+static void invalidate_atlas(DotMatrix *self) {
+    GHashTableIter iter;
+    g_hash_table_iter_init(&iter, self->cells);
+    while (g_hash_table_iter_next(&iter, NULL, NULL)) {
+        g_hash_table_iter_replace(&iter, NULL);
+    }
+
+    g_clear_object(&self->atlas);
+    self->atlas_dirty = g_hash_table_size(self->cells) > 0;
+    self->pitch = 0;
+    gtk_widget_queue_resize(GTK_WIDGET(self));
+}
+
+// Re-rasterize only when the CSS font actually changed, not on every state change
+static void check_font(DotMatrix *self) {
+    PangoContext *context = gtk_widget_get_pango_context(GTK_WIDGET(self));
+    const PangoFontDescription *font = pango_context_get_font_description(context);
+
+    if (self->font && font && pango_font_description_equal(self->font, font)) return;
+
+    g_clear_pointer(&self->font, pango_font_description_free);
+    if (font) {
+        self->font = pango_font_description_copy(font);
+    }
+    invalidate_atlas(self);
+}
+
+static void update_metrics(DotMatrix *self) {
+    if (self->pitch > 0) return;
+
+    PangoLayout *layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), "0");
+    PangoRectangle logical;
+    pango_layout_get_pixel_extents(layout, NULL, &logical);
+    g_object_unref(layout);
+
+    self->pitch = ceil(MAX(logical.height, 1) * LINE_HEIGHT);
+    self->cell_width = MAX(logical.width, 1);
+}
+
+// Queue cells of the current lines that have not been rasterized
+static void want_cells(DotMatrix *self) {
+    for (guint i = 0; i < self->lines->len; i++) {
+        const gchar *line = g_ptr_array_index(self->lines, i);
+        if (*line == '\0' || g_hash_table_contains(self->cells, line)) continue;
+
+        g_hash_table_insert(self->cells, g_strdup(line), NULL);
+        self->atlas_dirty = TRUE;
+    }
+}
+
+// Drop cells the given lines do not show; the rest are repacked on the next draw
+static void evict_cells(DotMatrix *self, GPtrArray *shown) {
+    GHashTable *keep = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < shown->len; i++) {
+        g_hash_table_add(keep, g_ptr_array_index(shown, i));
+    }
+
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, self->cells);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (g_hash_table_contains(keep, key)) {
+            g_hash_table_iter_replace(&iter, NULL);
+        } else {
+            g_hash_table_iter_remove(&iter);
+        }
+    }
+    g_hash_table_destroy(keep);
+
+    // Same font, so the pitch still holds; only the packing changes
+    g_clear_object(&self->atlas);
+    self->atlas_dirty = g_hash_table_size(self->cells) > 0;
+}
+
+typedef struct {
+    PangoLayout *layout;
+    PangoRectangle logical;
+    GlyphCell *cell;
+} PendingGlyph;
+
+// Rasterize every known cell, white on transparent, into one texture
+static void build_atlas(DotMatrix *self) {
+    GtkWidget *widget = GTK_WIDGET(self);
+
+    self->atlas_dirty = FALSE;
+    g_clear_object(&self->atlas);
+    if (g_hash_table_size(self->cells) == 0) return;
+
+    // Pack in shelves, measured with the widget's CSS font
+    GArray *glyphs = g_array_new(FALSE, FALSE, sizeof(PendingGlyph));
+    gdouble x = 0, y = 0, shelf = 0;
+
+    GHashTableIter iter;
+    gpointer key;
+    g_hash_table_iter_init(&iter, self->cells);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        PendingGlyph glyph;
+        glyph.layout = gtk_widget_create_pango_layout(widget, key);
+        pango_layout_get_pixel_extents(glyph.layout, NULL, &glyph.logical);
+
+        glyph.cell = g_new0(GlyphCell, 1);
+        glyph.cell->width = MAX(glyph.logical.width, 1);
+        glyph.cell->height = MAX(glyph.logical.height, 1);
+        if (x > 0 && x + glyph.cell->width > ATLAS_WIDTH) {
+            x = 0;
+            y += shelf + ATLAS_PADDING;
+            shelf = 0;
+        }
+        glyph.cell->x = x;
+        glyph.cell->y = y;
+        x += glyph.cell->width + ATLAS_PADDING;
+        shelf = MAX(shelf, glyph.cell->height);
+
+        g_hash_table_iter_replace(&iter, glyph.cell);
+        g_array_append_val(glyphs, glyph);
+    }
+
+    gint scale = gtk_widget_get_scale_factor(widget);
+    int pixel_width = (int)ceil(MAX(ATLAS_WIDTH, x) * scale);
+    int pixel_height = (int)ceil((y + shelf) * scale);
+
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixel_width, pixel_height);
+    cairo_surface_set_device_scale(surface, scale, scale);
+    cairo_t *cr = cairo_create(surface);
+    cairo_set_source_rgba(cr, 1.0, 1.0, 1.0, 1.0);  // Tinted when drawn
+
+    for (guint i = 0; i < glyphs->len; i++) {
+        PendingGlyph *glyph = &g_array_index(glyphs, PendingGlyph, i);
+        cairo_move_to(cr, glyph->cell->x - glyph->logical.x, glyph->cell->y - glyph->logical.y);
+        pango_cairo_show_layout(cr, glyph->layout);
+        g_object_unref(glyph->layout);
+    }
+    g_array_free(glyphs, TRUE);
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+
+    int stride = cairo_image_surface_get_stride(surface);
+    GBytes *bytes = g_bytes_new(cairo_image_surface_get_data(surface), (gsize)stride * pixel_height);
+    self->atlas = gdk_memory_texture_new(pixel_width, pixel_height, GDK_MEMORY_DEFAULT, bytes, stride);
+    g_bytes_unref(bytes);
+    cairo_surface_destroy(surface);
+
+    self->atlas_width = (gdouble)pixel_width / scale;
+    self->atlas_height = (gdouble)pixel_height / scale;
+    self->atlas_scale = scale;
+}
+
+// ========================================
+// WIDGET
+// ========================================
+
+static void dot_matrix_measure(GtkWidget *widget, GtkOrientation orientation, int for_size,
+                               int *minimum, int *natural,
+                               int *minimum_baseline, int *natural_baseline) {
+    DotMatrix *self = DOT_MATRIX(widget);
+
+    update_metrics(self);
+    if (orientation == GTK_ORIENTATION_HORIZONTAL) {
+        *minimum = *natural = (int)ceil(self->cell_width);
+    } else {
+        *minimum = *natural = (int)ceil(self->rows * self->pitch);
+    }
+}
+
+static void dot_matrix_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    DotMatrix *self = DOT_MATRIX(widget);
+
+    if (!self->lines || self->lines->len == 0) return;
+
+    if (self->atlas && self->atlas_scale != gtk_widget_get_scale_factor(widget)) {
+        invalidate_atlas(self);
+    }
+    update_metrics(self);
+    if (self->atlas_dirty) {
+        build_atlas(self);
+    }
+    if (!self->atlas) return;
+
+    gdouble width = gtk_widget_get_width(widget);
+    gdouble height = gtk_widget_get_height(widget);
+
+    // A column shows a window of `rows` lines, text all of its lines; both centered
+    gint first = self->column ? self->first_line : 0;
+    gint count = self->column ? (gint)self->rows : (gint)self->lines->len;
+    gdouble top = (height - count * self->pitch) / 2.0;
+
+    // Atlas is white: keep its alpha, take the color from CSS
+    GdkRGBA fg;
+    gtk_widget_get_color(widget, &fg);
+    float tint_values[16] = { 0 };
+    tint_values[15] = fg.alpha;
+    graphene_matrix_t tint;
+    graphene_vec4_t offset;
+    graphene_matrix_init_from_float(&tint, tint_values);
+    graphene_vec4_init(&offset, fg.red, fg.green, fg.blue, 0.0f);
+    gtk_snapshot_push_color_matrix(snapshot, &tint, &offset);
+
+    for (gint row = 0; row < count; row++) {
+        gint i = first + row;
+        if (i < 0 || i >= (gint)self->lines->len) continue;
+
+        GlyphCell *cell = g_hash_table_lookup(self->cells, g_ptr_array_index(self->lines, i));
+        if (!cell) continue;
+
+        // Wide fallback glyphs (e.g. CJK) shrink to fit the column
+        gdouble scale = MIN(1.0, MIN(width / cell->width, self->pitch / cell->height));
+        gdouble w = cell->width * scale;
+        gdouble h = cell->height * scale;
+        gdouble x = (width - w) / 2.0;
+        gdouble y = top + row * self->pitch + (self->pitch - h) / 2.0;
+
+        gtk_snapshot_push_clip(snapshot, &GRAPHENE_RECT_INIT(x, y, w, h));
+        gtk_snapshot_append_texture(snapshot, self->atlas,
+            &GRAPHENE_RECT_INIT(x - cell->x * scale, y - cell->y * scale,
+                                self->atlas_width * scale, self->atlas_height * scale));
+        gtk_snapshot_pop(snapshot);
+    }
+
+    gtk_snapshot_pop(snapshot);
+}
+
+static void dot_matrix_css_changed(GtkWidget *widget, GtkCssStyleChange *change) {
+    GTK_WIDGET_CLASS(dot_matrix_parent_class)->css_changed(widget, change);
+    check_font(DOT_MATRIX(widget));
+}
+
+static void dot_matrix_system_setting_changed(GtkWidget *widget, GtkSystemSetting setting) {
+    GTK_WIDGET_CLASS(dot_matrix_parent_class)->system_setting_changed(widget, setting);
+
+    // Resolution, hinting or font rendering changed: same font, new pixels
+    switch (setting) {
+        case GTK_SYSTEM_SETTING_DPI:
+        case GTK_SYSTEM_SETTING_FONT_NAME:
+        case GTK_SYSTEM_SETTING_FONT_CONFIG:
+            invalidate_atlas(DOT_MATRIX(widget));
+            break;
+        default:
+            break;
+    }
+}
+
+static void dot_matrix_finalize(GObject *object) {
+    DotMatrix *self = DOT_MATRIX(object);
+
+    g_clear_pointer(&self->lines, g_ptr_array_unref);
+    g_hash_table_destroy(self->cells);
+    g_clear_object(&self->atlas);
+    g_clear_pointer(&self->font, pango_font_description_free);
+
+    G_OBJECT_CLASS(dot_matrix_parent_class)->finalize(object);
+}
+
+static void dot_matrix_class_init(DotMatrixClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+
+    object_class->finalize = dot_matrix_finalize;
+    widget_class->measure = dot_matrix_measure;
+    widget_class->snapshot = dot_matrix_snapshot;
+    widget_class->css_changed = dot_matrix_css_changed;
+    widget_class->system_setting_changed = dot_matrix_system_setting_changed;
+    gtk_widget_class_set_css_name(widget_class, "dot-matrix");
+}
+
+static void dot_matrix_init(DotMatrix *self) {
+    self->rows = 1;
+    self->lines = g_ptr_array_new_with_free_func(g_free);
+    self->column = FALSE;
+    self->first_line = 0;
+    self->cells = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    self->atlas = NULL;
+    self->atlas_dirty = FALSE;
+    self->font = NULL;
+    self->pitch = 0;
+}
+
+// ========================================
+// PUBLIC API
+// ========================================
+
+static void set_lines(DotMatrix *self, GPtrArray *lines, gboolean column) {
+    g_ptr_array_ref(lines);
+    g_ptr_array_unref(self->lines);
+    self->lines = lines;
+    self->column = column;
+    self->first_line = 0;
+
+    want_cells(self);
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+GtkWidget* dot_matrix_new(guint rows) {
+    DotMatrix *self = g_object_new(DOT_TYPE_MATRIX, NULL);
+    self->rows = MAX(rows, 1);
+    return GTK_WIDGET(self);
+}
+
+void dot_matrix_set_text(DotMatrix *matrix, const gchar *text) {
+    g_return_if_fail(DOT_IS_MATRIX(matrix));
+
+    gchar **split = g_strsplit(text ? text : "", "\n", -1);
+    GPtrArray *lines = g_ptr_array_new_with_free_func(g_free);
+    for (gchar **line = split; *line; line++) {
+        g_ptr_array_add(lines, *line);
+    }
+    g_free(split);  // Strings now belong to the array
+
+    set_lines(matrix, lines, FALSE);
+    g_ptr_array_unref(lines);
+}
+
+void dot_matrix_set_column(DotMatrix *matrix, GPtrArray *lines) {
+    g_return_if_fail(DOT_IS_MATRIX(matrix) && lines);
+
+    // Long sessions see many titles; keep the atlas to what is still shown
+    if (g_hash_table_size(matrix->cells) > ATLAS_MAX_CELLS) {
+        evict_cells(matrix, lines);
+    }
+
+    set_lines(matrix, lines, TRUE);
+}
+
+void dot_matrix_scroll_to(DotMatrix *matrix, gint first_line) {
+    g_return_if_fail(DOT_IS_MATRIX(matrix));
+
+    if (matrix->first_line == first_line) return;
+    matrix->first_line = first_line;
+    gtk_widget_queue_draw(GTK_WIDGET(matrix));
+}
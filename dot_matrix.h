@@ -0,0 +1,34 @@
+#ifndef DOT_MATRIX_H
+#define DOT_MATRIX_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Dot Matrix
+ *
+ * One-column character display for the vertical layout. Every distinct
+ * cell (a line of text, usually one character) is rasterized once with
+ * Pango into a shared atlas texture using the widget's CSS font, so scripts
+ * the display font lacks come from Pango's fallback fonts. Each frame draws
+ * the visible cells as textured quads tinted with the CSS color. Changing
+ * the text, scrolling and status frames are redraws; only cells not seen
+ * before are rasterized.
+ */
+
+#define DOT_TYPE_MATRIX (dot_matrix_get_type())
+G_DECLARE_FINAL_TYPE(DotMatrix, dot_matrix, DOT, MATRIX, GtkWidget)
+
+// `rows` is how many cells fit the display; it sets the widget's height
+GtkWidget* dot_matrix_new(guint rows);
+
+// Show `text` vertically centered, one cell per line
+void dot_matrix_set_text(DotMatrix *matrix, const gchar *text);
+
+// Show a column of cells (strings) that can be taller than the display,
+// starting with the first line at the top; move it with dot_matrix_scroll_to()
+void dot_matrix_set_column(DotMatrix *matrix, GPtrArray *lines);
+
+// Put column line `first_line` at the top of the display
+void dot_matrix_scroll_to(DotMatrix *matrix, gint first_line);
+
+#endif // DOT_MATRIX_H
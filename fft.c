@@ -0,0 +1,117 @@
+#include "fft.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+int fft_plan(FftPlan *plan, uint32_t n) {
+    uint32_t log2n = 0;
+    while ((1u << log2n) < n) log2n++;
+    if (n < 2 || n > FFT_MAX_SIZE || (1u << log2n) != n) {
+        plan->n = 0;
+        return -1;
+    }
+
+    plan->n = n;
+    plan->log2n = log2n;
+
+    for (uint32_t i = 0; i < n / 2; i++) {
+        double angle = -2.0 * M_PI * i / n;
+        plan->cos_table[i] = (float)cos(angle);
+        plan->sin_table[i] = (float)sin(angle);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < log2n; b++) {
+            if (i & (1u << b)) r |= 1u << (log2n - 1 - b);
+        }
+        plan->bitrev[i] = r;
+    }
+
+    return 0;
+}
+
+uint32_t fft_floor_pow2(uint32_t n) {
+    uint32_t p = 2;
+    while (p * 2 <= n && p * 2 <= FFT_MAX_SIZE) p *= 2;
+    return p;
+}
+
+// Complex transform of the first m = n >> shift points, reusing the size-n
+// tables: rev_n(i << shift) is rev_m(i) and twiddle strides scale by 2^shift
+static void transform(const FftPlan *plan, float *re, float *im, uint32_t shift) {
+    const uint32_t n = plan->n >> shift;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = plan->bitrev[i << shift];
+        if (j > i) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (uint32_t size = 2; size <= n; size *= 2) {
+        uint32_t half = size / 2;
+        uint32_t step = (n / size) << shift;
+        for (uint32_t start = 0; start < n; start += size) {
+            for (uint32_t k = 0; k < half; k++) {
+                float wr = plan->cos_table[k * step];
+                float wi = plan->sin_table[k * step];
+                uint32_t a = start + k;
+                uint32_t b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+void fft_forward(const FftPlan *plan, float *re, float *im) {
+    if (plan->n == 0) return;
+    transform(plan, re, im, 0);
+}
+
+void fft_forward_real(const FftPlan *plan, float *re, float *im) {
+    const uint32_t n = plan->n;
+    if (n == 0) return;
+    const uint32_t h = n / 2;
+
+    // Even samples as real part, odd as imaginary, then one half-size transform
+    for (uint32_t m = 0; m < h; m++) {
+        im[m] = re[2 * m + 1];
+        re[m] = re[2 * m];
+    }
+    transform(plan, re, im, 1);
+
+    // Untangle Z into X[k] = E[k] + W^k O[k], pairing k with h - k
+    // (E[h-k] = conj E[k], O[h-k] = conj O[k], W^(h-k) = -conj W^k)
+    float z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = 0.0f;
+    re[h] = z0r - z0i;
+    im[h] = 0.0f;
+
+    for (uint32_t k = 1; k <= h / 2; k++) {
+        uint32_t j = h - k;
+        float ar = re[k], ai = im[k];
+        float br = re[j], bi = im[j];
+
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+        float or_ = 0.5f * (ai + bi), oi = -0.5f * (ar - br);
+
+        float wr = plan->cos_table[k], wi = plan->sin_table[k];
+        float tr = or_ * wr - oi * wi;
+        float ti = or_ * wi + oi * wr;
+
+        re[k] = er + tr;
+        im[k] = ei + ti;
+        re[j] = er - tr;
+        im[j] = -ei + ti;
+    }
+}
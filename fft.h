@@ -0,0 +1,38 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+
+/**
+ * FFT
+ *
+ * In-place iterative radix-2 complex FFT on split real/imaginary float
+ * arrays. The plan holds its twiddle and bit-reversal tables inline, so
+ * planning and transforming never allocate.
+ */
+
+#define FFT_MAX_LOG2 13
+#define FFT_MAX_SIZE (1u << FFT_MAX_LOG2)
+
+typedef struct {
+    uint32_t n;                        // Transform size (power of two), 0 = unplanned
+    uint32_t log2n;
+    float cos_table[FFT_MAX_SIZE / 2];
+    float sin_table[FFT_MAX_SIZE / 2];
+    uint32_t bitrev[FFT_MAX_SIZE];
+} FftPlan;
+
+// Plan a transform of size n (power of two, 2..FFT_MAX_SIZE); returns 0 on success
+int fft_plan(FftPlan *plan, uint32_t n);
+
+// Largest power of two <= n, clamped to FFT_MAX_SIZE
+uint32_t fft_floor_pow2(uint32_t n);
+
+// Forward transform in place (no scaling)
+void fft_forward(const FftPlan *plan, float *re, float *im);
+
+// Forward transform of n real samples in `re`; writes bins 0..n/2 to re/im
+// (the rest is scratch). Half the work of fft_forward() with im = 0.
+void fft_forward_real(const FftPlan *plan, float *re, float *im);
+
+#endif // FFT_H
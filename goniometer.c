@@ -0,0 +1,113 @@
+#include "goniometer.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_SQRT1_2
+#define M_SQRT1_2 0.70710678118654752440
+#endif
+
+#define ZOOM_RELEASE_MS 2000.0
+#define ZOOM_FLOOR 0.05f        // Never zoom in more than 20x (keeps noise floor dark)
+#define ZOOM_HEADROOM 0.9f
+#define SAMPLES_FOR_FULL 24.0   // Hits per cell per decay time constant that read as full
+
+void goniometer_init(Goniometer *gonio) {
+    memset(gonio, 0, sizeof(*gonio));
+}
+
+void goniometer_configure(Goniometer *gonio, uint32_t rate, uint32_t channels) {
+    gonio->rate = rate;
+    gonio->channels = channels;
+    if (rate == 0 || channels == 0) {
+        gonio->rate = 0;
+        return;
+    }
+
+    gonio->hop = rate * GONIOMETER_HOP_MS / 1000;
+    if (gonio->hop == 0) gonio->hop = 1;
+
+    double dt = (double)gonio->hop / rate;
+    gonio->decay = (float)exp(-dt / (GONIOMETER_DECAY_MS / 1000.0));
+    gonio->zoom_release = (float)exp(-dt / (ZOOM_RELEASE_MS / 1000.0));
+    gonio->corr_coef = exp(-dt / (GONIOMETER_CORRELATION_MS / 1000.0));
+
+    // A cell hit by a steady 1/SAMPLES_FOR_FULL of the samples in a decay
+    // period reaches ~1.0, independent of the sample rate
+    gonio->hit = (float)(SAMPLES_FOR_FULL / (rate * GONIOMETER_DECAY_MS / 1000.0));
+
+    goniometer_reset(gonio);
+}
+
+void goniometer_reset(Goniometer *gonio) {
+    memset(gonio->grid, 0, sizeof(gonio->grid));
+    memset(gonio->image, 0, sizeof(gonio->image));
+    gonio->zoom_peak = ZOOM_FLOOR;
+    gonio->hop_lr = gonio->hop_ll = gonio->hop_rr = 0.0;
+    gonio->avg_lr = gonio->avg_ll = gonio->avg_rr = 0.0;
+    gonio->correlation = 0.0f;
+    gonio->hop_pos = 0;
+}
+
+static void end_hop(Goniometer *gonio) {
+    for (int i = 0; i < GONIOMETER_SIZE * GONIOMETER_SIZE; i++) {
+        gonio->grid[i] *= gonio->decay;
+    }
+
+    gonio->zoom_peak *= gonio->zoom_release;
+    if (gonio->zoom_peak < ZOOM_FLOOR) gonio->zoom_peak = ZOOM_FLOOR;
+
+    double k = gonio->corr_coef;
+    gonio->avg_lr = k * gonio->avg_lr + (1.0 - k) * gonio->hop_lr;
+    gonio->avg_ll = k * gonio->avg_ll + (1.0 - k) * gonio->hop_ll;
+    gonio->avg_rr = k * gonio->avg_rr + (1.0 - k) * gonio->hop_rr;
+    gonio->hop_lr = gonio->hop_ll = gonio->hop_rr = 0.0;
+
+    double denom = sqrt(gonio->avg_ll * gonio->avg_rr);
+    gonio->correlation = denom > 1e-12 ? (float)(gonio->avg_lr / denom) : 0.0f;
+}
+
+void goniometer_process(Goniometer *gonio, const float *samples, size_t n_frames, uint32_t stride) {
+    if (gonio->rate == 0) return;
+
+    const uint32_t right = gonio->channels > 1 ? 1 : 0;
+    const float half = GONIOMETER_SIZE * 0.5f;
+    const float rot = (float)M_SQRT1_2;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * stride;
+        float l = frame[0];
+        float r = frame[right];
+
+        gonio->hop_lr += (double)l * r;
+        gonio->hop_ll += (double)l * l;
+        gonio->hop_rr += (double)r * r;
+
+        // Rotate 45 degrees: mid up, side across
+        float side = (l - r) * rot;
+        float mid = (l + r) * rot;
+
+        float extent = fmaxf(fabsf(side), fabsf(mid));
+        if (extent > gonio->zoom_peak) gonio->zoom_peak = extent;
+        float scale = ZOOM_HEADROOM * half / gonio->zoom_peak;
+
+        int x = (int)(half + side * scale);
+        int y = (int)(half - mid * scale);
+        if (x >= 0 && x < GONIOMETER_SIZE && y >= 0 && y < GONIOMETER_SIZE) {
+            gonio->grid[y * GONIOMETER_SIZE + x] += gonio->hit;
+        }
+
+        if (++gonio->hop_pos >= gonio->hop) {
+            gonio->hop_pos = 0;
+            end_hop(gonio);
+        }
+    }
+}
+
+void goniometer_render(Goniometer *gonio) {
+    for (int i = 0; i < GONIOMETER_SIZE * GONIOMETER_SIZE; i++) {
+        // Soft saturation: dense areas approach full, single hits stay visible
+        float g = gonio->grid[i];
+        float v = g / (g + 0.35f);
+        gonio->image[i] = (uint8_t)(v * 255.0f + 0.5f);
+    }
+}
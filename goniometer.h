@@ -0,0 +1,66 @@
+#ifndef GONIOMETER_H
+#define GONIOMETER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Goniometer / Correlation Analysis
+ *
+ * Stereo vectorscope: every L/R sample pair is rotated 45 degrees into
+ * mid (vertical) / side (horizontal) and splatted into a square intensity
+ * grid that decays with a fixed time constant, so density and persistence
+ * do not depend on buffer sizes. goniometer_render() tone-maps the grid
+ * into an 8-bit image, ready to become a single texture.
+ *
+ * Alongside it a phase correlation meter (-1 = out of phase, 0 = wide /
+ * uncorrelated, +1 = mono) is tracked with an exponential window.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define GONIOMETER_SIZE 128
+#define GONIOMETER_HOP_MS 10
+#define GONIOMETER_DECAY_MS 150.0
+#define GONIOMETER_CORRELATION_MS 300.0
+
+typedef struct {
+    uint32_t rate;                     // 0 until configured
+    uint32_t channels;
+
+    float grid[GONIOMETER_SIZE * GONIOMETER_SIZE];
+    float hit;                         // Intensity added per sample
+    float decay;                       // Grid multiplier per hop
+
+    // Auto-zoom so quiet material still fills the scope
+    float zoom_peak;
+    float zoom_release;                // Per hop
+
+    // Correlation accumulators (per hop) and smoothed sums
+    double hop_lr, hop_ll, hop_rr;
+    double avg_lr, avg_ll, avg_rr;
+    double corr_coef;                  // Per hop
+    float correlation;
+
+    uint32_t hop;
+    uint32_t hop_pos;
+
+    uint8_t image[GONIOMETER_SIZE * GONIOMETER_SIZE];   // Row 0 = top
+} Goniometer;
+
+// Zero all state; the analyzer ignores input until goniometer_configure()
+void goniometer_init(Goniometer *gonio);
+
+// Apply a negotiated format (mono input is shown as a vertical line)
+void goniometer_configure(Goniometer *gonio, uint32_t rate, uint32_t channels);
+
+// Clear the scope and correlation history (format is kept)
+void goniometer_reset(Goniometer *gonio);
+
+// Feed interleaved F32 frames with `stride` floats per frame; channels 0/1 are L/R
+void goniometer_process(Goniometer *gonio, const float *samples, size_t n_frames, uint32_t stride);
+
+// Tone-map the intensity grid into `image`
+void goniometer_render(Goniometer *gonio);
+
+#endif // GONIOMETER_H
@@ -4,7 +4,7 @@
 ACTION="$1"
 
 if [ -z "$ACTION" ]; then
-    echo "Usage: hyprwave-toggle {visibility|expand}"
+    echo "Usage: hyprwave-toggle {visibility|expand|path|latency|rt}"
     exit 1
 fi
 
@@ -21,9 +21,21 @@ case "$ACTION" in
     expand)
         kill -USR2 "$PID"
         ;;
+    path)
+        gdbus call --session --dest com.hyprwave.app --object-path /com/hyprwave/app \
+            --method com.hyprwave.HyprWave.GetSignalPath | sed -e "s/^('//" -e "s/',)$//"
+        ;;
+    latency)
+        gdbus call --session --dest com.hyprwave.app --object-path /com/hyprwave/app \
+            --method com.hyprwave.HyprWave.GetLatencyStats | sed -e "s/^('//" -e "s/',)$//" -e 's/\\n/\n/g'
+        ;;
+    rt)
+        gdbus call --session --dest com.hyprwave.app --object-path /com/hyprwave/app \
+            --method com.hyprwave.HyprWave.GetRtHealth | sed -e "s/^('//" -e "s/',)$//" -e 's/\\n/\n/g'
+        ;;
     *)
         echo "Invalid action: $ACTION"
-        echo "Usage: hyprwave-toggle {visibility|expand}"
+        echo "Usage: hyprwave-toggle {visibility|expand|path|latency|rt}"
         exit 1
         ;;
 esac
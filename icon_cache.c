@@ -0,0 +1,137 @@
+#include "icon_cache.h"
+#include "paths.h"
+
+// Icons the control bar and volume popup switch between
+static const gchar *preloaded_icons[] = {
+    "play.svg", "pause.svg", "previous.svg", "next.svg",
+    "arrow-up.svg", "arrow-down.svg", "arrow-left.svg", "arrow-right.svg",
+    "volume-high.svg", "volume-medium.svg", "volume-low.svg", "volume-mute.svg",
+};
+
+// ========================================
+// ICON PAINTABLE
+// ========================================
+
+#define ICON_TYPE_PAINTABLE (icon_paintable_get_type())
+G_DECLARE_FINAL_TYPE(IconPaintable, icon_paintable, ICON, PAINTABLE, GObject)
+
+struct _IconPaintable {
+    GObject parent_instance;
+
+    gchar *path;                  // Resolved once with get_icon_path()
+    GdkTexture *texture;          // Rasterized at the cache's scale factor (NULL if it failed)
+};
+
+static void icon_paintable_snapshot(GdkPaintable *paintable, GdkSnapshot *snapshot,
+                                    double width, double height) {
+    IconPaintable *self = ICON_PAINTABLE(paintable);
+
+    if (!self->texture) return;
+    gdk_paintable_snapshot(GDK_PAINTABLE(self->texture), snapshot, width, height);
+}
+
+static int icon_paintable_get_intrinsic_width(GdkPaintable *paintable) {
+    return ICON_CACHE_SIZE;
+}
+
+static int icon_paintable_get_intrinsic_height(GdkPaintable *paintable) {
+    return ICON_CACHE_SIZE;
+}
+
+static void icon_paintable_iface_init(GdkPaintableInterface *iface) {
+    iface->snapshot = icon_paintable_snapshot;
+    iface->get_intrinsic_width = icon_paintable_get_intrinsic_width;
+    iface->get_intrinsic_height = icon_paintable_get_intrinsic_height;
+}
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(IconPaintable, icon_paintable, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(GDK_TYPE_PAINTABLE, icon_paintable_iface_init))
+
+static void icon_paintable_finalize(GObject *object) {
+    IconPaintable *self = ICON_PAINTABLE(object);
+
+    g_clear_object(&self->texture);
+    g_free(self->path);
+
+    G_OBJECT_CLASS(icon_paintable_parent_class)->finalize(object);
+}
+
+static void icon_paintable_class_init(IconPaintableClass *klass) {
+    G_OBJECT_CLASS(klass)->finalize = icon_paintable_finalize;
+}
+
+static void icon_paintable_init(IconPaintable *self) {
+    self->path = NULL;
+    self->texture = NULL;
+}
+
+// ========================================
+// CACHE
+// ========================================
+
+static GHashTable *icons = NULL;  // Icon name → IconPaintable
+static gint cache_scale = 0;      // Scale factor the textures are rasterized at
+
+static void rasterize(IconPaintable *icon) {
+    gint size = ICON_CACHE_SIZE * MAX(cache_scale, 1);
+    GError *error = NULL;
+    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file_at_size(icon->path, size, size, &error);
+
+    g_clear_object(&icon->texture);
+    if (pixbuf) {
+        icon->texture = gdk_texture_new_for_pixbuf(pixbuf);
+        g_object_unref(pixbuf);
+    } else {
+        g_printerr("Failed to load icon %s: %s\n", icon->path, error->message);
+        g_error_free(error);
+    }
+}
+
+static IconPaintable* lookup(const gchar *icon_name) {
+    if (!icons) {
+        icons = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+    }
+
+    IconPaintable *icon = g_hash_table_lookup(icons, icon_name);
+    if (icon) return icon;
+
+    icon = g_object_new(ICON_TYPE_PAINTABLE, NULL);
+    icon->path = get_icon_path(icon_name);
+    rasterize(icon);
+    g_hash_table_insert(icons, g_strdup(icon_name), icon);
+    return icon;
+}
+
+void icon_cache_load(gint scale_factor) {
+    scale_factor = MAX(scale_factor, 1);
+    if (scale_factor == cache_scale) return;
+    cache_scale = scale_factor;
+
+    // New icons are rasterized at the new scale; redo the ones already handed out
+    if (icons) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, icons);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            rasterize(ICON_PAINTABLE(value));
+            gdk_paintable_invalidate_contents(GDK_PAINTABLE(value));
+        }
+    }
+
+    for (guint i = 0; i < G_N_ELEMENTS(preloaded_icons); i++) {
+        lookup(preloaded_icons[i]);
+    }
+    g_print("Icons rasterized at %dx (%u cached)\n", cache_scale, g_hash_table_size(icons));
+}
+
+GdkPaintable* icon_cache_get(const gchar *icon_name) {
+    if (cache_scale == 0) icon_cache_load(1);
+    return GDK_PAINTABLE(lookup(icon_name));
+}
+
+void icon_cache_set_image(GtkWidget *image, const gchar *icon_name) {
+    GdkPaintable *paintable = icon_cache_get(icon_name);
+
+    if (gtk_image_get_paintable(GTK_IMAGE(image)) == paintable) return;
+    gtk_image_set_from_paintable(GTK_IMAGE(image), paintable);
+}
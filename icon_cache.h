@@ -0,0 +1,29 @@
+#ifndef ICON_CACHE_H
+#define ICON_CACHE_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Icon Cache
+ *
+ * Every control icon is looked up (get_icon_path) and rasterized once, at
+ * the window's scale factor, into a texture. Each icon name has one
+ * paintable that images keep pointing at, so switching an icon is a pointer
+ * assignment with no file access or SVG parsing. When the scale factor
+ * changes the textures are rasterized again in place and every image
+ * showing them redraws.
+ */
+
+#define ICON_CACHE_SIZE 20        // Logical px icons are drawn at (gtk_image_set_pixel_size)
+
+// Rasterize the control icons for `scale_factor`; does nothing if it is unchanged
+void icon_cache_load(gint scale_factor);
+
+// Paintable for `icon_name` (e.g. "play.svg"), owned by the cache. Icons
+// outside the preloaded set are loaded on first use.
+GdkPaintable* icon_cache_get(const gchar *icon_name);
+
+// Show `icon_name` in a GtkImage (nothing happens if it already does)
+void icon_cache_set_image(GtkWidget *image, const gchar *icon_name);
+
+#endif // ICON_CACHE_H
@@ -0,0 +1,104 @@
+#include "ipc.h"
+#include <string.h>
+
+static const gchar introspection_xml[] =
+    "<node>"
+    "  <interface name='com.hyprwave.HyprWave'>"
+    "    <method name='GetSignalPath'>"
+    "      <arg type='s' name='path' direction='out'/>"
+    "    </method>"
+    "    <method name='GetLatencyStats'>"
+    "      <arg type='s' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='GetRtHealth'>"
+    "      <arg type='s' name='health' direction='out'/>"
+    "    </method>"
+    "  </interface>"
+    "</node>";
+
+static GDBusConnection *ipc_connection = NULL;
+static GDBusNodeInfo *ipc_node_info = NULL;
+static guint ipc_registration_id = 0;
+static IpcHandlers ipc_handlers;
+
+static void return_string(GDBusMethodInvocation *invocation, IpcStringFunc func) {
+    gchar *value = func ? func(ipc_handlers.user_data) : NULL;
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(s)", value ? value : ""));
+    g_free(value);
+}
+
+static void handle_method_call(GDBusConnection *connection,
+                               const gchar *sender,
+                               const gchar *object_path,
+                               const gchar *interface_name,
+                               const gchar *method_name,
+                               GVariant *parameters,
+                               GDBusMethodInvocation *invocation,
+                               gpointer user_data) {
+    if (g_strcmp0(method_name, "GetSignalPath") == 0) {
+        return_string(invocation, ipc_handlers.get_signal_path);
+        return;
+    }
+    if (g_strcmp0(method_name, "GetLatencyStats") == 0) {
+        return_string(invocation, ipc_handlers.get_latency_stats);
+        return;
+    }
+    if (g_strcmp0(method_name, "GetRtHealth") == 0) {
+        return_string(invocation, ipc_handlers.get_rt_health);
+        return;
+    }
+
+    g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD,
+                                          "Unknown method %s", method_name);
+}
+
+static const GDBusInterfaceVTable interface_vtable = {
+    handle_method_call,
+    NULL,
+    NULL,
+    { 0 }
+};
+
+gboolean ipc_init(GApplication *app, const IpcHandlers *handlers) {
+    if (ipc_registration_id > 0) return TRUE;
+
+    GDBusConnection *connection = g_application_get_dbus_connection(app);
+    const gchar *object_path = g_application_get_dbus_object_path(app);
+    if (!connection || !object_path) {
+        g_printerr("IPC: Application is not on the session bus\n");
+        return FALSE;
+    }
+
+    GError *error = NULL;
+    ipc_node_info = g_dbus_node_info_new_for_xml(introspection_xml, &error);
+    if (!ipc_node_info) {
+        g_printerr("IPC: Bad introspection data: %s\n", error->message);
+        g_error_free(error);
+        return FALSE;
+    }
+
+    ipc_handlers = *handlers;
+    ipc_registration_id = g_dbus_connection_register_object(connection, object_path,
+                                                            ipc_node_info->interfaces[0],
+                                                            &interface_vtable, NULL, NULL, &error);
+    if (ipc_registration_id == 0) {
+        g_printerr("IPC: Failed to export interface: %s\n", error->message);
+        g_error_free(error);
+        g_clear_pointer(&ipc_node_info, g_dbus_node_info_unref);
+        return FALSE;
+    }
+
+    ipc_connection = g_object_ref(connection);
+    g_print("✓ D-Bus interface com.hyprwave.HyprWave exported at %s\n", object_path);
+    return TRUE;
+}
+
+void ipc_cleanup(void) {
+    if (ipc_registration_id > 0) {
+        g_dbus_connection_unregister_object(ipc_connection, ipc_registration_id);
+        ipc_registration_id = 0;
+    }
+    g_clear_object(&ipc_connection);
+    g_clear_pointer(&ipc_node_info, g_dbus_node_info_unref);
+    memset(&ipc_handlers, 0, sizeof(ipc_handlers));
+}
@@ -0,0 +1,39 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <gio/gio.h>
+
+/**
+ * HyprWave D-Bus Interface
+ *
+ * Exports com.hyprwave.HyprWave on the application's own bus name
+ * (com.hyprwave.app) at its object path, for scripts and status bars:
+ *
+ *   gdbus call --session --dest com.hyprwave.app --object-path /com/hyprwave/app \
+ *       --method com.hyprwave.HyprWave.GetSignalPath
+ *
+ * Methods:
+ *   GetSignalPath() -> s      Player -> device path with per-hop notes
+ *   GetLatencyStats() -> s    Visualizer capture -> present latency percentiles
+ *   GetRtHealth() -> s        Capture callback timing, xrun and RT-safety counters
+ *
+ * Method handlers run on the GTK main thread.
+ */
+
+// Returns a newly allocated string, or NULL if unknown
+typedef gchar* (*IpcStringFunc)(gpointer user_data);
+
+typedef struct {
+    IpcStringFunc get_signal_path;
+    IpcStringFunc get_latency_stats;
+    IpcStringFunc get_rt_health;
+    gpointer user_data;
+} IpcHandlers;
+
+// Register the interface (call once the application is registered, e.g. in activate)
+gboolean ipc_init(GApplication *app, const IpcHandlers *handlers);
+
+// Unregister the interface
+void ipc_cleanup(void);
+
+#endif // IPC_H
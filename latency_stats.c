@@ -0,0 +1,36 @@
+#include "latency_stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+void latency_series_reset(LatencySeries *series) {
+    series->pos = 0;
+    series->count = 0;
+}
+
+void latency_series_add(LatencySeries *series, float ms) {
+    series->samples[series->pos] = ms;
+    series->pos = (series->pos + 1) % LATENCY_STATS_WINDOW;
+    if (series->count < LATENCY_STATS_WINDOW) series->count++;
+}
+
+static int compare_float(const void *a, const void *b) {
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+uint32_t latency_series_percentiles(const LatencySeries *series, const float *ps, int n, float *out) {
+    if (series->count == 0) return 0;
+
+    // Order doesn't matter for percentiles: the first `count` slots are valid either way
+    float sorted[LATENCY_STATS_WINDOW];
+    memcpy(sorted, series->samples, series->count * sizeof(float));
+    qsort(sorted, series->count, sizeof(float), compare_float);
+
+    for (int i = 0; i < n; i++) {
+        float p = ps[i] < 0.0f ? 0.0f : (ps[i] > 100.0f ? 100.0f : ps[i]);
+        uint32_t rank = (uint32_t)(p / 100.0f * (series->count - 1) + 0.5f);
+        out[i] = sorted[rank];
+    }
+    return series->count;
+}
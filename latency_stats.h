@@ -0,0 +1,32 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+
+/**
+ * Rolling Latency Statistics
+ *
+ * Keeps the last LATENCY_STATS_WINDOW samples of one latency series (in
+ * milliseconds) and answers percentile queries over them. Samples are O(1)
+ * to add; percentiles sort a copy of the window, so query them at human
+ * rates (IPC, logging), not per sample.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define LATENCY_STATS_WINDOW 1024       // ~17 s of frames at 60 fps
+
+typedef struct {
+    float samples[LATENCY_STATS_WINDOW];
+    uint32_t pos;                       // Next slot to write
+    uint32_t count;                     // Valid samples (<= window)
+} LatencySeries;
+
+void latency_series_reset(LatencySeries *series);
+void latency_series_add(LatencySeries *series, float ms);
+
+// Fill out[i] with the ps[i] percentile (0..100) of the window; returns the
+// number of samples used (0 leaves out untouched)
+uint32_t latency_series_percentiles(const LatencySeries *series, const float *ps, int n, float *out);
+
+#endif // LATENCY_STATS_H
@@ -6,11 +6,30 @@
 // CONFIG LOADING
 // ========================================
 
+// Debounce for file monitor events: editors save in several steps
+#define CONFIG_RELOAD_DELAY_MS 200
+
+static LayoutConfig *current_config = NULL;
+
+typedef struct {
+    GFileMonitor *monitor;
+    guint reload_timer;
+    LayoutConfigChangedFunc func;
+    gpointer user_data;
+} ConfigWatch;
+
+static ConfigWatch config_watch = { NULL, 0, NULL, NULL };
+
+static gchar* config_file_path(void) {
+    return g_build_filename(g_get_user_config_dir(), "hyprwave", "config.conf", NULL);
+}
+
 LayoutConfig* layout_load_config(void) {
     LayoutConfig *config = g_new0(LayoutConfig, 1);
+    config->ref_count = 1;
 
     gchar *config_dir = g_build_filename(g_get_user_config_dir(), "hyprwave", NULL);
-    gchar *config_file = g_build_filename(config_dir, "config.conf", NULL);
+    gchar *config_file = config_file_path();
 
     // Create config directory if it doesn't exist
     g_mkdir_with_parents(config_dir, 0755);
@@ -31,6 +50,9 @@ LayoutConfig* layout_load_config(void) {
             "# Theme: light or dark\n"
             "theme = light\n"
             "\n"
+            "# Volume control: auto (PipeWire, then MPRIS), pipewire or mpris\n"
+            "volume_method = auto\n"
+            "\n"
             "[MusicPlayer]\n"
             "# Comma-separated list of preferred music players (first = highest priority)\n"
             "# HyprWave will search for these in order and latch onto the first one found\n"
@@ -52,6 +74,10 @@ LayoutConfig* layout_load_config(void) {
             "# Show notification when song changes\n"
             "now_playing = true\n"
             "\n"
+            "# Seconds to keep the notification window around after it hides\n"
+            "# It is rebuilt on the next notification. Set to 0 to free it right away\n"
+            "keep_alive = 60\n"
+            "\n"
             "[Visualizer]\n"
             "# Enable/disable visualizer (horizontal layout only)\n"
             "enabled = true\n"
@@ -60,6 +86,17 @@ LayoutConfig* layout_load_config(void) {
             "# Set to 0 to disable auto-activation (visualizer only shows on demand)\n"
             "idle_timeout = 30\n"
             "\n"
+            "# Rate (Hz) the visualizer analyzes audio at; input is downmixed to mono\n"
+            "# and decimated to this rate. The top bar sits at 0.45x this rate (16 kHz at most),\n"
+            "# so lower it only to save CPU at the cost of treble. 0 = the stream's native rate\n"
+            "analysis_rate = 36000\n"
+            "\n"
+            "# What the visualizer shows: bars, loudness (EBU R128 meter)\n"
+            "# spectrogram (scrolling waterfall), goniometer (stereo scope + correlation)\n"
+            "# oscilloscope (triggered waveform) or chroma (pitch classes + key)\n"
+            "# Click the visualizer to cycle modes\n"
+            "mode = bars\n"
+            "\n"
             "[VerticalDisplay]\n"
             "# Enable/disable vertical display (vertical layout only)\n"
             "enabled = true\n"
@@ -82,14 +119,17 @@ LayoutConfig* layout_load_config(void) {
     config->toggle_expand_bind = g_strdup("Super+M");
     config->notifications_enabled = TRUE;
     config->now_playing_enabled = TRUE;
+    config->notification_keep_alive = 60;
     config->theme = g_strdup("light");
     config->visualizer_enabled = TRUE;
     config->visualizer_idle_timeout = 30;
+    config->visualizer_analysis_rate = 36000;
+    config->visualizer_mode = g_strdup("bars");
     config->vertical_display_enabled = TRUE;
     config->vertical_display_scroll_interval = 5;
     config->player_preference = NULL;
     config->player_preference_count = 0;
-
+    config->volume_method = VOLUME_METHOD_AUTO;
 
     if (g_key_file_load_from_file(keyfile, config_file, G_KEY_FILE_NONE, NULL)) {
         // Load General section
@@ -118,6 +158,18 @@ LayoutConfig* layout_load_config(void) {
             config->theme = theme_str;
         }
 
+        gchar *volume_str = g_key_file_get_string(keyfile, "General", "volume_method", NULL);
+        if (volume_str) {
+            g_strstrip(volume_str);
+            if (g_strcmp0(volume_str, "pipewire") == 0) {
+                config->volume_method = VOLUME_METHOD_PIPEWIRE;
+            } else if (g_strcmp0(volume_str, "mpris") == 0) {
+                config->volume_method = VOLUME_METHOD_MPRIS;
+            }
+            // "auto" or any other value stays as VOLUME_METHOD_AUTO
+            g_free(volume_str);
+        }
+
         // Load Keybinds section (optional)
         gchar *vis_bind = g_key_file_get_string(keyfile, "Keybinds", "toggle_visibility", NULL);
         if (vis_bind) {
@@ -149,6 +201,14 @@ LayoutConfig* layout_load_config(void) {
             error = NULL;
         }
 
+        gint keep_alive = g_key_file_get_integer(keyfile, "Notifications", "keep_alive", &error);
+        if (!error) {
+            config->notification_keep_alive = keep_alive < 0 ? 0 : keep_alive;
+        } else {
+            g_error_free(error);
+            error = NULL;
+        }
+
         // Load Visualizer section (optional)
         gboolean viz_enabled = g_key_file_get_boolean(keyfile, "Visualizer", "enabled", &error);
         if (!error) {
@@ -164,6 +224,22 @@ LayoutConfig* layout_load_config(void) {
             if (config->visualizer_idle_timeout < 0) config->visualizer_idle_timeout = 0;
         } else {
             g_error_free(error);
+            error = NULL;
+        }
+
+        gint analysis_rate = g_key_file_get_integer(keyfile, "Visualizer", "analysis_rate", &error);
+        if (!error) {
+            config->visualizer_analysis_rate = analysis_rate < 0 ? 0 : analysis_rate;
+        } else {
+            g_error_free(error);
+            error = NULL;
+        }
+
+        gchar *viz_mode = g_key_file_get_string(keyfile, "Visualizer", "mode", NULL);
+        if (viz_mode) {
+            g_strstrip(viz_mode);
+            g_free(config->visualizer_mode);
+            config->visualizer_mode = viz_mode;
         }
     
     
@@ -202,16 +278,136 @@ LayoutConfig* layout_load_config(void) {
     return config;
 }
 
-void layout_free_config(LayoutConfig *config) {
-    if (config) {
-        g_free(config->toggle_visibility_bind);
-        g_free(config->toggle_expand_bind);
-        g_free(config->theme);
-        if (config->player_preference) {
-            g_strfreev(config->player_preference);
-        }
-        g_free(config);
+LayoutConfig* layout_config_ref(LayoutConfig *config) {
+    g_return_val_if_fail(config != NULL, NULL);
+    g_atomic_int_inc(&config->ref_count);
+    return config;
+}
+
+void layout_config_unref(LayoutConfig *config) {
+    if (!config || !g_atomic_int_dec_and_test(&config->ref_count)) return;
+
+    g_free(config->toggle_visibility_bind);
+    g_free(config->toggle_expand_bind);
+    g_free(config->theme);
+    g_free(config->visualizer_mode);
+    if (config->player_preference) {
+        g_strfreev(config->player_preference);
+    }
+    g_free(config);
+}
+
+LayoutConfig* layout_get_config(void) {
+    if (!current_config) {
+        current_config = layout_load_config();
+    }
+    return current_config;
+}
+
+guint layout_config_diff(const LayoutConfig *old_config, const LayoutConfig *new_config) {
+    guint changes = 0;
+
+    if (old_config->edge != new_config->edge || old_config->margin != new_config->margin) {
+        changes |= LAYOUT_CHANGED_EDGE;
+    }
+    if (g_strcmp0(old_config->theme, new_config->theme) != 0) {
+        changes |= LAYOUT_CHANGED_THEME;
+    }
+    if (old_config->visualizer_enabled != new_config->visualizer_enabled ||
+        old_config->visualizer_analysis_rate != new_config->visualizer_analysis_rate ||
+        g_strcmp0(old_config->visualizer_mode, new_config->visualizer_mode) != 0) {
+        changes |= LAYOUT_CHANGED_VISUALIZER;
+    }
+    if (old_config->visualizer_idle_timeout != new_config->visualizer_idle_timeout ||
+        old_config->vertical_display_enabled != new_config->vertical_display_enabled ||
+        old_config->vertical_display_scroll_interval != new_config->vertical_display_scroll_interval) {
+        changes |= LAYOUT_CHANGED_IDLE;
+    }
+    if (old_config->notifications_enabled != new_config->notifications_enabled ||
+        old_config->now_playing_enabled != new_config->now_playing_enabled ||
+        old_config->notification_keep_alive != new_config->notification_keep_alive) {
+        changes |= LAYOUT_CHANGED_NOTIFICATIONS;
+    }
+    if (old_config->volume_method != new_config->volume_method) {
+        changes |= LAYOUT_CHANGED_VOLUME;
+    }
+
+    return changes;
+}
+
+// ========================================
+// LIVE RELOAD
+// ========================================
+
+static gboolean on_config_reload(gpointer user_data) {
+    config_watch.reload_timer = 0;
+
+    // Mid-save (or deleted): keep what we have rather than writing defaults over it
+    gchar *config_file = config_file_path();
+    gboolean exists = g_file_test(config_file, G_FILE_TEST_EXISTS);
+    g_free(config_file);
+    if (!exists) return G_SOURCE_REMOVE;
+
+    LayoutConfig *old_config = layout_get_config();
+    LayoutConfig *new_config = layout_load_config();
+
+    // The widget tree is built for one orientation; stay on the running edge
+    if (new_config->is_vertical != old_config->is_vertical) {
+        g_print("Config: edge change to the other orientation needs a restart\n");
+        new_config->edge = old_config->edge;
+        new_config->is_vertical = old_config->is_vertical;
+    }
+
+    guint changes = layout_config_diff(old_config, new_config);
+    if (changes == 0) {
+        layout_config_unref(new_config);
+        return G_SOURCE_REMOVE;
     }
+
+    current_config = new_config;
+    g_print("Config reloaded (changes: 0x%x)\n", changes);
+    if (config_watch.func) {
+        config_watch.func(new_config, changes, config_watch.user_data);
+    }
+    layout_config_unref(old_config);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void on_config_file_changed(GFileMonitor *monitor, GFile *file, GFile *other_file,
+                                   GFileMonitorEvent event_type, gpointer user_data) {
+    if (event_type == G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED) return;
+
+    if (config_watch.reload_timer > 0) {
+        g_source_remove(config_watch.reload_timer);
+    }
+    config_watch.reload_timer = g_timeout_add(CONFIG_RELOAD_DELAY_MS, on_config_reload, NULL);
+}
+
+void layout_watch_config(LayoutConfigChangedFunc func, gpointer user_data) {
+    config_watch.func = func;
+    config_watch.user_data = user_data;
+    if (config_watch.monitor) return;
+
+    layout_get_config();
+
+    gchar *config_file = config_file_path();
+    GFile *file = g_file_new_for_path(config_file);
+    GError *error = NULL;
+
+    // Watch the file by name so editors that save by rename are followed
+    config_watch.monitor = g_file_monitor_file(file, G_FILE_MONITOR_WATCH_MOVES, NULL, &error);
+    if (config_watch.monitor) {
+        g_signal_connect(config_watch.monitor, "changed",
+                         G_CALLBACK(on_config_file_changed), NULL);
+        g_print("Watching %s for changes\n", config_file);
+    } else {
+        g_printerr("Failed to watch config file: %s\n", error->message);
+        g_error_free(error);
+    }
+
+    g_object_unref(file);
+    g_free(config_file);
 }
 
 // ========================================
@@ -225,16 +421,11 @@ void layout_setup_window_anchors(GtkWindow *window, LayoutConfig *config) {
     gtk_layer_set_anchor(window, GTK_LAYER_SHELL_EDGE_TOP, config->edge == EDGE_TOP);
     gtk_layer_set_anchor(window, GTK_LAYER_SHELL_EDGE_BOTTOM, config->edge == EDGE_BOTTOM);
 
-    // Set margin
-    if (config->edge == EDGE_RIGHT) {
-        gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_RIGHT, config->margin);
-    } else if (config->edge == EDGE_LEFT) {
-        gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_LEFT, config->margin);
-    } else if (config->edge == EDGE_TOP) {
-        gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_TOP, config->margin);
-    } else {
-        gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_BOTTOM, config->margin);
-    }
+    // Set margin on the anchored edge; clear the rest (the edge can change on reload)
+    gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_RIGHT, config->edge == EDGE_RIGHT ? config->margin : 0);
+    gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_LEFT, config->edge == EDGE_LEFT ? config->margin : 0);
+    gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_TOP, config->edge == EDGE_TOP ? config->margin : 0);
+    gtk_layer_set_margin(window, GTK_LAYER_SHELL_EDGE_BOTTOM, config->edge == EDGE_BOTTOM ? config->margin : 0);
 }
 
 // ========================================
@@ -365,24 +556,24 @@ GtkWidget* layout_create_main_container(LayoutConfig *config,
     gtk_widget_set_hexpand(main_container, FALSE);
     gtk_widget_set_vexpand(main_container, FALSE);
 
-    if (config->is_vertical) {
-        // Vertical: control bar on edge, revealer slides outward
-        gtk_box_append(GTK_BOX(main_container), control_bar);
-        gtk_box_append(GTK_BOX(main_container), revealer);
-    } else {
-        // Horizontal: order depends on top or bottom
-        if (config->edge == EDGE_TOP) {
-            gtk_box_append(GTK_BOX(main_container), control_bar);
-            gtk_box_append(GTK_BOX(main_container), revealer);
-        } else {
-            gtk_box_append(GTK_BOX(main_container), revealer);
-            gtk_box_append(GTK_BOX(main_container), control_bar);
-        }
-    }
+    gtk_box_append(GTK_BOX(main_container), control_bar);
+    gtk_box_append(GTK_BOX(main_container), revealer);
+    layout_order_main_container(config, main_container, control_bar, revealer);
 
     return main_container;
 }
 
+void layout_order_main_container(LayoutConfig *config, GtkWidget *main_container,
+                                 GtkWidget *control_bar, GtkWidget *revealer) {
+    if (config->is_vertical || config->edge == EDGE_TOP) {
+        // Vertical, or top edge: control bar on edge, revealer slides outward
+        gtk_box_reorder_child_after(GTK_BOX(main_container), control_bar, NULL);
+    } else {
+        // Bottom edge: revealer above the control bar
+        gtk_box_reorder_child_after(GTK_BOX(main_container), revealer, NULL);
+    }
+}
+
 // ========================================
 // HELPER FUNCTIONS
 // ========================================
@@ -410,3 +601,16 @@ GtkRevealerTransitionType layout_get_transition_type(LayoutConfig *config) {
         }
     }
 }
+
+GtkRevealerTransitionType layout_get_window_transition_type(LayoutConfig *config) {
+    // The whole window slides in from its edge
+    if (config->edge == EDGE_RIGHT) {
+        return GTK_REVEALER_TRANSITION_TYPE_SLIDE_LEFT;
+    } else if (config->edge == EDGE_LEFT) {
+        return GTK_REVEALER_TRANSITION_TYPE_SLIDE_RIGHT;
+    } else if (config->edge == EDGE_TOP) {
+        return GTK_REVEALER_TRANSITION_TYPE_SLIDE_DOWN;
+    } else {
+        return GTK_REVEALER_TRANSITION_TYPE_SLIDE_UP;
+    }
+}
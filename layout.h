@@ -11,7 +11,26 @@ typedef enum {
     EDGE_BOTTOM
 } ScreenEdge;
 
+/**
+ * Volume control method configuration.
+ * Determines how HyprWave controls player volume.
+ */
+typedef enum {
+    VOLUME_METHOD_AUTO,      // Try PipeWire first, fall back to MPRIS
+    VOLUME_METHOD_PIPEWIRE,  // PipeWire sink-input only (fails for network players)
+    VOLUME_METHOD_MPRIS      // MPRIS Volume property only (fails for Chromium/Roon)
+} VolumeMethod;
+
+/**
+ * Parsed config.conf.
+ *
+ * A snapshot is never modified once loaded. Every module reads the shared
+ * one from layout_get_config() (or keeps its own reference) instead of
+ * parsing the file again. layout_watch_config() replaces it when the file
+ * changes and reports which parts differ.
+ */
 typedef struct {
+    gint ref_count;
     ScreenEdge edge;
     int margin;
     gboolean is_vertical;
@@ -19,15 +38,32 @@ typedef struct {
     gchar *toggle_expand_bind;
     gboolean notifications_enabled;
     gboolean now_playing_enabled;
+    gint notification_keep_alive;          // Seconds the notification window outlives its last slide-out
     gchar *theme;  // "light" or "dark" (Hi-Fi feature)
     gboolean visualizer_enabled;
     gint visualizer_idle_timeout;
+    gint visualizer_analysis_rate;         // Decimated analysis rate in Hz, 0 = native
+    gchar *visualizer_mode;                // "bars", "loudness", "spectrogram", "goniometer", "oscilloscope" or "chroma"
     gboolean vertical_display_enabled;
     gint vertical_display_scroll_interval;
     gchar **player_preference;             // Array of preferred players (e.g., ["spotify", "vlc"])
     gint player_preference_count;          // Number of preferred players
+    VolumeMethod volume_method;
 } LayoutConfig;
 
+// Parts of the config that differ between two snapshots (layout_config_diff)
+typedef enum {
+    LAYOUT_CHANGED_EDGE          = 1 << 0,  // edge, margin
+    LAYOUT_CHANGED_THEME         = 1 << 1,
+    LAYOUT_CHANGED_VISUALIZER    = 1 << 2,  // enabled, mode, analysis_rate
+    LAYOUT_CHANGED_IDLE          = 1 << 3,  // Idle timeouts, vertical display enabled
+    LAYOUT_CHANGED_NOTIFICATIONS = 1 << 4,
+    LAYOUT_CHANGED_VOLUME        = 1 << 5   // volume_method
+} LayoutChange;
+
+// Called on the main thread after a reload; `changes` is a LayoutChange mask
+typedef void (*LayoutConfigChangedFunc)(LayoutConfig *config, guint changes, gpointer user_data);
+
 typedef struct {
     GtkWidget *album_cover;
     GtkWidget *source_label;
@@ -41,12 +77,29 @@ typedef struct {
 } ExpandedWidgets;
 
 // Config management
+// Parse config.conf into a new snapshot (writes the default file if missing)
 LayoutConfig* layout_load_config(void);
-void layout_free_config(LayoutConfig *config);
+LayoutConfig* layout_config_ref(LayoutConfig *config);
+void layout_config_unref(LayoutConfig *config);
+
+// Shared snapshot, loaded on first use (borrowed; ref it to keep it across reloads)
+LayoutConfig* layout_get_config(void);
+
+// LayoutChange mask of what differs between two snapshots
+guint layout_config_diff(const LayoutConfig *old_config, const LayoutConfig *new_config);
+
+// Reload the shared snapshot whenever config.conf changes on disk.
+// The layout orientation is fixed for the process: an edge on the other
+// axis is kept at the running one until restart.
+void layout_watch_config(LayoutConfigChangedFunc func, gpointer user_data);
 
 // Window setup
 void layout_setup_window_anchors(GtkWindow *window, LayoutConfig *config);
 
+// Put the control bar and revealer in the order the edge needs
+void layout_order_main_container(LayoutConfig *config, GtkWidget *main_container,
+                                 GtkWidget *control_bar, GtkWidget *revealer);
+
 // UI construction
 GtkWidget* layout_create_control_bar(LayoutConfig *config,
                                       GtkWidget **prev_btn,
@@ -63,5 +116,6 @@ GtkWidget* layout_create_main_container(LayoutConfig *config,
 // Helper functions
 const gchar* layout_get_expand_icon(LayoutConfig *config, gboolean is_expanded);
 GtkRevealerTransitionType layout_get_transition_type(LayoutConfig *config);
+GtkRevealerTransitionType layout_get_window_transition_type(LayoutConfig *config);
 
 #endif // LAYOUT_H
@@ -0,0 +1,298 @@
+#include "loudness.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define LUFS_OFFSET (-0.691)
+#define RELATIVE_GATE (-10.0)
+
+static double energy_to_lufs(double energy) {
+    if (energy <= 0.0) return -HUGE_VAL;
+    return LUFS_OFFSET + 10.0 * log10(energy);
+}
+
+static double lufs_to_energy(double lufs) {
+    return pow(10.0, (lufs - LUFS_OFFSET) / 10.0);
+}
+
+static double linear_to_db(double linear) {
+    if (linear <= 0.0) return -HUGE_VAL;
+    return 20.0 * log10(linear);
+}
+
+// K-weighting for an arbitrary rate (BS.1770 filters re-derived from their
+// analog prototypes, so 44.1/88.2/176.4 kHz are as exact as 48 kHz)
+static void design_k_weighting(LoudnessMeter *meter, double rate) {
+    // Stage 1: high shelf (+4 dB above ~1.7 kHz, head acoustics)
+    double f0 = 1681.974450955533;
+    double gain = 3.999843853973347;
+    double q = 0.7071752369554196;
+    double k = tan(M_PI * f0 / rate);
+    double vh = pow(10.0, gain / 20.0);
+    double vb = pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+
+    meter->coef[0][0] = (vh + vb * k / q + k * k) / a0;
+    meter->coef[0][1] = 2.0 * (k * k - vh) / a0;
+    meter->coef[0][2] = (vh - vb * k / q + k * k) / a0;
+    meter->coef[0][3] = 2.0 * (k * k - 1.0) / a0;
+    meter->coef[0][4] = (1.0 - k / q + k * k) / a0;
+
+    // Stage 2: RLB high-pass (~38 Hz)
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+    k = tan(M_PI * f0 / rate);
+    a0 = 1.0 + k / q + k * k;
+
+    meter->coef[1][0] = 1.0;
+    meter->coef[1][1] = -2.0;
+    meter->coef[1][2] = 1.0;
+    meter->coef[1][3] = 2.0 * (k * k - 1.0) / a0;
+    meter->coef[1][4] = (1.0 - k / q + k * k) / a0;
+}
+
+// Windowed-sinc interpolator split into `factor` polyphase branches
+static void design_true_peak(LoudnessMeter *meter) {
+    uint32_t factor = meter->tp_factor;
+    uint32_t n_taps = factor * LOUDNESS_TP_TAPS;
+    double center = (n_taps - 1) / 2.0;
+
+    memset(meter->tp_coef, 0, sizeof(meter->tp_coef));
+    for (uint32_t p = 0; p < factor; p++) {
+        double sum = 0.0;
+        for (uint32_t t = 0; t < LOUDNESS_TP_TAPS; t++) {
+            uint32_t n = t * factor + p;
+            double x = (n - center) / factor;
+            double sinc = fabs(x) < 1e-12 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+            double w = 2.0 * M_PI * n / (n_taps - 1);
+            double blackman = 0.42 - 0.5 * cos(w) + 0.08 * cos(2.0 * w);
+            meter->tp_coef[p][t] = sinc * blackman;
+            sum += meter->tp_coef[p][t];
+        }
+        // Unity DC gain per branch
+        for (uint32_t t = 0; t < LOUDNESS_TP_TAPS; t++) {
+            meter->tp_coef[p][t] /= sum;
+        }
+    }
+}
+
+static void clear_history(LoudnessMeter *meter) {
+    memset(meter->z1, 0, sizeof(meter->z1));
+    memset(meter->z2, 0, sizeof(meter->z2));
+    memset(meter->energy, 0, sizeof(meter->energy));
+    memset(meter->sub_energy, 0, sizeof(meter->sub_energy));
+    memset(meter->histogram, 0, sizeof(meter->histogram));
+    memset(meter->tp_history, 0, sizeof(meter->tp_history));
+    memset(meter->tp_block, 0, sizeof(meter->tp_block));
+    meter->sub_pos = 0;
+    meter->sub_index = 0;
+    meter->sub_count = 0;
+    meter->tp_pos = 0;
+    meter->tp_max = 0.0;
+    meter->tp_current = 0.0;
+}
+
+void loudness_init(LoudnessMeter *meter) {
+    memset(meter, 0, sizeof(*meter));
+}
+
+void loudness_configure(LoudnessMeter *meter, uint32_t rate, uint32_t channels) {
+    if (channels > LOUDNESS_MAX_CHANNELS) channels = LOUDNESS_MAX_CHANNELS;
+
+    meter->rate = rate;
+    meter->channels = channels;
+    if (rate == 0 || channels == 0) {
+        meter->rate = 0;
+        return;
+    }
+
+    design_k_weighting(meter, rate);
+
+    for (uint32_t c = 0; c < LOUDNESS_MAX_CHANNELS; c++) {
+        meter->weight[c / 4][c % 4] = c < channels ? 1.0 : 0.0;
+    }
+
+    meter->sub_len = rate / 10;
+    if (meter->sub_len == 0) meter->sub_len = 1;
+
+    // Oversample to at least ~192 kHz; above that the sample peak is close enough
+    meter->tp_factor = rate <= 48000 ? 4 : rate <= 96000 ? 2 : 1;
+    design_true_peak(meter);
+
+    clear_history(meter);
+}
+
+void loudness_set_channel_weight(LoudnessMeter *meter, uint32_t channel, double weight) {
+    if (channel >= meter->channels) return;
+    meter->weight[channel / 4][channel % 4] = weight;
+}
+
+void loudness_reset(LoudnessMeter *meter) {
+    clear_history(meter);
+}
+
+static void end_sub_block(LoudnessMeter *meter) {
+    double energy = 0.0;
+    for (int v = 0; v < LOUDNESS_VECS; v++) {
+        for (int lane = 0; lane < 4; lane++) {
+            energy += meter->energy[v][lane];
+        }
+    }
+    memset(meter->energy, 0, sizeof(meter->energy));
+
+    meter->sub_energy[meter->sub_index] = energy / meter->sub_len;
+    meter->tp_block[meter->sub_index % 4] = meter->tp_current;
+    meter->tp_current = 0.0;
+    meter->sub_index = (meter->sub_index + 1) % LOUDNESS_SHORT_TERM_BLOCKS;
+    if (meter->sub_count < LOUDNESS_SHORT_TERM_BLOCKS) meter->sub_count++;
+
+    // Every 100 ms a full 400 ms block (75% overlap) enters the gated histogram
+    if (meter->sub_count >= 4) {
+        double block = 0.0;
+        for (uint32_t i = 1; i <= 4; i++) {
+            block += meter->sub_energy[(meter->sub_index + LOUDNESS_SHORT_TERM_BLOCKS - i) %
+                                       LOUDNESS_SHORT_TERM_BLOCKS];
+        }
+        double lufs = energy_to_lufs(block / 4.0);
+        if (lufs >= LOUDNESS_HIST_MIN) {
+            int bin = (int)((lufs - LOUDNESS_HIST_MIN) / LOUDNESS_HIST_STEP);
+            if (bin >= LOUDNESS_HIST_BINS) bin = LOUDNESS_HIST_BINS - 1;
+            meter->histogram[bin]++;
+        }
+    }
+}
+
+static inline double dot_taps(const double *a, const double *b) {
+    loudness_v4df acc = { 0.0, 0.0, 0.0, 0.0 };
+    for (int i = 0; i < LOUDNESS_TP_TAPS; i += 4) {
+        loudness_v4df va, vb;
+        memcpy(&va, a + i, sizeof(va));
+        memcpy(&vb, b + i, sizeof(vb));
+        acc += va * vb;
+    }
+    return acc[0] + acc[1] + acc[2] + acc[3];
+}
+
+void loudness_process(LoudnessMeter *meter, const float *samples, size_t n_frames, uint32_t stride) {
+    if (meter->rate == 0 || n_frames == 0) return;
+
+    const uint32_t channels = meter->channels;
+    const int n_vecs = (int)(channels + 3) / 4;
+    const double *s0 = meter->coef[0];
+    const double *s1 = meter->coef[1];
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * stride;
+
+        // K-weighting, four channels per vector
+        loudness_v4df x[LOUDNESS_VECS];
+        memset(x, 0, sizeof(x));
+        for (uint32_t c = 0; c < channels; c++) {
+            x[c / 4][c % 4] = frame[c];
+        }
+        for (int v = 0; v < n_vecs; v++) {
+            loudness_v4df y = s0[0] * x[v] + meter->z1[0][v];
+            meter->z1[0][v] = s0[1] * x[v] - s0[3] * y + meter->z2[0][v];
+            meter->z2[0][v] = s0[2] * x[v] - s0[4] * y;
+
+            loudness_v4df k = s1[0] * y + meter->z1[1][v];
+            meter->z1[1][v] = s1[1] * y - s1[3] * k + meter->z2[1][v];
+            meter->z2[1][v] = s1[2] * y - s1[4] * k;
+
+            meter->energy[v] += meter->weight[v] * k * k;
+        }
+
+        // True-peak
+        if (meter->tp_factor > 1) {
+            meter->tp_pos = (meter->tp_pos + LOUDNESS_TP_TAPS - 1) % LOUDNESS_TP_TAPS;
+            for (uint32_t c = 0; c < channels; c++) {
+                double *hist = meter->tp_history[c];
+                hist[meter->tp_pos] = frame[c];
+                hist[meter->tp_pos + LOUDNESS_TP_TAPS] = frame[c];
+                for (uint32_t p = 0; p < meter->tp_factor; p++) {
+                    double peak = fabs(dot_taps(meter->tp_coef[p], hist + meter->tp_pos));
+                    if (peak > meter->tp_current) meter->tp_current = peak;
+                }
+            }
+        } else {
+            for (uint32_t c = 0; c < channels; c++) {
+                double peak = fabs(frame[c]);
+                if (peak > meter->tp_current) meter->tp_current = peak;
+            }
+        }
+        if (meter->tp_current > meter->tp_max) meter->tp_max = meter->tp_current;
+
+        if (++meter->sub_pos >= meter->sub_len) {
+            meter->sub_pos = 0;
+            end_sub_block(meter);
+        }
+    }
+
+    // Keep decaying filter state out of the denormal range during silence
+    for (int stage = 0; stage < 2; stage++) {
+        for (int v = 0; v < n_vecs; v++) {
+            for (int lane = 0; lane < 4; lane++) {
+                if (fabs(meter->z1[stage][v][lane]) < 1e-30) meter->z1[stage][v][lane] = 0.0;
+                if (fabs(meter->z2[stage][v][lane]) < 1e-30) meter->z2[stage][v][lane] = 0.0;
+            }
+        }
+    }
+}
+
+static double mean_recent(const LoudnessMeter *meter, uint32_t n) {
+    if (n > meter->sub_count) n = meter->sub_count;
+    if (n == 0) return 0.0;
+
+    double sum = 0.0;
+    for (uint32_t i = 1; i <= n; i++) {
+        sum += meter->sub_energy[(meter->sub_index + LOUDNESS_SHORT_TERM_BLOCKS - i) %
+                                 LOUDNESS_SHORT_TERM_BLOCKS];
+    }
+    return sum / n;
+}
+
+// Two-pass gating over the histogram: absolute gate (-70 LUFS) is implied by
+// the histogram range, the relative gate is 10 LU below the ungated mean
+static double integrated_lufs(const LoudnessMeter *meter) {
+    double sum = 0.0;
+    uint64_t count = 0;
+    for (int b = 0; b < LOUDNESS_HIST_BINS; b++) {
+        if (meter->histogram[b] == 0) continue;
+        double center = LOUDNESS_HIST_MIN + (b + 0.5) * LOUDNESS_HIST_STEP;
+        sum += meter->histogram[b] * lufs_to_energy(center);
+        count += meter->histogram[b];
+    }
+    if (count == 0) return -HUGE_VAL;
+
+    double gate = energy_to_lufs(sum / count) + RELATIVE_GATE;
+    int first = (int)ceil((gate - LOUDNESS_HIST_MIN) / LOUDNESS_HIST_STEP - 0.5);
+    if (first < 0) first = 0;
+
+    sum = 0.0;
+    count = 0;
+    for (int b = first; b < LOUDNESS_HIST_BINS; b++) {
+        if (meter->histogram[b] == 0) continue;
+        double center = LOUDNESS_HIST_MIN + (b + 0.5) * LOUDNESS_HIST_STEP;
+        sum += meter->histogram[b] * lufs_to_energy(center);
+        count += meter->histogram[b];
+    }
+    return count > 0 ? energy_to_lufs(sum / count) : -HUGE_VAL;
+}
+
+void loudness_get_readings(const LoudnessMeter *meter, LoudnessReadings *out) {
+    out->momentary = meter->sub_count >= 4 ? energy_to_lufs(mean_recent(meter, 4)) : -HUGE_VAL;
+    out->short_term = meter->sub_count > 0
+                          ? energy_to_lufs(mean_recent(meter, LOUDNESS_SHORT_TERM_BLOCKS))
+                          : -HUGE_VAL;
+    out->integrated = integrated_lufs(meter);
+
+    double tp_recent = meter->tp_current;
+    for (int i = 0; i < 4; i++) {
+        if (meter->tp_block[i] > tp_recent) tp_recent = meter->tp_block[i];
+    }
+    out->true_peak = linear_to_db(meter->tp_max);
+    out->true_peak_momentary = linear_to_db(tp_recent);
+}
@@ -0,0 +1,92 @@
+#ifndef LOUDNESS_H
+#define LOUDNESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Loudness Meter (EBU R128 / ITU-R BS.1770)
+ *
+ * Incremental K-weighted loudness and true-peak measurement:
+ *   - momentary (400 ms), short-term (3 s) and gated integrated LUFS
+ *   - true-peak per channel via polyphase oversampling
+ *
+ * Input is interleaved F32 at the stream's native rate. The K-weighting
+ * biquads run all channels in parallel using GCC vector extensions, and
+ * integrated loudness is kept as a fixed histogram of 100 ms-stepped 400 ms
+ * blocks, so memory is constant however long a track plays.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define LOUDNESS_MAX_CHANNELS 8
+#define LOUDNESS_SHORT_TERM_BLOCKS 30      // 3 s of 100 ms sub-blocks
+#define LOUDNESS_HIST_MIN (-70.0)          // Absolute gate (LUFS)
+#define LOUDNESS_HIST_MAX 10.0
+#define LOUDNESS_HIST_STEP 0.1
+#define LOUDNESS_HIST_BINS 800
+#define LOUDNESS_TP_TAPS 12                // Taps per polyphase branch
+#define LOUDNESS_TP_MAX_FACTOR 4
+
+typedef double loudness_v4df __attribute__((vector_size(32)));
+
+#define LOUDNESS_VECS (LOUDNESS_MAX_CHANNELS / 4)
+
+typedef struct {
+    double momentary;             // LUFS, -HUGE_VAL when silent
+    double short_term;            // LUFS
+    double integrated;            // LUFS (gated)
+    double true_peak;             // dBTP, highest channel, since last reset
+    double true_peak_momentary;   // dBTP, highest channel in the last 400 ms
+} LoudnessReadings;
+
+typedef struct {
+    uint32_t rate;
+    uint32_t channels;
+
+    // K-weighting: pre-filter (high shelf) then RLB high-pass, channels in lanes
+    double coef[2][5];            // b0, b1, b2, a1, a2 per stage
+    loudness_v4df z1[2][LOUDNESS_VECS];
+    loudness_v4df z2[2][LOUDNESS_VECS];
+    loudness_v4df weight[LOUDNESS_VECS];   // BS.1770 channel weights (0 for LFE)
+    loudness_v4df energy[LOUDNESS_VECS];   // Current 100 ms sub-block
+
+    // 100 ms sub-blocks
+    uint32_t sub_len;
+    uint32_t sub_pos;
+    double sub_energy[LOUDNESS_SHORT_TERM_BLOCKS];
+    uint32_t sub_index;
+    uint32_t sub_count;
+
+    // Gated integration
+    uint32_t histogram[LOUDNESS_HIST_BINS];
+
+    // True-peak: polyphase interpolator with doubled history per channel
+    uint32_t tp_factor;           // 4x up to 48 kHz, 2x to 96 kHz, 1x above
+    double tp_coef[LOUDNESS_TP_MAX_FACTOR][LOUDNESS_TP_TAPS];
+    double tp_history[LOUDNESS_MAX_CHANNELS][LOUDNESS_TP_TAPS * 2];
+    uint32_t tp_pos;
+    double tp_max;                // Linear, since reset
+    double tp_current;            // Linear, current sub-block
+    double tp_block[4];           // Linear, previous sub-blocks of the momentary window
+} LoudnessMeter;
+
+// Zero all state; the meter ignores input until loudness_configure()
+void loudness_init(LoudnessMeter *meter);
+
+// Apply a negotiated format (filters are designed for the exact rate)
+void loudness_configure(LoudnessMeter *meter, uint32_t rate, uint32_t channels);
+
+// Override a channel's BS.1770 weight (default 1.0; 0 for LFE, 1.41 for surrounds)
+void loudness_set_channel_weight(LoudnessMeter *meter, uint32_t channel, double weight);
+
+// Clear all measurements and filter history (format is kept)
+void loudness_reset(LoudnessMeter *meter);
+
+// Feed interleaved F32 frames with `stride` floats per frame (>= channels)
+void loudness_process(LoudnessMeter *meter, const float *samples, size_t n_frames, uint32_t stride);
+
+// Current readings
+void loudness_get_readings(const LoudnessMeter *meter, LoudnessReadings *out);
+
+#endif // LOUDNESS_H
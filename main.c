@@ -13,10 +13,37 @@
 #include "visualizer.h"
 #include "pipewire_volume.h"
 #include "vertical_display.h"
+#include "ipc.h"
+#include "animation.h"
+#include "transform_bin.h"
+#include "icon_cache.h"
+
+#define BUTTON_FADE_MS 320
+#define BAR_MORPH_MS 300
+
+// Track changes settle this long before "Now Playing" is shown, so a burst
+// of skips only announces where it ended up
+#define NOTIFICATION_SETTLE_MS 300
+// Give up on metadata that has not completed this long after the change
+#define NOTIFICATION_METADATA_WAIT_MS 2000
+
+// Announcement for one player's latest track, filled in as metadata trickles in
+typedef struct {
+    gchar *player;                     // Bus name the track change came from
+    gchar *track_id;
+    gchar *title;
+    gchar *artist;
+    gchar *art_url;
+    gint64 changed_at;                 // Monotonic time of the last track change
+    guint settle_timer;                // Running until the changes settle
+    guint deadline_timer;              // Settled but incomplete: gives up on the metadata
+} PendingNotification;
 
 typedef struct {
     GtkWidget *window;
     GtkWidget *window_revealer;
+    GtkWidget *main_container;
+    GtkWidget *control_widget;         // Control bar (or its vertical display overlay)
     GtkWidget *revealer;
     GtkWidget *play_icon;
     GtkWidget *expand_icon;
@@ -36,7 +63,7 @@ typedef struct {
     gboolean can_seek;                 // Hi-Fi: True if player supports seeking
     GDBusProxy *mpris_proxy;
     gchar *current_player;
-    guint update_timer;
+    guint position_ticker;             // MPRIS Position poll while playing and on screen
     LayoutConfig *layout;
     NotificationState *notification;
     VolumeState *volume;
@@ -44,11 +71,10 @@ typedef struct {
     gchar *last_title;                 // Hi-Fi: Fallback for track change detection
     gchar *current_track_id;           // Hi-Fi: For seek operations
     gint64 current_length;             // Hi-Fi: Track length in microseconds
-    guint notification_timer;
-    gchar *pending_title;
-    gchar *pending_artist;
-    gchar *pending_art_url;
+    PendingNotification *pending_notification;  // Track change waiting to settle
     GtkWidget *control_bar_container;
+    GtkWidget *control_bar_bin;        // Morphs the bar between idle and full size
+    guint resize_animation;
     GtkWidget *prev_btn;
     GtkWidget *play_btn;
     GtkWidget *next_btn;
@@ -65,8 +91,9 @@ typedef struct {
     VerticalDisplayState *vertical_display;  // For vertical layouts
     guint idle_timer;
     gboolean is_idle_mode;
-    guint morph_timer;
+    guint morph_animation;
     gdouble button_fade_opacity;
+    gdouble button_fade_from;          // Opacity the running fade started at
 
     // Player monitoring
     guint dbus_watch_id;               // D-Bus name watcher
@@ -79,6 +106,9 @@ static void update_playback_status(AppState *state);
 static void on_expand_clicked(GtkButton *button, gpointer user_data);
 static void on_properties_changed(GDBusProxy *proxy, GVariant *changed_properties,
                                   GStrv invalidated_properties, gpointer user_data);
+static void on_player_signal(GDBusProxy *proxy, const gchar *sender_name,
+                             const gchar *signal_name, GVariant *parameters,
+                             gpointer user_data);
 
 // Visualizer control (for expanded section)
 static void start_visualizer_if_expanded(AppState *state);
@@ -93,7 +123,6 @@ static void save_preferred_player(const gchar *bus_name);
 static void exit_idle_mode(AppState *state);
 static void reset_idle_timer(AppState *state);
 static gboolean enter_idle_mode(gpointer user_data);
-static gboolean delayed_control_bar_resize(gpointer user_data);
 static gboolean enter_vertical_idle_mode(gpointer user_data);
 static void exit_vertical_idle_mode(AppState *state);
 static void find_active_player(AppState *state);
@@ -306,6 +335,8 @@ static void switch_to_player(AppState *state, const gchar *bus_name) {
 
     g_signal_connect(state->mpris_proxy, "g-properties-changed",
                      G_CALLBACK(on_properties_changed), state);
+    g_signal_connect(state->mpris_proxy, "g-signal",
+                     G_CALLBACK(on_player_signal), state);
 
     // Get display name from Identity
     GDBusProxy *player_proxy = g_dbus_proxy_new_for_bus_sync(
@@ -414,15 +445,6 @@ static void on_revealer_transition_done(GObject *revealer_obj, GParamSpec *pspec
     }
 }
 
-static gboolean delayed_visualizer_show(gpointer user_data) {
-    AppState *state = (AppState *)user_data;
-    
-    // NOW show visualizer after bar has shrunk
-    visualizer_show(state->visualizer);
-    
-    return G_SOURCE_REMOVE;
-}
-
 static void on_window_hide_complete(GObject *revealer, GParamSpec *pspec, gpointer user_data) {
     AppState *state = (AppState *)user_data;
     if (!gtk_revealer_get_child_revealed(GTK_REVEALER(state->window_revealer))) {
@@ -430,6 +452,22 @@ static void on_window_hide_complete(GObject *revealer, GParamSpec *pspec, gpoint
     }
 }
 
+// Hi-Fi: D-Bus GetSignalPath / GetLatencyStats / GetRtHealth
+static gchar* ipc_signal_path(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    return state->visualizer ? visualizer_get_signal_path(state->visualizer) : NULL;
+}
+
+static gchar* ipc_latency_stats(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    return state->visualizer ? visualizer_get_latency_stats(state->visualizer) : NULL;
+}
+
+static gchar* ipc_rt_health(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    return state->visualizer ? visualizer_get_rt_health(state->visualizer) : NULL;
+}
+
 static gboolean handle_sigusr1(gpointer user_data) {
     if (!global_state) return G_SOURCE_CONTINUE;
     global_state->is_visible = !global_state->is_visible;
@@ -513,10 +551,8 @@ static gboolean handle_sigusr2(gpointer user_data) {
         }
 
         // Update expand icon and revealer
-        const gchar *icon_name = layout_get_expand_icon(global_state->layout, global_state->is_expanded);
-        gchar *icon_path = get_icon_path(icon_name);
-        gtk_image_set_from_file(GTK_IMAGE(global_state->expand_icon), icon_path);
-        free_path(icon_path);
+        icon_cache_set_image(global_state->expand_icon,
+                             layout_get_expand_icon(global_state->layout, global_state->is_expanded));
         gtk_revealer_set_reveal_child(GTK_REVEALER(global_state->revealer), global_state->is_expanded);
 
         return G_SOURCE_CONTINUE;
@@ -561,62 +597,95 @@ static void stop_visualizer_if_collapsed(AppState *state) {
     // Keep audio capture running for quick resume
 }
 
-// Helper function for delayed resize (horizontal idle mode)
-static gboolean delayed_control_bar_resize(gpointer user_data) {
+static void bar_morph_step(gdouble progress, gpointer user_data) {
     AppState *state = (AppState *)user_data;
-    gtk_widget_set_size_request(state->control_bar_container, 280, 32);
-    gtk_widget_queue_resize(state->control_bar_container);
-    g_print("  Size request set to: 280x32 (after button fade)\n");
-    return G_SOURCE_REMOVE;
+    transform_bin_set_progress(TRANSFORM_BIN(state->control_bar_bin), progress);
 }
 
-// Button fade animation for idle mode transitions
-static gboolean animate_button_fade(gpointer user_data) {
+static void bar_morph_done(gpointer user_data) {
     AppState *state = (AppState *)user_data;
+    state->resize_animation = 0;
+    transform_bin_end_morph(TRANSFORM_BIN(state->control_bar_bin));
 
-    if (state->is_idle_mode) {
-        // Fade out buttons
-        state->button_fade_opacity -= 0.05;
-        if (state->button_fade_opacity <= 0.0) {
-            state->button_fade_opacity = 0.0;
-
-            // CRITICAL: Actually HIDE the buttons so they don't block resize
-            gtk_widget_set_visible(state->prev_btn, FALSE);
-            gtk_widget_set_visible(state->play_btn, FALSE);
-            gtk_widget_set_visible(state->next_btn, FALSE);
-            gtk_widget_set_visible(state->expand_btn, FALSE);
+    // Show visualizer AFTER bar finishes resizing (horizontal idle mode)
+    if (state->is_idle_mode && !state->layout->is_vertical && state->visualizer) {
+        visualizer_show(state->visualizer);
+    }
+}
 
-            g_print("  Buttons hidden - bar can now shrink\n");
+// Resize the control bar as a transform inside a stable surface: the layer
+// surface is configured at the start and end instead of on every step
+static void morph_control_bar(AppState *state, gint width, gint height) {
+    animation_clear(&state->resize_animation);
+    transform_bin_begin_morph(TRANSFORM_BIN(state->control_bar_bin));
+    gtk_widget_set_size_request(state->control_bar_container, width, height);
+    state->resize_animation = animation_start(state->control_bar_bin, BAR_MORPH_MS,
+                                              animation_ease_in_out_cubic,
+                                              bar_morph_step, bar_morph_done, state);
+}
 
-            state->morph_timer = 0;
-            return G_SOURCE_REMOVE;
-        }
+// Shrink the bar once the buttons have faded out (idle mode)
+static void shrink_control_bar(AppState *state) {
+    if (state->layout->is_vertical) {
+        // Make it slimmer (from 70x240 to 32x280)
+        g_print("  Vertical bar morphing to: 32x280 (slim mode)\n");
+        morph_control_bar(state, 32, 280);
     } else {
-        // Make buttons visible first if they were hidden
-        if (state->button_fade_opacity == 0.0) {
-            gtk_widget_set_visible(state->prev_btn, TRUE);
-            gtk_widget_set_visible(state->play_btn, TRUE);
-            gtk_widget_set_visible(state->next_btn, TRUE);
-            gtk_widget_set_visible(state->expand_btn, TRUE);
-            g_print("  Buttons visible again\n");
-        }
+        g_print("  Bar morphing to: 280x32 (after button fade)\n");
+        morph_control_bar(state, 280, 32);
+    }
+}
 
-        // Fade in buttons
-        state->button_fade_opacity += 0.05;
-        if (state->button_fade_opacity >= 1.0) {
-            state->button_fade_opacity = 1.0;
-            state->morph_timer = 0;
-            return G_SOURCE_REMOVE;
-        }
+// Button fade animation for idle mode transitions
+static void set_button_opacity(AppState *state, gdouble opacity) {
+    gtk_widget_set_opacity(state->prev_btn, opacity);
+    gtk_widget_set_opacity(state->play_btn, opacity);
+    gtk_widget_set_opacity(state->next_btn, opacity);
+    gtk_widget_set_opacity(state->expand_btn, opacity);
+}
+
+static void button_fade_step(gdouble progress, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    gdouble target = state->is_idle_mode ? 0.0 : 1.0;
+
+    state->button_fade_opacity = state->button_fade_from + (target - state->button_fade_from) * progress;
+    set_button_opacity(state, state->button_fade_opacity);
+}
+
+static void button_fade_done(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    state->morph_animation = 0;
+
+    if (state->is_idle_mode) {
+        // CRITICAL: Actually HIDE the buttons so they don't block resize
+        gtk_widget_set_visible(state->prev_btn, FALSE);
+        gtk_widget_set_visible(state->play_btn, FALSE);
+        gtk_widget_set_visible(state->next_btn, FALSE);
+        gtk_widget_set_visible(state->expand_btn, FALSE);
+
+        g_print("  Buttons hidden - bar can now shrink\n");
+        shrink_control_bar(state);
     }
+}
 
-    // Apply opacity to all buttons
-    gtk_widget_set_opacity(state->prev_btn, state->button_fade_opacity);
-    gtk_widget_set_opacity(state->play_btn, state->button_fade_opacity);
-    gtk_widget_set_opacity(state->next_btn, state->button_fade_opacity);
-    gtk_widget_set_opacity(state->expand_btn, state->button_fade_opacity);
+// Fade the buttons out (idle mode) or back in from wherever they are now
+static void start_button_fade(AppState *state) {
+    animation_clear(&state->morph_animation);
 
-    return G_SOURCE_CONTINUE;
+    // Make buttons visible first if they were hidden
+    if (!state->is_idle_mode && !gtk_widget_get_visible(state->prev_btn)) {
+        gtk_widget_set_visible(state->prev_btn, TRUE);
+        gtk_widget_set_visible(state->play_btn, TRUE);
+        gtk_widget_set_visible(state->next_btn, TRUE);
+        gtk_widget_set_visible(state->expand_btn, TRUE);
+        g_print("  Buttons visible again\n");
+    }
+
+    gdouble target = state->is_idle_mode ? 0.0 : 1.0;
+    state->button_fade_from = state->button_fade_opacity;
+    guint duration = (guint)(BUTTON_FADE_MS * ABS(target - state->button_fade_from));
+    state->morph_animation = animation_start(state->control_bar_container, duration, NULL,
+                                             button_fade_step, button_fade_done, state);
 }
 
 // Enter idle mode - morph to visualizer (horizontal layout)
@@ -632,10 +701,7 @@ static gboolean enter_idle_mode(gpointer user_data) {
     g_print("→ Entering horizontal idle mode - showing visualizer\n");
 
     // Hide buttons with fade animation
-    if (state->morph_timer > 0) {
-        g_source_remove(state->morph_timer);
-    }
-    state->morph_timer = g_timeout_add(16, animate_button_fade, state);
+    start_button_fade(state);
 
     // Start audio capture
     if (!state->visualizer->is_running) {
@@ -643,11 +709,8 @@ static gboolean enter_idle_mode(gpointer user_data) {
         g_print("✓ Visualizer started (idle mode)\n");
     }
 
-    // Step 1: Resize bar after buttons fade (350ms)
-    g_timeout_add(350, delayed_control_bar_resize, state);
-
-    // Step 2: Show visualizer AFTER bar finishes resizing (700ms)
-    g_timeout_add(700, delayed_visualizer_show, state);
+    // Step 1: The bar shrinks when the button fade ends (button_fade_done)
+    // Step 2: The visualizer shows when the bar morph ends (bar_morph_done)
 
     state->idle_timer = 0;
     return G_SOURCE_REMOVE;
@@ -661,19 +724,14 @@ static void exit_idle_mode(AppState *state) {
     state->is_idle_mode = FALSE;
 
     // Restore control bar size: 280x32 → 240x60
-    gtk_widget_set_size_request(state->control_bar_container, 240, 60);
-    gtk_widget_queue_resize(state->control_bar_container);
-    gtk_widget_queue_allocate(state->control_bar_container);
-    g_print("  Size request set to: 240x60\n");
+    morph_control_bar(state, 240, 60);
+    g_print("  Bar morphing to: 240x60\n");
 
     // Hide visualizer
     visualizer_hide(state->visualizer);
 
     // Start button fade-in animation
-    if (state->morph_timer > 0) {
-        g_source_remove(state->morph_timer);
-    }
-    state->morph_timer = g_timeout_add(16, animate_button_fade, state);
+    start_button_fade(state);
 
     // Restart idle timer
     if (state->is_visible && !state->is_expanded && !state->layout->is_vertical &&
@@ -684,15 +742,6 @@ static void exit_idle_mode(AppState *state) {
     }
 }
 
-static gboolean delayed_control_bar_resize_vertical(gpointer user_data) {
-    AppState *state = (AppState *)user_data;
-    // Make it slimmer (from 70x240 to 32x280)
-    gtk_widget_set_size_request(state->control_bar_container, 32, 280);
-    gtk_widget_queue_resize(state->control_bar_container);
-    g_print("  Vertical bar resized to: 32x280 (slim mode)\n");
-    return G_SOURCE_REMOVE;
-}
-
 // Vertical display idle mode functions
 static gboolean enter_vertical_idle_mode(gpointer user_data) {
     AppState *state = (AppState *)user_data;
@@ -712,16 +761,12 @@ static gboolean enter_vertical_idle_mode(gpointer user_data) {
     }
     
     // Start button fade-out animation
-    if (state->morph_timer > 0) {
-        g_source_remove(state->morph_timer);
-    }
-    state->morph_timer = g_timeout_add(16, animate_button_fade, state);
+    start_button_fade(state);
     
     // Show vertical display
     vertical_display_show(state->vertical_display);
     
-    // Resize control bar to slim version (same as horizontal idle mode)
-    g_timeout_add(350, delayed_control_bar_resize_vertical, state);
+    // Control bar shrinks to the slim version when the button fade ends
     
     state->idle_timer = 0;
     return G_SOURCE_REMOVE;
@@ -734,17 +779,13 @@ static void exit_vertical_idle_mode(AppState *state) {
     state->is_idle_mode = FALSE;
     
     // Restore control bar size
-    gtk_widget_set_size_request(state->control_bar_container, 70, 240);
-    gtk_widget_queue_resize(state->control_bar_container);
+    morph_control_bar(state, 70, 240);
     
     // Hide vertical display
     vertical_display_hide(state->vertical_display);
     
     // Start button fade-in animation
-    if (state->morph_timer > 0) {
-        g_source_remove(state->morph_timer);
-    }
-    state->morph_timer = g_timeout_add(16, animate_button_fade, state);
+    start_button_fade(state);
     
     // Restart idle timer
     if (state->is_visible && !state->is_expanded && state->layout->is_vertical && 
@@ -815,6 +856,26 @@ static gboolean update_position_tick(gpointer user_data) {
     return G_SOURCE_CONTINUE;
 }
 
+// Position only moves on its own while playing. Paused or stopped it changes
+// through Seeked or a status change, which fetch it once instead.
+static void sync_position_ticker(AppState *state) {
+    gboolean wanted = state->is_playing && state->mpris_proxy;
+
+    if (wanted && state->position_ticker == 0) {
+        state->position_ticker = animation_add_ticker(state->window, 1000, update_position_tick, state);
+    } else if (!wanted) {
+        animation_clear(&state->position_ticker);
+    }
+}
+
+static void on_player_signal(GDBusProxy *proxy, const gchar *sender_name,
+                             const gchar *signal_name, GVariant *parameters,
+                             gpointer user_data) {
+    if (g_strcmp0(signal_name, "Seeked") == 0) {
+        update_position((AppState *)user_data);
+    }
+}
+
 static gboolean clear_seeking_flag(gpointer user_data) {
     AppState *state = (AppState *)user_data;
     state->is_seeking = FALSE;
@@ -984,39 +1045,128 @@ static void update_position(AppState *state) {
 
 }
 
-static gint notification_retry_count = 0;
-#define MAX_NOTIFICATION_RETRIES 5
+// ========================================
+// NOTIFICATION SCHEDULING
+// ========================================
 
-static gboolean show_pending_notification(gpointer user_data) {
-    AppState *state = (AppState *)user_data;
-    gboolean has_title = state->pending_title && strlen(state->pending_title) > 0;
-    gboolean has_artist = state->pending_artist && strlen(state->pending_artist) > 0;
+static void drop_pending_notification(AppState *state) {
+    PendingNotification *pending = state->pending_notification;
+    if (!pending) return;
+
+    if (pending->settle_timer > 0) {
+        g_source_remove(pending->settle_timer);
+    }
+    if (pending->deadline_timer > 0) {
+        g_source_remove(pending->deadline_timer);
+    }
+    g_free(pending->player);
+    g_free(pending->track_id);
+    g_free(pending->title);
+    g_free(pending->artist);
+    g_free(pending->art_url);
+    g_free(pending);
+    state->pending_notification = NULL;
+}
+
+static gboolean on_notification_deadline(gpointer user_data);
 
+// Show the pending notification once settled and complete
+static void try_show_pending_notification(AppState *state) {
+    PendingNotification *pending = state->pending_notification;
+    if (!pending || pending->settle_timer > 0) return;
+
+    if (!state->layout->notifications_enabled || !state->layout->now_playing_enabled ||
+        g_strcmp0(pending->player, state->current_player) != 0) {
+        drop_pending_notification(state);
+        return;
+    }
+
+    gboolean has_title = pending->title && strlen(pending->title) > 0;
+    gboolean has_artist = pending->artist && strlen(pending->artist) > 0;
     if (!has_title || !has_artist) {
-        notification_retry_count++;
-        if (notification_retry_count < MAX_NOTIFICATION_RETRIES) {
-            state->notification_timer = g_timeout_add(200, show_pending_notification, state);
-            return G_SOURCE_REMOVE;
+        // The rest arrives through on_properties_changed(); if it does not,
+        // the deadline decides
+        if (pending->deadline_timer > 0) return;
+
+        gint64 remaining = (gint64)NOTIFICATION_METADATA_WAIT_MS * 1000 -
+                           (g_get_monotonic_time() - pending->changed_at);
+        if (remaining <= 0) {
+            on_notification_deadline(state);
+        } else {
+            pending->deadline_timer = g_timeout_add((guint)(remaining / 1000) + 1,
+                                                    on_notification_deadline, state);
         }
-        g_print("Notification skipped - metadata incomplete\n");
+        return;
+    }
+
+    notification_show(state->notification, pending->title, pending->artist,
+                      pending->art_url, "Now Playing");
+    drop_pending_notification(state);
+}
+
+// Metadata is still incomplete after the wait: a title alone is enough
+// (streams often have no artist), otherwise there is nothing to announce
+static gboolean on_notification_deadline(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    PendingNotification *pending = state->pending_notification;
+
+    pending->deadline_timer = 0;
+    if (pending->title && strlen(pending->title) > 0) {
+        notification_show(state->notification, pending->title,
+                          pending->artist ? pending->artist : "", pending->art_url, "Now Playing");
     } else {
-        notification_show(state->notification, state->pending_title,
-                          state->pending_artist, state->pending_art_url, "Now Playing");
-    }
-
-    g_free(state->pending_title);
-    g_free(state->pending_artist);
-    g_free(state->pending_art_url);
-    state->pending_title = NULL;
-    state->pending_artist = NULL;
-    state->pending_art_url = NULL;
-    state->notification_timer = 0;
-    notification_retry_count = 0;
-    
-    
+        g_print("Notification skipped - metadata incomplete\n");
+    }
+    drop_pending_notification(state);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_notification_settled(gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    state->pending_notification->settle_timer = 0;
+    try_show_pending_notification(state);
     return G_SOURCE_REMOVE;
 }
 
+// Called for every metadata update: a track change replaces whatever is
+// pending and restarts the settle window; later updates for the same track
+// fill in what was missing
+static void schedule_track_notification(AppState *state, gboolean track_changed,
+                                        const gchar *track_id, const gchar *title,
+                                        const gchar *artist, const gchar *art_url) {
+    PendingNotification *pending = state->pending_notification;
+
+    if (track_changed) {
+        if (state->suppress_notification || !state->notification ||
+            !state->layout->notifications_enabled || !state->layout->now_playing_enabled) {
+            drop_pending_notification(state);
+            return;
+        }
+
+        // Only the newest change is announced; its window starts over
+        drop_pending_notification(state);
+
+        pending = g_new0(PendingNotification, 1);
+        pending->player = g_strdup(state->current_player);
+        pending->track_id = g_strdup(track_id);
+        pending->changed_at = g_get_monotonic_time();
+        state->pending_notification = pending;
+        pending->settle_timer = g_timeout_add(NOTIFICATION_SETTLE_MS, on_notification_settled, state);
+    } else if (!pending || g_strcmp0(pending->player, state->current_player) != 0 ||
+               g_strcmp0(pending->track_id, track_id) != 0) {
+        return;
+    }
+
+    g_free(pending->title);
+    g_free(pending->artist);
+    g_free(pending->art_url);
+    pending->title = g_strdup(title);
+    pending->artist = g_strdup(artist);
+    pending->art_url = g_strdup(art_url);
+
+    try_show_pending_notification(state);
+}
+
 static void update_metadata(AppState *state) {
     if (!state->mpris_proxy) return;
     GVariant *metadata = g_dbus_proxy_get_cached_property(state->mpris_proxy, "Metadata");
@@ -1068,25 +1218,10 @@ static void update_metadata(AppState *state) {
         g_free(state->last_track_id);
         state->last_track_id = g_strdup(track_id);
     }
-    
-    if (state->layout->notifications_enabled && state->layout->now_playing_enabled && 
-        state->notification && track_changed) {
-        if (state->notification_timer > 0) {
-            g_source_remove(state->notification_timer);
-            state->notification_timer = 0;
-        }
-        notification_retry_count = 0;
-        g_free(state->pending_title);
-        g_free(state->pending_artist);
-        g_free(state->pending_art_url);
-        state->pending_title = g_strdup(title);
-        state->pending_artist = g_strdup(artist);
-        state->pending_art_url = g_strdup(art_url);
-        if (state->notification->album_cover) {
-            clear_album_art_container(state->notification->album_cover);
-            load_album_art_to_container(art_url, state->notification->album_cover, 70);
-        }
-        state->notification_timer = g_timeout_add(300, show_pending_notification, state);
+
+    // Hi-Fi: Authenticity is judged per track
+    if (track_changed && state->visualizer) {
+        visualizer_track_changed(state->visualizer);
     }
     
     if (title && strlen(title) > 0) {
@@ -1101,7 +1236,10 @@ static void update_metadata(AppState *state) {
         gtk_label_set_text(GTK_LABEL(state->artist_label), "Unknown Artist");
     }
     
+    // Decodes into the shared art cache the notification draws from
     load_album_art_to_container(art_url, state->album_cover, 300);
+
+    schedule_track_notification(state, track_changed, track_id, title, artist, art_url);
     
     if (state->current_player) {
         GError *error = NULL;
@@ -1145,9 +1283,7 @@ static void update_playback_status(AppState *state) {
         gboolean was_playing = state->is_playing;
         state->is_playing = g_strcmp0(status, "Playing") == 0;
         
-        gchar *icon_path = get_icon_path(state->is_playing ? "pause.svg" : "play.svg");
-        gtk_image_set_from_file(GTK_IMAGE(state->play_icon), icon_path);
-        free_path(icon_path);
+        icon_cache_set_image(state->play_icon, state->is_playing ? "pause.svg" : "play.svg");
         
         // UPDATE VERTICAL DISPLAY
         if (state->vertical_display) {
@@ -1164,7 +1300,11 @@ static void update_playback_status(AppState *state) {
         if (state->is_playing && !was_playing && state->visualizer) {
             visualizer_retry_target(state->visualizer);
         }
+        if (state->is_playing != was_playing) {
+            update_position(state);
+        }
     }
+    sync_position_ticker(state);
 }
 
 static void on_properties_changed(GDBusProxy *proxy, GVariant *changed_properties,
@@ -1201,6 +1341,7 @@ static void on_player_name_changed(GDBusConnection *connection,
             }
             g_free(state->current_player);
             state->current_player = NULL;
+            sync_position_ticker(state);
             
             // Clear UI
             gtk_label_set_text(GTK_LABEL(state->track_title), "No Player");
@@ -1241,7 +1382,10 @@ static void connect_to_player(AppState *state, const gchar *bus_name) {
 
     g_signal_connect(state->mpris_proxy, "g-properties-changed",
                      G_CALLBACK(on_properties_changed), state);
+    g_signal_connect(state->mpris_proxy, "g-signal",
+                     G_CALLBACK(on_player_signal), state);
     update_metadata(state);
+    update_playback_status(state);
 
     if (state->volume) {
         volume_update_player(state->volume, state->mpris_proxy, bus_name);
@@ -1324,10 +1468,7 @@ static void on_expand_clicked(GtkButton *button, gpointer user_data) {
         volume_hide(state->volume);
     }
 
-    const gchar *icon_name = layout_get_expand_icon(state->layout, state->is_expanded);
-    gchar *icon_path = get_icon_path(icon_name);
-    gtk_image_set_from_file(GTK_IMAGE(state->expand_icon), icon_path);
-    free_path(icon_path);
+    icon_cache_set_image(state->expand_icon, layout_get_expand_icon(state->layout, state->is_expanded));
     gtk_revealer_set_reveal_child(GTK_REVEALER(state->revealer), state->is_expanded);
 
     // Start/stop visualizer based on expanded state
@@ -1371,6 +1512,42 @@ static void on_volume_visibility_changed(GObject *revealer, GParamSpec *pspec, g
     }
 }
 
+// Hi-Fi: Theme CSS sits between the base style and user.css. The provider is
+// kept so a config reload can swap themes without touching the others.
+static GtkCssProvider *theme_provider = NULL;
+
+static void load_theme_css(const gchar *theme) {
+    g_print("Theme from config: %s\n", theme);
+
+    if (theme_provider) {
+        gtk_style_context_remove_provider_for_display(gdk_display_get_default(),
+            GTK_STYLE_PROVIDER(theme_provider));
+        g_clear_object(&theme_provider);
+    }
+
+    gchar *theme_path = get_theme_path(theme);
+    if (!theme_path) return;
+
+    GFile *theme_file = g_file_new_for_path(theme_path);
+    GError *theme_error = NULL;
+    gchar *theme_contents = NULL;
+    gsize theme_length = 0;
+
+    if (g_file_load_contents(theme_file, NULL, &theme_contents, &theme_length, NULL, &theme_error)) {
+        theme_provider = gtk_css_provider_new();
+        gtk_css_provider_load_from_string(theme_provider, theme_contents);
+        gtk_style_context_add_provider_for_display(gdk_display_get_default(),
+            GTK_STYLE_PROVIDER(theme_provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
+        g_print("Theme CSS loaded: %s\n", theme_path);
+        g_free(theme_contents);
+    } else {
+        g_warning("Failed to load theme CSS: %s", theme_error ? theme_error->message : "Unknown");
+        if (theme_error) g_error_free(theme_error);
+    }
+    g_object_unref(theme_file);
+    free_path(theme_path);
+}
+
 static void load_css() {
     // 1. Load base style.css
     gchar *css_path = get_style_path();
@@ -1395,32 +1572,7 @@ static void load_css() {
     free_path(css_path);
 
     // 2. Hi-Fi: Load theme CSS if not using default "light" theme
-    gchar *theme = get_config_theme();
-    g_print("Theme from config: %s\n", theme);
-
-    gchar *theme_path = get_theme_path(theme);
-    if (theme_path) {
-        GtkCssProvider *theme_provider = gtk_css_provider_new();
-        GFile *theme_file = g_file_new_for_path(theme_path);
-        GError *theme_error = NULL;
-        gchar *theme_contents = NULL;
-        gsize theme_length = 0;
-
-        if (g_file_load_contents(theme_file, NULL, &theme_contents, &theme_length, NULL, &theme_error)) {
-            gtk_css_provider_load_from_string(theme_provider, theme_contents);
-            gtk_style_context_add_provider_for_display(gdk_display_get_default(),
-                GTK_STYLE_PROVIDER(theme_provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
-            g_print("Theme CSS loaded: %s\n", theme_path);
-            g_free(theme_contents);
-        } else {
-            g_warning("Failed to load theme CSS: %s", theme_error ? theme_error->message : "Unknown");
-            if (theme_error) g_error_free(theme_error);
-        }
-        g_object_unref(theme_file);
-        g_object_unref(theme_provider);
-        free_path(theme_path);
-    }
-    g_free(theme);
+    load_theme_css(layout_get_config()->theme);
 
     // 3. Hi-Fi: Load optional user CSS overrides
     gchar *user_css = g_build_filename(g_get_user_config_dir(), "hyprwave", "user.css", NULL);
@@ -1456,6 +1608,79 @@ static gboolean delayed_revealer_reveal(gpointer user_data) {
 }
 
 
+// ========================================
+// CONFIG RELOAD
+// ========================================
+
+// Apply a reloaded config.conf to the parts it changed. The edge only moves
+// within the running orientation (layout.c keeps it otherwise).
+static void on_config_changed(LayoutConfig *config, guint changes, gpointer user_data) {
+    AppState *state = (AppState *)user_data;
+    LayoutConfig *old_config = state->layout;
+    state->layout = layout_config_ref(config);
+
+    if (changes & LAYOUT_CHANGED_THEME) {
+        load_theme_css(config->theme);
+    }
+
+    if (changes & LAYOUT_CHANGED_EDGE) {
+        layout_setup_window_anchors(GTK_WINDOW(state->window), config);
+        layout_order_main_container(config, state->main_container,
+                                    state->control_widget, state->revealer);
+        gtk_revealer_set_transition_type(GTK_REVEALER(state->window_revealer),
+                                         layout_get_window_transition_type(config));
+        gtk_revealer_set_transition_type(GTK_REVEALER(state->revealer),
+                                         layout_get_transition_type(config));
+
+        icon_cache_set_image(state->expand_icon, layout_get_expand_icon(config, state->is_expanded));
+    }
+
+    if ((changes & LAYOUT_CHANGED_VISUALIZER) && state->visualizer) {
+        if (config->visualizer_analysis_rate != old_config->visualizer_analysis_rate) {
+            visualizer_set_analysis_rate(state->visualizer, config->visualizer_analysis_rate);
+        }
+        // Only when the setting itself changed: clicks may have cycled the mode since
+        if (g_strcmp0(config->visualizer_mode, old_config->visualizer_mode) != 0) {
+            visualizer_set_mode(state->visualizer, visualizer_mode_from_string(config->visualizer_mode));
+        }
+        if (!config->visualizer_enabled) {
+            visualizer_hide(state->visualizer);
+            if (state->visualizer->is_running) visualizer_stop(state->visualizer);
+        } else if (state->is_expanded) {
+            start_visualizer_if_expanded(state);
+        }
+    } else if ((changes & LAYOUT_CHANGED_VISUALIZER) && config->visualizer_enabled &&
+               !old_config->visualizer_enabled) {
+        g_print("Config: enabling the visualizer needs a restart\n");
+    }
+
+    if ((changes & LAYOUT_CHANGED_IDLE) && config->vertical_display_enabled &&
+        config->is_vertical && !state->vertical_display) {
+        g_print("Config: enabling the vertical display needs a restart\n");
+    }
+
+    // Restart the idle timer with the new timeouts (leaves idle mode if it is now off)
+    if (changes & (LAYOUT_CHANGED_IDLE | LAYOUT_CHANGED_VISUALIZER)) {
+        reset_idle_timer(state);
+    }
+
+    if (changes & LAYOUT_CHANGED_NOTIFICATIONS) {
+        state->notification->keep_alive = config->notification_keep_alive;
+    }
+
+    // Re-pick the volume backend for the current player
+    if ((changes & LAYOUT_CHANGED_VOLUME) && state->volume && state->current_player) {
+        volume_update_player(state->volume, state->mpris_proxy, state->current_player);
+    }
+
+    layout_config_unref(old_config);
+}
+
+// Re-rasterize icons when the window moves to an output with another scale
+static void on_scale_factor_changed(GObject *window, GParamSpec *pspec, gpointer user_data) {
+    icon_cache_load(gtk_widget_get_scale_factor(GTK_WIDGET(window)));
+}
+
 static void activate(GtkApplication *app, gpointer user_data) {
     AppState *state = g_new0(AppState, 1);
     state->is_playing = FALSE;
@@ -1465,20 +1690,25 @@ static void activate(GtkApplication *app, gpointer user_data) {
     state->mpris_proxy = NULL;
     state->current_player = NULL;
     state->last_track_id = NULL;
-    state->layout = layout_load_config();
-    state->notification = notification_init(app);
+    state->layout = layout_config_ref(layout_get_config());
+    state->notification = notification_init(app, state->layout->notification_keep_alive);
     state->volume = NULL;
     state->visualizer = NULL;
     state->visualizer_box = NULL;
     state->button_fade_opacity = 1.0;  // Buttons fully visible initially
     state->is_idle_mode = FALSE;
     state->idle_timer = 0;
-    state->morph_timer = 0;
+    state->morph_animation = 0;
+    state->resize_animation = 0;
 
     // Create window FIRST
     GtkWidget *window = gtk_application_window_new(app);
     state->window = window;
     gtk_window_set_title(GTK_WINDOW(window), "HyprWave");
+
+    // Resolve and rasterize all icons once; swaps are pointer assignments from here on
+    icon_cache_load(gtk_widget_get_scale_factor(window));
+    g_signal_connect(window, "notify::scale-factor", G_CALLBACK(on_scale_factor_changed), NULL);
     
     // Set window size IMMEDIATELY to match control_bar
     if (state->layout->is_vertical) {
@@ -1604,10 +1834,8 @@ static void activate(GtkApplication *app, gpointer user_data) {
     // ========================================
     GtkWidget *prev_btn = gtk_button_new();
     gtk_widget_set_size_request(prev_btn, 36, 36);
-    gchar *prev_icon_path = get_icon_path("previous.svg");
-    GtkWidget *prev_icon = gtk_image_new_from_file(prev_icon_path);
-    free_path(prev_icon_path);
-    gtk_image_set_pixel_size(GTK_IMAGE(prev_icon), 20);
+    GtkWidget *prev_icon = gtk_image_new_from_paintable(icon_cache_get("previous.svg"));
+    gtk_image_set_pixel_size(GTK_IMAGE(prev_icon), ICON_CACHE_SIZE);
     gtk_button_set_child(GTK_BUTTON(prev_btn), prev_icon);
     gtk_widget_add_css_class(prev_btn, "control-button");
     gtk_widget_add_css_class(prev_btn, "prev-button");
@@ -1615,11 +1843,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
 
     GtkWidget *play_btn = gtk_button_new();
     gtk_widget_set_size_request(play_btn, 36, 36);
-    gchar *play_icon_path = get_icon_path("play.svg");
-    GtkWidget *play_icon = gtk_image_new_from_file(play_icon_path);
-    free_path(play_icon_path);
+    GtkWidget *play_icon = gtk_image_new_from_paintable(icon_cache_get("play.svg"));
     state->play_icon = play_icon;
-    gtk_image_set_pixel_size(GTK_IMAGE(play_icon), 20);
+    gtk_image_set_pixel_size(GTK_IMAGE(play_icon), ICON_CACHE_SIZE);
     gtk_button_set_child(GTK_BUTTON(play_btn), play_icon);
     gtk_widget_add_css_class(play_btn, "control-button");
     gtk_widget_add_css_class(play_btn, "play-button");
@@ -1627,10 +1853,8 @@ static void activate(GtkApplication *app, gpointer user_data) {
 
     GtkWidget *next_btn = gtk_button_new();
     gtk_widget_set_size_request(next_btn, 36, 36);
-    gchar *next_icon_path = get_icon_path("next.svg");
-    GtkWidget *next_icon = gtk_image_new_from_file(next_icon_path);
-    free_path(next_icon_path);
-    gtk_image_set_pixel_size(GTK_IMAGE(next_icon), 20);
+    GtkWidget *next_icon = gtk_image_new_from_paintable(icon_cache_get("next.svg"));
+    gtk_image_set_pixel_size(GTK_IMAGE(next_icon), ICON_CACHE_SIZE);
     gtk_button_set_child(GTK_BUTTON(next_btn), next_icon);
     gtk_widget_add_css_class(next_btn, "control-button");
     gtk_widget_add_css_class(next_btn, "next-button");
@@ -1639,11 +1863,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *expand_btn = gtk_button_new();
     gtk_widget_set_size_request(expand_btn, 36, 36);
     const gchar *initial_icon_name = layout_get_expand_icon(state->layout, FALSE);
-    gchar *expand_icon_path = get_icon_path(initial_icon_name);
-    GtkWidget *expand_icon = gtk_image_new_from_file(expand_icon_path);
-    free_path(expand_icon_path);
+    GtkWidget *expand_icon = gtk_image_new_from_paintable(icon_cache_get(initial_icon_name));
     state->expand_icon = expand_icon;
-    gtk_image_set_pixel_size(GTK_IMAGE(expand_icon), 20);
+    gtk_image_set_pixel_size(GTK_IMAGE(expand_icon), ICON_CACHE_SIZE);
     gtk_button_set_child(GTK_BUTTON(expand_btn), expand_icon);
     gtk_widget_add_css_class(expand_btn, "control-button");
     gtk_widget_add_css_class(expand_btn, "expand-button");
@@ -1661,15 +1883,16 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *control_bar = layout_create_control_bar(state->layout,
         &prev_btn, &play_btn, &next_btn, &expand_btn);
     state->control_bar_container = control_bar;
+    state->control_bar_bin = transform_bin_new(control_bar);
 
     // Initialize vertical display for vertical layouts
-    GtkWidget *final_control_widget = control_bar;
+    GtkWidget *final_control_widget = state->control_bar_bin;
     if (state->layout->is_vertical && state->layout->vertical_display_enabled) {
         state->vertical_display = vertical_display_init();
         if (state->vertical_display) {
             // Create overlay: control bar as base, vertical display on top
             GtkWidget *overlay = gtk_overlay_new();
-            gtk_overlay_set_child(GTK_OVERLAY(overlay), control_bar);
+            gtk_overlay_set_child(GTK_OVERLAY(overlay), state->control_bar_bin);
 
             // Vertical display must pass through clicks
             gtk_widget_set_can_target(state->vertical_display->container, FALSE);
@@ -1695,6 +1918,11 @@ static void activate(GtkApplication *app, gpointer user_data) {
         state->visualizer = visualizer_init(!state->layout->is_vertical);
 
         if (state->visualizer) {
+            visualizer_set_analysis_rate(state->visualizer, state->layout->visualizer_analysis_rate);
+            visualizer_set_mode(state->visualizer,
+                                visualizer_mode_from_string(state->layout->visualizer_mode));
+            visualizer_set_format_label(state->visualizer, state->format_label);
+
             // Add visualizer container to the expanded section's visualizer_box
             gtk_box_append(GTK_BOX(state->visualizer_box), state->visualizer->container);
             gtk_widget_set_hexpand(state->visualizer->container, TRUE);
@@ -1715,24 +1943,16 @@ static void activate(GtkApplication *app, gpointer user_data) {
     // Create main container (use overlay if vertical display enabled)
     GtkWidget *main_container = layout_create_main_container(state->layout,
         final_control_widget, revealer);
+    state->main_container = main_container;
+    state->control_widget = final_control_widget;
 
     // ========================================
     // WINDOW REVEALER
     // ========================================
     GtkWidget *window_revealer = gtk_revealer_new();
     state->window_revealer = window_revealer;
-    
-    GtkRevealerTransitionType window_transition;
-    if (state->layout->edge == EDGE_RIGHT) {
-        window_transition = GTK_REVEALER_TRANSITION_TYPE_SLIDE_LEFT;
-    } else if (state->layout->edge == EDGE_LEFT) {
-        window_transition = GTK_REVEALER_TRANSITION_TYPE_SLIDE_RIGHT;
-    } else if (state->layout->edge == EDGE_TOP) {
-        window_transition = GTK_REVEALER_TRANSITION_TYPE_SLIDE_DOWN;
-    } else {
-        window_transition = GTK_REVEALER_TRANSITION_TYPE_SLIDE_UP;
-    }
-    gtk_revealer_set_transition_type(GTK_REVEALER(window_revealer), window_transition);
+    gtk_revealer_set_transition_type(GTK_REVEALER(window_revealer),
+                                     layout_get_window_transition_type(state->layout));
     gtk_revealer_set_transition_duration(GTK_REVEALER(window_revealer), 300);
     gtk_revealer_set_child(GTK_REVEALER(window_revealer), main_container);
     gtk_revealer_set_reveal_child(GTK_REVEALER(window_revealer), FALSE);
@@ -1798,6 +2018,13 @@ static void activate(GtkApplication *app, gpointer user_data) {
     global_state = state;
     g_unix_signal_add(SIGUSR1, handle_sigusr1, NULL);
     g_unix_signal_add(SIGUSR2, handle_sigusr2, NULL);
+    IpcHandlers ipc_handlers = {
+        .get_signal_path = ipc_signal_path,
+        .get_latency_stats = ipc_latency_stats,
+        .get_rt_health = ipc_rt_health,
+        .user_data = state,
+    };
+    ipc_init(G_APPLICATION(app), &ipc_handlers);
 
     // Setup D-Bus name watcher to monitor player appearance/disappearance
     GDBusConnection *bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
@@ -1817,8 +2044,8 @@ static void activate(GtkApplication *app, gpointer user_data) {
         g_print("✓ D-Bus name watcher enabled\n");
     }
 
+    // Position is polled only while playing and the bar is on screen (sync_position_ticker)
     find_active_player(state);
-    state->update_timer = g_timeout_add_seconds(1, update_position_tick, state);
 
     g_print("Layout: %s edge (%s)\n",
             state->layout->edge == EDGE_RIGHT ? "right" :
@@ -1837,6 +2064,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
                state->layout->visualizer_idle_timeout > 0) {
         reset_idle_timer(state);
     }
+
+    // Apply config.conf edits without a restart
+    layout_watch_config(on_config_changed, state);
 }
 
 
@@ -1845,6 +2075,7 @@ int main(int argc, char **argv) {
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
     g_signal_connect(app, "startup", G_CALLBACK(load_css), NULL);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
+    ipc_cleanup();
     g_object_unref(app);
     return status;
 }
@@ -1,8 +1,93 @@
 #include "notification.h"
 #include "art.h"
+#include "animation.h"
+#include "transform_bin.h"
 #include <gdk-pixbuf/gdk-pixbuf.h>
+#include <math.h>
 
 #define SLIDE_DISTANCE 400  // Increased from 350 to ensure full off-screen
+#define SCREEN_MARGIN 10
+#define SLIDE_DURATION_MS 640
+
+// Content tree, built with GtkBuilder whenever the window is (re)created
+static const gchar *notification_ui =
+    "<interface>"
+    "  <object class='GtkBox' id='container'>"
+    "    <property name='orientation'>vertical</property>"
+    "    <property name='spacing'>8</property>"
+    "    <property name='overflow'>hidden</property>"
+    "    <style><class name='notification-container'/></style>"
+    "    <child>"
+    "      <object class='GtkLabel'>"
+    "        <property name='label'>Now Playing</property>"
+    "        <style><class name='notification-header'/></style>"
+    "      </object>"
+    "    </child>"
+    "    <child>"
+    "      <object class='GtkBox'>"
+    "        <property name='orientation'>horizontal</property>"
+    "        <property name='spacing'>12</property>"
+    "        <style><class name='notification-content'/></style>"
+    "        <child>"
+    "          <object class='GtkBox' id='album_cover'>"
+    "            <property name='orientation'>vertical</property>"
+    "            <property name='width-request'>70</property>"
+    "            <property name='height-request'>70</property>"
+    "            <property name='overflow'>hidden</property>"
+    "            <style><class name='notification-album'/></style>"
+    "          </object>"
+    "        </child>"
+    "        <child>"
+    "          <object class='GtkBox'>"
+    "            <property name='orientation'>vertical</property>"
+    "            <property name='spacing'>4</property>"
+    "            <property name='valign'>center</property>"
+    "            <child>"
+    "              <object class='GtkLabel' id='song_label'>"
+    "                <property name='ellipsize'>end</property>"
+    "                <property name='max-width-chars'>30</property>"
+    "                <property name='xalign'>0</property>"
+    "                <style><class name='notification-song'/></style>"
+    "              </object>"
+    "            </child>"
+    "            <child>"
+    "              <object class='GtkLabel' id='artist_label'>"
+    "                <property name='ellipsize'>end</property>"
+    "                <property name='max-width-chars'>30</property>"
+    "                <property name='xalign'>0</property>"
+    "                <style><class name='notification-artist'/></style>"
+    "              </object>"
+    "            </child>"
+    "          </object>"
+    "        </child>"
+    "      </object>"
+    "    </child>"
+    "  </object>"
+    "</interface>";
+
+static void destroy_window(NotificationState *state) {
+    if (!state->window) return;
+
+    animation_clear(&state->slide_animation);
+    gtk_window_destroy(GTK_WINDOW(state->window));
+    state->window = NULL;
+    state->slide_bin = NULL;
+    state->album_cover = NULL;
+    state->song_label = NULL;
+    state->artist_label = NULL;
+    state->current_offset = SLIDE_DISTANCE;
+}
+
+static gboolean on_teardown_timeout(gpointer user_data) {
+    NotificationState *state = (NotificationState *)user_data;
+    state->teardown_timer = 0;
+
+    if (!state->is_showing) {
+        destroy_window(state);
+        g_print("Notification window released\n");
+    }
+    return G_SOURCE_REMOVE;
+}
 
 static gboolean auto_hide_notification(gpointer user_data) {
     NotificationState *state = (NotificationState *)user_data;
@@ -10,34 +95,64 @@ static gboolean auto_hide_notification(gpointer user_data) {
     return G_SOURCE_REMOVE;
 }
 
-static gboolean animate_slide_in(gpointer user_data) {
+// Slide between the current offset and fully in (is_showing) or fully out.
+// The surface stays put; only the content is drawn shifted, so the
+// compositor sees no reconfigure while it moves.
+static void set_offset(NotificationState *state, gint offset) {
+    state->current_offset = offset;
+    transform_bin_set_offset(TRANSFORM_BIN(state->slide_bin), offset, 0);
+}
+
+static void slide_step(gdouble progress, gpointer user_data) {
     NotificationState *state = (NotificationState *)user_data;
-    
-    if (state->current_offset <= 0) {
-        state->current_offset = 0;
-        gtk_layer_set_margin(GTK_WINDOW(state->window), GTK_LAYER_SHELL_EDGE_RIGHT, 10);
-        state->animation_timer = 0;
-        return G_SOURCE_REMOVE;
+    gint target = state->is_showing ? 0 : SLIDE_DISTANCE;
+
+    set_offset(state, state->slide_from + (gint)lround((target - state->slide_from) * progress));
+}
+
+static void slide_done(gpointer user_data) {
+    NotificationState *state = (NotificationState *)user_data;
+    state->slide_animation = 0;
+
+    // Slid out: unmap until the next notification, free it if none comes
+    if (!state->is_showing) {
+        gtk_widget_set_visible(state->window, FALSE);
+        if (state->teardown_timer > 0) {
+            g_source_remove(state->teardown_timer);
+        }
+        state->teardown_timer = g_timeout_add_seconds(state->keep_alive, on_teardown_timeout, state);
     }
-    
-    state->current_offset -= 10;  // Slower slide speed for smoother animation
-    if (state->current_offset < 0) state->current_offset = 0;
-    
-    gtk_layer_set_margin(GTK_WINDOW(state->window), GTK_LAYER_SHELL_EDGE_RIGHT, 10 - state->current_offset);
-    
-    return G_SOURCE_CONTINUE;
+}
+
+// Clicks go through to whatever is underneath
+static void on_window_realize(GtkWidget *window, gpointer user_data) {
+    cairo_region_t *region = cairo_region_create();
+    gdk_surface_set_input_region(gtk_native_get_surface(GTK_NATIVE(window)), region);
+    cairo_region_destroy(region);
+}
+
+static void start_slide(NotificationState *state) {
+    animation_clear(&state->slide_animation);
+    state->slide_from = state->current_offset;
+
+    gint target = state->is_showing ? 0 : SLIDE_DISTANCE;
+    guint duration = (guint)(SLIDE_DURATION_MS * ABS(target - state->slide_from) / SLIDE_DISTANCE);
+    state->slide_animation = animation_start(state->window, duration,
+                                             state->is_showing ? animation_ease_out_cubic
+                                                               : animation_ease_in_out_cubic,
+                                             slide_step, slide_done, state);
 }
 
 static gboolean start_notification_animation_after_load(gpointer user_data) {
     NotificationState *state = (NotificationState *)user_data;
+    state->reveal_timer = 0;
 
     // Double-check we're at off-screen position
-    state->current_offset = SLIDE_DISTANCE;
-    gtk_layer_set_margin(GTK_WINDOW(state->window), GTK_LAYER_SHELL_EDGE_RIGHT, 10 - SLIDE_DISTANCE);
+    set_offset(state, SLIDE_DISTANCE);
     
     // Start slide-in animation
     state->is_showing = TRUE;
-    state->animation_timer = g_timeout_add(16, animate_slide_in, state);
+    start_slide(state);
     
     // Set timer to auto-hide after 4 seconds
     state->hide_timer = g_timeout_add_seconds(4, auto_hide_notification, state);
@@ -45,30 +160,9 @@ static gboolean start_notification_animation_after_load(gpointer user_data) {
     return G_SOURCE_REMOVE;
 }
 
-static gboolean animate_slide_out(gpointer user_data) {
-    NotificationState *state = (NotificationState *)user_data;
-    
-    if (state->current_offset >= SLIDE_DISTANCE) {
-        state->current_offset = SLIDE_DISTANCE;
-        gtk_layer_set_margin(GTK_WINDOW(state->window), GTK_LAYER_SHELL_EDGE_RIGHT, 10 - state->current_offset);
-        // Keep window visible but off-screen
-        state->animation_timer = 0;
-        return G_SOURCE_REMOVE;
-    }
-    
-    state->current_offset += 10;  // Slower slide speed to match slide-in
-    if (state->current_offset > SLIDE_DISTANCE) state->current_offset = SLIDE_DISTANCE;
-    
-    gtk_layer_set_margin(GTK_WINDOW(state->window), GTK_LAYER_SHELL_EDGE_RIGHT, 10 - state->current_offset);
-    
-    return G_SOURCE_CONTINUE;
-}
-
-NotificationState* notification_init(GtkApplication *app) {
-    NotificationState *state = g_new0(NotificationState, 1);
-    
-    // Create window
-    GtkWidget *window = gtk_application_window_new(app);
+// Layer-shell window around the builder template
+static void create_window(NotificationState *state) {
+    GtkWidget *window = gtk_application_window_new(state->app);
     state->window = window;
     gtk_window_set_title(GTK_WINDOW(window), "HyprWave Notification");
     gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
@@ -81,70 +175,39 @@ NotificationState* notification_init(GtkApplication *app) {
     // Anchor to top-right
     gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_TOP, TRUE);
     gtk_layer_set_anchor(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, TRUE);
-    gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_TOP, 10);
-    // Start way off-screen
-    gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, 10 - SLIDE_DISTANCE);
+    gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_TOP, SCREEN_MARGIN);
+    gtk_layer_set_margin(GTK_WINDOW(window), GTK_LAYER_SHELL_EDGE_RIGHT, SCREEN_MARGIN);
     
     gtk_layer_set_keyboard_mode(GTK_WINDOW(window), GTK_LAYER_SHELL_KEYBOARD_MODE_NONE);
     gtk_widget_add_css_class(window, "notification-window");
-    
-    // Create main container
-    GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-    gtk_widget_add_css_class(main_box, "notification-container");
-    gtk_widget_set_overflow(main_box, GTK_OVERFLOW_HIDDEN);
-    
-    // Header label
-    GtkWidget *header = gtk_label_new("Now Playing");
-    gtk_widget_add_css_class(header, "notification-header");
-    gtk_box_append(GTK_BOX(main_box), header);
-    
-    // Content box (horizontal layout like expanded section)
-    GtkWidget *content_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
-    gtk_widget_add_css_class(content_box, "notification-content");
-    
-    // Album cover
-    GtkWidget *album_cover = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-    state->album_cover = album_cover;
-    gtk_widget_add_css_class(album_cover, "notification-album");
-    gtk_widget_set_size_request(album_cover, 70, 70);
-    gtk_widget_set_overflow(album_cover, GTK_OVERFLOW_HIDDEN);
-    
-    // Info panel
-    GtkWidget *info_panel = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
-    gtk_widget_set_valign(info_panel, GTK_ALIGN_CENTER);
-    
-    // Song title
-    GtkWidget *song_label = gtk_label_new("");
-    state->song_label = song_label;
-    gtk_widget_add_css_class(song_label, "notification-song");
-    gtk_label_set_ellipsize(GTK_LABEL(song_label), PANGO_ELLIPSIZE_END);
-    gtk_label_set_max_width_chars(GTK_LABEL(song_label), 30);
-    gtk_label_set_xalign(GTK_LABEL(song_label), 0.0);
-    
-    // Artist label
-    GtkWidget *artist_label = gtk_label_new("");
-    state->artist_label = artist_label;
-    gtk_widget_add_css_class(artist_label, "notification-artist");
-    gtk_label_set_ellipsize(GTK_LABEL(artist_label), PANGO_ELLIPSIZE_END);
-    gtk_label_set_max_width_chars(GTK_LABEL(artist_label), 30);
-    gtk_label_set_xalign(GTK_LABEL(artist_label), 0.0);
-    
-    gtk_box_append(GTK_BOX(info_panel), song_label);
-    gtk_box_append(GTK_BOX(info_panel), artist_label);
-    
-    gtk_box_append(GTK_BOX(content_box), album_cover);
-    gtk_box_append(GTK_BOX(content_box), info_panel);
-    
-    gtk_box_append(GTK_BOX(main_box), content_box);
-    
-    gtk_window_set_child(GTK_WINDOW(window), main_box);
-    
-    // ALWAYS keep window visible, just off-screen
-    gtk_window_present(GTK_WINDOW(window));
 
+    GtkBuilder *builder = gtk_builder_new_from_string(notification_ui, -1);
+    GtkWidget *main_box = GTK_WIDGET(gtk_builder_get_object(builder, "container"));
+    state->album_cover = GTK_WIDGET(gtk_builder_get_object(builder, "album_cover"));
+    state->song_label = GTK_WIDGET(gtk_builder_get_object(builder, "song_label"));
+    state->artist_label = GTK_WIDGET(gtk_builder_get_object(builder, "artist_label"));
+
+    // Content slides inside a fixed surface (drawn shifted past its right edge)
+    state->slide_bin = transform_bin_new(main_box);
+    gtk_window_set_child(GTK_WINDOW(window), state->slide_bin);
+    g_signal_connect(window, "realize", G_CALLBACK(on_window_realize), NULL);
+    g_object_unref(builder);
+
+    state->current_offset = SLIDE_DISTANCE;
+}
+
+NotificationState* notification_init(GtkApplication *app, guint keep_alive) {
+    NotificationState *state = g_new0(NotificationState, 1);
+    state->app = app;
+    state->keep_alive = keep_alive;
+
+    // No window until the first notification
+    state->window = NULL;
     state->is_showing = FALSE;
     state->hide_timer = 0;
-    state->animation_timer = 0;
+    state->reveal_timer = 0;
+    state->teardown_timer = 0;
+    state->slide_animation = 0;
     state->current_offset = SLIDE_DISTANCE;
     
     return state;
@@ -162,9 +225,14 @@ void notification_show(NotificationState *state,
         g_source_remove(state->hide_timer);
         state->hide_timer = 0;
     }
-    if (state->animation_timer > 0) {
-        g_source_remove(state->animation_timer);
-        state->animation_timer = 0;
+    animation_clear(&state->slide_animation);
+    if (state->teardown_timer > 0) {
+        g_source_remove(state->teardown_timer);
+        state->teardown_timer = 0;
+    }
+
+    if (!state->window) {
+        create_window(state);
     }
 
     // Always update text content immediately
@@ -177,27 +245,32 @@ void notification_show(NotificationState *state,
     gtk_label_set_text(GTK_LABEL(state->artist_label), artist_text);
     g_free(artist_text);
 
-    // Only load album art if container is empty (art may be pre-loaded)
-    // This handles ephemeral temp files from Chromium that get deleted quickly
-    GtkWidget *existing_art = gtk_widget_get_first_child(state->album_cover);
-    if (!existing_art) {
-        load_album_art_to_container(art_url, state->album_cover, 70);
+    // Art comes from the shared cache, decoded when the track changed, so
+    // ephemeral temp files from Chromium are fine even once deleted
+    if (!load_album_art_to_container(art_url, state->album_cover, 70)) {
+        clear_album_art_container(state->album_cover);
     }
 
     // Check if notification is currently showing or partially visible
     if (state->is_showing || state->current_offset < SLIDE_DISTANCE) {
         // Notification is visible - content already updated above
         state->is_showing = TRUE;
+        // Caught mid slide-out: slide back in from where it is
+        if (state->current_offset > 0) {
+            start_slide(state);
+        }
         // Reset hide timer
         state->hide_timer = g_timeout_add_seconds(4, auto_hide_notification, state);
     } else {
-        // Notification is fully hidden (off-screen), do slide-in animation
-        // Ensure we're at off-screen position
-        state->current_offset = SLIDE_DISTANCE;
-        gtk_layer_set_margin(GTK_WINDOW(state->window), GTK_LAYER_SHELL_EDGE_RIGHT, 10 - SLIDE_DISTANCE);
+        // Notification is fully hidden (unmapped), do slide-in animation
+        // Map the surface with the content drawn off-screen
+        set_offset(state, SLIDE_DISTANCE);
+        gtk_window_present(GTK_WINDOW(state->window));
 
         // Wait a bit for content to be fully rendered before animating
-        g_timeout_add(100, start_notification_animation_after_load, state);
+        if (state->reveal_timer == 0) {
+            state->reveal_timer = g_timeout_add(100, start_notification_animation_after_load, state);
+        }
     }
 }
 
@@ -212,13 +285,8 @@ void notification_hide(NotificationState *state) {
         state->hide_timer = 0;
     }
     
-    // Cancel any existing animation
-    if (state->animation_timer > 0) {
-        g_source_remove(state->animation_timer);
-    }
-    
     // Start slide-out animation from current position
-    state->animation_timer = g_timeout_add(16, animate_slide_out, state);  // ~60fps
+    start_slide(state);
 }
 
 void notification_cleanup(NotificationState *state) {
@@ -227,14 +295,14 @@ void notification_cleanup(NotificationState *state) {
     if (state->hide_timer > 0) {
         g_source_remove(state->hide_timer);
     }
-    
-    if (state->animation_timer > 0) {
-        g_source_remove(state->animation_timer);
+    if (state->reveal_timer > 0) {
+        g_source_remove(state->reveal_timer);
     }
-    
-    if (state->window) {
-        gtk_window_destroy(GTK_WINDOW(state->window));
+    if (state->teardown_timer > 0) {
+        g_source_remove(state->teardown_timer);
     }
     
+    destroy_window(state);
+    
     g_free(state);
 }
@@ -5,18 +5,27 @@
 #include <gtk4-layer-shell.h>
 
 typedef struct {
+    GtkApplication *app;
+    guint keep_alive;           // Seconds the window outlives its last slide-out
+    guint teardown_timer;       // Destroys the window once keep_alive runs out
+
+    // Built on first use, NULL while torn down
     GtkWidget *window;
+    GtkWidget *slide_bin;       // TransformBin the content slides in
     GtkWidget *album_cover;
     GtkWidget *song_label;
     GtkWidget *artist_label;
     guint hide_timer;
-    guint animation_timer;
+    guint reveal_timer;         // Short wait between mapping and sliding in
+    guint slide_animation;
     gint current_offset;
+    gint slide_from;            // Offset the running slide started at
     gboolean is_showing;
 } NotificationState;
 
-// Initialize notification system
-NotificationState* notification_init(GtkApplication *app);
+// Initialize notification system; the window is only created when a
+// notification is shown and destroyed `keep_alive` seconds after it hides
+NotificationState* notification_init(GtkApplication *app, guint keep_alive);
 
 // Show notification with track info
 void notification_show(NotificationState *state, 
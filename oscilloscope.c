@@ -0,0 +1,140 @@
+#include "oscilloscope.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define TRIGGER_LOWPASS_HZ 1000.0       // Keeps harmonics from adding extra crossings
+#define TRIGGER_HYSTERESIS 0.1f         // Of the current peak: must dip this far below 0 to re-arm
+#define PEAK_RELEASE_MS 1000.0
+#define PEAK_FLOOR 0.02f                // Never zoom in more than 50x
+#define PEAK_HEADROOM 1.1f
+
+void oscilloscope_init(Oscilloscope *scope) {
+    memset(scope, 0, sizeof(*scope));
+}
+
+void oscilloscope_configure(Oscilloscope *scope, uint32_t rate, uint32_t channels) {
+    scope->rate = rate;
+    scope->channels = channels;
+    if (rate == 0 || channels == 0) {
+        scope->rate = 0;
+        return;
+    }
+
+    scope->window = rate * OSCILLOSCOPE_WINDOW_MS / 1000;
+    if (scope->window > OSCILLOSCOPE_HISTORY / 2) scope->window = OSCILLOSCOPE_HISTORY / 2;
+    if (scope->window == 0) scope->window = 1;
+
+    scope->lowpass_coef = (float)(1.0 - exp(-2.0 * M_PI * TRIGGER_LOWPASS_HZ / rate));
+    scope->peak_release = (float)exp(-1.0 / (rate * PEAK_RELEASE_MS / 1000.0));
+
+    oscilloscope_reset(scope);
+}
+
+void oscilloscope_reset(Oscilloscope *scope) {
+    memset(scope->history, 0, sizeof(scope->history));
+    memset(scope->trigger, 0, sizeof(scope->trigger));
+    scope->pos = 0;
+    scope->lowpass_state = 0.0f;
+    scope->peak = PEAK_FLOOR;
+    scope->n_columns = 0;
+    scope->triggered = 0;
+}
+
+void oscilloscope_process(Oscilloscope *scope, const float *samples, size_t n_frames, uint32_t stride) {
+    if (scope->rate == 0) return;
+
+    const uint32_t channels = scope->channels;
+    const uint32_t mask = OSCILLOSCOPE_HISTORY - 1;
+    const float scale = 1.0f / (float)channels;
+    const float coef = scope->lowpass_coef;
+    float lp = scope->lowpass_state;
+    float peak = scope->peak;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * stride;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; c++) {
+            sum += frame[c];
+        }
+        float x = sum * scale;
+        lp += coef * (x - lp);
+
+        scope->history[scope->pos] = x;
+        scope->trigger[scope->pos] = lp;
+        scope->pos = (scope->pos + 1) & mask;
+
+        float mag = fabsf(x);
+        peak = mag > peak ? mag : peak * scope->peak_release;
+    }
+
+    scope->lowpass_state = lp;
+    scope->peak = peak < PEAK_FLOOR ? PEAK_FLOOR : peak;
+}
+
+// Latest armed rising crossing in the window before the last full window,
+// as a history offset counted back from the write position; 0 if none
+static uint32_t find_trigger(const Oscilloscope *scope) {
+    const uint32_t mask = OSCILLOSCOPE_HISTORY - 1;
+    const uint32_t window = scope->window;
+    const float arm = -TRIGGER_HYSTERESIS * scope->peak;
+
+    // Scan forward through [pos - 2*window, pos - window]
+    uint32_t i = (scope->pos - 2 * window) & mask;
+    uint32_t found = 0;
+    int armed = 0;
+    float prev = scope->trigger[i];
+
+    for (uint32_t back = 2 * window; back > window; back--) {
+        i = (i + 1) & mask;
+        float t = scope->trigger[i];
+        if (t < arm) {
+            armed = 1;
+        } else if (armed && prev < 0.0f && t >= 0.0f) {
+            found = back - 1;
+            armed = 0;
+        }
+        prev = t;
+    }
+    return found;
+}
+
+void oscilloscope_render(Oscilloscope *scope, uint32_t columns) {
+    if (scope->rate == 0) return;
+    if (columns < 1) columns = 1;
+    if (columns > OSCILLOSCOPE_MAX_COLUMNS) columns = OSCILLOSCOPE_MAX_COLUMNS;
+
+    const uint32_t mask = OSCILLOSCOPE_HISTORY - 1;
+    const uint32_t window = scope->window;
+
+    uint32_t back = find_trigger(scope);
+    scope->triggered = back != 0;
+    if (!back) back = window;
+    uint32_t start = (scope->pos - back) & mask;
+
+    const float gain = 1.0f / (scope->peak * PEAK_HEADROOM);
+
+    // Column c covers [c*window/columns, (c+1)*window/columns), at least one sample
+    for (uint32_t c = 0; c < columns; c++) {
+        uint32_t first = (uint32_t)((uint64_t)c * window / columns);
+        uint32_t last = (uint32_t)((uint64_t)(c + 1) * window / columns);
+        if (last <= first) last = first + 1;
+
+        float lo = scope->history[(start + first) & mask];
+        float hi = lo;
+        for (uint32_t s = first + 1; s < last; s++) {
+            float x = scope->history[(start + s) & mask];
+            if (x < lo) lo = x;
+            if (x > hi) hi = x;
+        }
+
+        lo *= gain;
+        hi *= gain;
+        scope->col_min[c] = lo < -1.0f ? -1.0f : lo;
+        scope->col_max[c] = hi > 1.0f ? 1.0f : hi;
+    }
+    scope->n_columns = columns;
+}
@@ -0,0 +1,63 @@
+#ifndef OSCILLOSCOPE_H
+#define OSCILLOSCOPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Oscilloscope Analysis
+ *
+ * Keeps the most recent mono downmix in a circular history. On each
+ * oscilloscope_render() it looks for the latest rising zero crossing that
+ * still has a full window of audio after it (on a low-passed copy of the
+ * signal, with hysteresis, so noise and harmonics do not retrigger) and
+ * min/max-decimates that window to exactly the requested number of
+ * columns. Periodic material therefore starts at the same phase every
+ * frame and the trace stands still; without a crossing it free-runs.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define OSCILLOSCOPE_HISTORY 16384      // Power of two; >= 2 windows at 192 kHz
+#define OSCILLOSCOPE_WINDOW_MS 25       // Time span across the widget
+#define OSCILLOSCOPE_MAX_COLUMNS 2048
+
+typedef struct {
+    uint32_t rate;                      // 0 until configured
+    uint32_t channels;
+
+    float history[OSCILLOSCOPE_HISTORY];    // Mono downmix
+    float trigger[OSCILLOSCOPE_HISTORY];    // Low-passed copy the trigger looks at
+    uint32_t pos;                       // Next write slot
+    float lowpass_coef;
+    float lowpass_state;
+
+    // Auto-scale so quiet material still fills the height
+    float peak;
+    float peak_release;                 // Per sample
+    uint32_t window;                    // Frames shown
+
+    // Last render: column extremes normalized to -1..+1
+    float col_min[OSCILLOSCOPE_MAX_COLUMNS];
+    float col_max[OSCILLOSCOPE_MAX_COLUMNS];
+    uint32_t n_columns;
+    int triggered;                      // 0 = free-running this render
+} Oscilloscope;
+
+// Zero all state; the analyzer ignores input until oscilloscope_configure()
+void oscilloscope_init(Oscilloscope *scope);
+
+// Apply a negotiated format
+void oscilloscope_configure(Oscilloscope *scope, uint32_t rate, uint32_t channels);
+
+// Clear history and the last render (format is kept)
+void oscilloscope_reset(Oscilloscope *scope);
+
+// Feed interleaved F32 frames with `stride` floats per frame (>= channels)
+void oscilloscope_process(Oscilloscope *scope, const float *samples, size_t n_frames, uint32_t stride);
+
+// Trigger and decimate the latest window into `columns` min/max pairs
+// (clamped to 1..OSCILLOSCOPE_MAX_COLUMNS)
+void oscilloscope_render(Oscilloscope *scope, uint32_t columns);
+
+#endif // OSCILLOSCOPE_H
@@ -0,0 +1,492 @@
+#include "pw_graph.h"
+#include <pipewire/keys.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    guint32 id;
+    gboolean announced;           // FALSE while only known from a port or link
+    gchar *name;
+    gchar *media_class;
+    gchar *link_group;            // node.link-group: halves of a filter-chain / loopback
+    gboolean is_stream;           // Stream/* (application side)
+    gboolean is_sink;             // */Sink
+    gboolean is_device;           // Backed by hardware (device.id)
+    guint32 rate;                 // From params, else audio.rate; 0 = unknown
+    guint channels;               // From params, else audio.channels; 0 = unknown
+    gboolean soft_volume;
+    guint in_ports;               // Non-monitor ports
+    guint out_ports;
+    GList *links_in;              // PwGraphLink*, owned by graph->links
+    GList *links_out;
+} PwGraphNode;
+
+typedef struct {
+    guint32 id;
+    guint32 node_id;
+    gboolean output;
+    gboolean monitor;
+} PwGraphPort;
+
+typedef struct {
+    guint32 id;
+    guint32 out_node;
+    guint32 in_node;
+} PwGraphLink;
+
+struct PwGraph {
+    GHashTable *nodes;            // id -> PwGraphNode*
+    GHashTable *ports;            // id -> PwGraphPort*
+    GHashTable *links;            // id -> PwGraphLink*
+    GHashTable *link_groups;      // node.link-group -> GList of PwGraphNode* (lists freed by hand)
+
+    guint32 source_id;
+    gboolean dirty;
+    GHashTable *path_nodes;       // Every node the current path walks through (set)
+    PwGraphHop hops[PW_GRAPH_MAX_HOPS];
+    guint hop_count;
+    GString *text;
+};
+
+static void node_free(gpointer data) {
+    PwGraphNode *node = (PwGraphNode *)data;
+    g_free(node->name);
+    g_free(node->media_class);
+    g_free(node->link_group);
+    g_list_free(node->links_in);
+    g_list_free(node->links_out);
+    g_free(node);
+}
+
+static PwGraphNode* get_node(PwGraph *graph, guint32 id, gboolean create) {
+    PwGraphNode *node = g_hash_table_lookup(graph->nodes, GUINT_TO_POINTER(id));
+    if (!node && create) {
+        node = g_new0(PwGraphNode, 1);
+        node->id = id;
+        g_hash_table_insert(graph->nodes, GUINT_TO_POINTER(id), node);
+    }
+    return node;
+}
+
+static gboolean on_path(PwGraph *graph, guint32 id) {
+    return g_hash_table_contains(graph->path_nodes, GUINT_TO_POINTER(id));
+}
+
+static void link_group_remove(PwGraph *graph, PwGraphNode *node) {
+    if (!node->link_group) return;
+    GList *members = g_hash_table_lookup(graph->link_groups, node->link_group);
+    members = g_list_remove(members, node);
+    if (members) {
+        g_hash_table_replace(graph->link_groups, g_strdup(node->link_group), members);
+    } else {
+        g_hash_table_remove(graph->link_groups, node->link_group);
+    }
+}
+
+static void link_group_add(PwGraph *graph, PwGraphNode *node) {
+    if (!node->link_group) return;
+    GList *members = g_hash_table_lookup(graph->link_groups, node->link_group);
+    g_hash_table_replace(graph->link_groups, g_strdup(node->link_group),
+                         g_list_prepend(members, node));
+}
+
+static guint32 dict_uint(const struct spa_dict *props, const char *key) {
+    const char *value = spa_dict_lookup(props, key);
+    return value ? (guint32)strtoul(value, NULL, 10) : 0;
+}
+
+PwGraph* pw_graph_new(void) {
+    PwGraph *graph = g_new0(PwGraph, 1);
+    graph->nodes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, node_free);
+    graph->ports = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    graph->links = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    graph->link_groups = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    graph->path_nodes = g_hash_table_new(g_direct_hash, g_direct_equal);
+    graph->text = g_string_new(NULL);
+    return graph;
+}
+
+void pw_graph_free(PwGraph *graph) {
+    if (!graph) return;
+    g_hash_table_destroy(graph->nodes);
+    g_hash_table_destroy(graph->ports);
+    g_hash_table_destroy(graph->links);
+    GHashTableIter iter;
+    gpointer members;
+    g_hash_table_iter_init(&iter, graph->link_groups);
+    while (g_hash_table_iter_next(&iter, NULL, &members)) {
+        g_list_free(members);
+    }
+    g_hash_table_destroy(graph->link_groups);
+    g_hash_table_destroy(graph->path_nodes);
+    g_string_free(graph->text, TRUE);
+    g_free(graph);
+}
+
+// ========================================
+// REGISTRY MIRROR
+// ========================================
+
+void pw_graph_add_node(PwGraph *graph, guint32 id, const struct spa_dict *props) {
+    if (!props) return;
+    const char *media_class = spa_dict_lookup(props, PW_KEY_MEDIA_CLASS);
+    if (!media_class || !strstr(media_class, "Audio")) return;
+
+    PwGraphNode *node = get_node(graph, id, TRUE);
+    node->announced = TRUE;
+    g_free(node->media_class);
+    node->media_class = g_strdup(media_class);
+    node->is_stream = g_str_has_prefix(media_class, "Stream/");
+    node->is_sink = g_str_has_suffix(media_class, "/Sink");
+    node->is_device = spa_dict_lookup(props, PW_KEY_DEVICE_ID) != NULL;
+
+    // Streams are best known by their application, everything else by its description
+    const char *name = NULL;
+    if (node->is_stream) name = spa_dict_lookup(props, PW_KEY_APP_NAME);
+    if (!name) name = spa_dict_lookup(props, PW_KEY_NODE_DESCRIPTION);
+    if (!name) name = spa_dict_lookup(props, PW_KEY_NODE_NICK);
+    if (!name) name = spa_dict_lookup(props, PW_KEY_NODE_NAME);
+    g_free(node->name);
+    node->name = name ? g_strdup(name) : g_strdup_printf("node %u", id);
+
+    link_group_remove(graph, node);
+    g_free(node->link_group);
+    node->link_group = g_strdup(spa_dict_lookup(props, PW_KEY_NODE_LINK_GROUP));
+    link_group_add(graph, node);
+
+    if (node->rate == 0) node->rate = dict_uint(props, PW_KEY_AUDIO_RATE);
+    if (node->channels == 0) node->channels = dict_uint(props, PW_KEY_AUDIO_CHANNELS);
+
+    // A new node only matters if it is the source or the missing half of a
+    // filter on the path
+    if (id == graph->source_id) {
+        graph->dirty = TRUE;
+    } else if (node->link_group) {
+        for (guint i = 0; i < graph->hop_count; i++) {
+            PwGraphNode *hop = get_node(graph, graph->hops[i].node_id, FALSE);
+            if (hop && g_strcmp0(hop->link_group, node->link_group) == 0) {
+                graph->dirty = TRUE;
+                break;
+            }
+        }
+    }
+}
+
+void pw_graph_add_port(PwGraph *graph, guint32 id, const struct spa_dict *props) {
+    if (!props) return;
+    guint32 node_id = dict_uint(props, PW_KEY_NODE_ID);
+    const char *direction = spa_dict_lookup(props, PW_KEY_PORT_DIRECTION);
+    if (node_id == 0 || !direction) return;
+
+    PwGraphPort *port = g_new0(PwGraphPort, 1);
+    port->id = id;
+    port->node_id = node_id;
+    port->output = strcmp(direction, "out") == 0;
+    const char *monitor = spa_dict_lookup(props, PW_KEY_PORT_MONITOR);
+    port->monitor = monitor && strcmp(monitor, "true") == 0;
+    g_hash_table_replace(graph->ports, GUINT_TO_POINTER(id), port);
+
+    if (port->monitor) return;
+    PwGraphNode *node = get_node(graph, node_id, TRUE);
+    if (port->output) {
+        node->out_ports++;
+    } else {
+        node->in_ports++;
+    }
+    if (on_path(graph, node_id)) graph->dirty = TRUE;
+}
+
+void pw_graph_add_link(PwGraph *graph, guint32 id, const struct spa_dict *props) {
+    if (!props) return;
+    guint32 out_node = dict_uint(props, PW_KEY_LINK_OUTPUT_NODE);
+    guint32 in_node = dict_uint(props, PW_KEY_LINK_INPUT_NODE);
+    if (out_node == 0 || in_node == 0) return;
+    if (g_hash_table_contains(graph->links, GUINT_TO_POINTER(id))) return;
+
+    // One link per port pair: a stereo connection is two links between the same nodes
+    PwGraphLink *link = g_new0(PwGraphLink, 1);
+    link->id = id;
+    link->out_node = out_node;
+    link->in_node = in_node;
+    g_hash_table_insert(graph->links, GUINT_TO_POINTER(id), link);
+
+    PwGraphNode *out = get_node(graph, out_node, TRUE);
+    PwGraphNode *in = get_node(graph, in_node, TRUE);
+    out->links_out = g_list_prepend(out->links_out, link);
+    in->links_in = g_list_prepend(in->links_in, link);
+
+    if (on_path(graph, out_node) || on_path(graph, in_node)) graph->dirty = TRUE;
+}
+
+static void unlink_link(PwGraph *graph, PwGraphLink *link) {
+    PwGraphNode *out = get_node(graph, link->out_node, FALSE);
+    PwGraphNode *in = get_node(graph, link->in_node, FALSE);
+    if (out) out->links_out = g_list_remove(out->links_out, link);
+    if (in) in->links_in = g_list_remove(in->links_in, link);
+    if (on_path(graph, link->out_node) || on_path(graph, link->in_node)) graph->dirty = TRUE;
+}
+
+void pw_graph_remove(PwGraph *graph, guint32 id) {
+    gpointer key = GUINT_TO_POINTER(id);
+
+    PwGraphLink *link = g_hash_table_lookup(graph->links, key);
+    if (link) {
+        unlink_link(graph, link);
+        g_hash_table_remove(graph->links, key);
+        return;
+    }
+
+    PwGraphPort *port = g_hash_table_lookup(graph->ports, key);
+    if (port) {
+        PwGraphNode *node = get_node(graph, port->node_id, FALSE);
+        if (node && !port->monitor) {
+            if (port->output && node->out_ports > 0) node->out_ports--;
+            if (!port->output && node->in_ports > 0) node->in_ports--;
+            if (on_path(graph, node->id)) graph->dirty = TRUE;
+        }
+        g_hash_table_remove(graph->ports, key);
+        return;
+    }
+
+    PwGraphNode *node = get_node(graph, id, FALSE);
+    if (node) {
+        // The server removes the links too; drop them now so nothing dangles
+        while (node->links_out) {
+            PwGraphLink *l = node->links_out->data;
+            unlink_link(graph, l);
+            g_hash_table_remove(graph->links, GUINT_TO_POINTER(l->id));
+        }
+        while (node->links_in) {
+            PwGraphLink *l = node->links_in->data;
+            unlink_link(graph, l);
+            g_hash_table_remove(graph->links, GUINT_TO_POINTER(l->id));
+        }
+        if (on_path(graph, id)) graph->dirty = TRUE;
+        link_group_remove(graph, node);
+        g_hash_table_remove(graph->nodes, key);
+    }
+}
+
+void pw_graph_set_node_format(PwGraph *graph, guint32 id, guint32 rate, guint channels) {
+    PwGraphNode *node = get_node(graph, id, FALSE);
+    if (!node || (node->rate == rate && node->channels == channels)) return;
+    node->rate = rate;
+    node->channels = channels;
+    if (on_path(graph, id)) graph->dirty = TRUE;
+}
+
+void pw_graph_set_node_soft_volume(PwGraph *graph, guint32 id, gboolean soft_volume) {
+    PwGraphNode *node = get_node(graph, id, FALSE);
+    if (!node || node->soft_volume == soft_volume) return;
+    node->soft_volume = soft_volume;
+    if (on_path(graph, id)) graph->dirty = TRUE;
+}
+
+guint32 pw_graph_get_linked_sink(PwGraph *graph, guint32 node_id) {
+    PwGraphNode *node = get_node(graph, node_id, FALSE);
+    if (!node) return 0;
+
+    for (GList *l = node->links_out; l; l = l->next) {
+        PwGraphNode *target = get_node(graph, ((PwGraphLink *)l->data)->in_node, FALSE);
+        if (target && target->announced && target->is_sink) return target->id;
+    }
+    return 0;
+}
+
+gboolean pw_graph_link_touches(PwGraph *graph, guint32 link_id, guint32 node_id) {
+    PwGraphLink *link = g_hash_table_lookup(graph->links, GUINT_TO_POINTER(link_id));
+    return link && node_id != 0 && (link->out_node == node_id || link->in_node == node_id);
+}
+
+void pw_graph_set_source(PwGraph *graph, guint32 node_id) {
+    if (graph->source_id == node_id) return;
+    graph->source_id = node_id;
+    graph->dirty = TRUE;
+}
+
+// ========================================
+// PATH
+// ========================================
+
+// The other half of a filter-chain/loopback: same link-group, sends audio onward
+static PwGraphNode* link_group_partner(PwGraph *graph, PwGraphNode *node) {
+    if (!node->link_group) return NULL;
+
+    GList *members = g_hash_table_lookup(graph->link_groups, node->link_group);
+    for (GList *l = members; l; l = l->next) {
+        PwGraphNode *other = (PwGraphNode *)l->data;
+        if (other != node && other->links_out &&
+            g_strcmp0(other->link_group, node->link_group) == 0) {
+            return other;
+        }
+    }
+    return NULL;
+}
+
+// Where the audio goes next: a sink if linked to one, else a node that passes
+// it on. Capture clients (including our own visualizer) are never followed.
+static PwGraphNode* next_node(PwGraph *graph, PwGraphNode *node) {
+    PwGraphNode *pass_through = NULL;
+    for (GList *l = node->links_out; l; l = l->next) {
+        PwGraphNode *target = get_node(graph, ((PwGraphLink *)l->data)->in_node, FALSE);
+        if (!target || !target->announced || on_path(graph, target->id)) continue;
+        if (target->media_class && g_str_has_prefix(target->media_class, "Stream/Input")) continue;
+        if (target->is_sink) return target;
+        if (!pass_through && target->links_out) pass_through = target;
+    }
+    return pass_through;
+}
+
+// Distinct nodes feeding `node`, other than `from`
+static guint count_mixed_in(PwGraph *graph, PwGraphNode *node, guint32 from) {
+    guint32 seen[32];
+    guint count = 0;
+    for (GList *l = node->links_in; l; l = l->next) {
+        guint32 source = ((PwGraphLink *)l->data)->out_node;
+        if (source == from || on_path(graph, source)) continue;
+        gboolean dup = FALSE;
+        for (guint i = 0; i < count; i++) {
+            if (seen[i] == source) dup = TRUE;
+        }
+        if (!dup && count < G_N_ELEMENTS(seen)) seen[count++] = source;
+    }
+    return count;
+}
+
+static void add_hop(PwGraph *graph, PwGraphNode *node, PwGraphHopKind kind, guint32 from,
+                    guint32 *last_rate, guint *last_channels) {
+    PwGraphHop *hop = &graph->hops[graph->hop_count++];
+    memset(hop, 0, sizeof(*hop));
+    hop->node_id = node->id;
+    hop->kind = kind;
+    hop->name = node->name;
+    hop->rate = node->rate;
+    hop->channels = node->channels;
+    if (hop->channels == 0) {
+        hop->channels = kind == PW_GRAPH_HOP_SOURCE ? node->out_ports : node->in_ports;
+    }
+    hop->soft_volume = node->soft_volume;
+
+    if (hop->rate > 0) {
+        hop->resampled = *last_rate > 0 && *last_rate != hop->rate;
+        *last_rate = hop->rate;
+    }
+    if (hop->channels > 0) {
+        hop->remixed = *last_channels > 0 && *last_channels != hop->channels;
+        *last_channels = hop->channels;
+    }
+    if (kind != PW_GRAPH_HOP_SOURCE) {
+        hop->mixed_in = count_mixed_in(graph, node, from);
+    }
+}
+
+static void append_hop_text(GString *text, const PwGraphHop *hop, guint32 prev_rate, guint prev_channels) {
+    static const gchar *kind_names[] = {
+        [PW_GRAPH_HOP_SOURCE] = NULL,
+        [PW_GRAPH_HOP_FILTER] = "filter",
+        [PW_GRAPH_HOP_SINK] = "virtual sink",
+        [PW_GRAPH_HOP_DEVICE] = "device",
+    };
+
+    g_string_append(text, hop->name);
+    if (kind_names[hop->kind]) g_string_append_printf(text, " [%s]", kind_names[hop->kind]);
+
+    GPtrArray *notes = g_ptr_array_new_with_free_func(g_free);
+    if (hop->resampled) {
+        g_ptr_array_add(notes, g_strdup_printf("resampled %g→%g kHz", prev_rate / 1000.0, hop->rate / 1000.0));
+    } else if (hop->rate > 0 && hop->kind == PW_GRAPH_HOP_SOURCE) {
+        g_ptr_array_add(notes, g_strdup_printf("%g kHz", hop->rate / 1000.0));
+    }
+    if (hop->remixed) {
+        g_ptr_array_add(notes, g_strdup_printf("%s %u→%uch",
+                                               hop->channels > prev_channels ? "upmix" : "downmix",
+                                               prev_channels, hop->channels));
+    } else if (hop->channels > 0 && hop->kind == PW_GRAPH_HOP_SOURCE) {
+        g_ptr_array_add(notes, g_strdup_printf("%uch", hop->channels));
+    }
+    if (hop->soft_volume) {
+        g_ptr_array_add(notes, g_strdup("software volume"));
+    }
+    if (hop->mixed_in > 0) {
+        g_ptr_array_add(notes, g_strdup_printf("+%u stream%s mixed in",
+                                               hop->mixed_in, hop->mixed_in == 1 ? "" : "s"));
+    }
+
+    if (notes->len > 0) {
+        g_string_append(text, " (");
+        for (guint i = 0; i < notes->len; i++) {
+            if (i > 0) g_string_append(text, ", ");
+            g_string_append(text, g_ptr_array_index(notes, i));
+        }
+        g_string_append_c(text, ')');
+    }
+    g_ptr_array_free(notes, TRUE);
+}
+
+gboolean pw_graph_update_path(PwGraph *graph) {
+    if (!graph->dirty) return FALSE;
+    graph->dirty = FALSE;
+
+    g_hash_table_remove_all(graph->path_nodes);
+    graph->hop_count = 0;
+
+    PwGraphNode *node = graph->source_id ? get_node(graph, graph->source_id, FALSE) : NULL;
+    guint32 last_rate = 0;
+    guint last_channels = 0;
+    if (node && node->announced) {
+        g_hash_table_add(graph->path_nodes, GUINT_TO_POINTER(node->id));
+        add_hop(graph, node, PW_GRAPH_HOP_SOURCE, 0, &last_rate, &last_channels);
+
+        guint32 from = node->id;
+        while (graph->hop_count < PW_GRAPH_MAX_HOPS) {
+            PwGraphNode *next = next_node(graph, node);
+            if (!next) break;
+            g_hash_table_add(graph->path_nodes, GUINT_TO_POINTER(next->id));
+
+            if (next->is_device) {
+                add_hop(graph, next, PW_GRAPH_HOP_DEVICE, from, &last_rate, &last_channels);
+                break;
+            }
+
+            // A virtual sink either hands the audio to its link-group partner,
+            // passes its monitor on, or is where the audio ends
+            PwGraphNode *partner = link_group_partner(graph, next);
+            gboolean forwards = partner || next_node(graph, next);
+            add_hop(graph, next, forwards ? PW_GRAPH_HOP_FILTER : PW_GRAPH_HOP_SINK,
+                    from, &last_rate, &last_channels);
+            if (!forwards) break;
+
+            if (partner) {
+                g_hash_table_add(graph->path_nodes, GUINT_TO_POINTER(partner->id));
+                next = partner;
+            }
+            from = next->id;
+            node = next;
+        }
+    }
+
+    GString *text = g_string_new(NULL);
+    guint32 prev_rate = 0;
+    guint prev_channels = 0;
+    for (guint i = 0; i < graph->hop_count; i++) {
+        const PwGraphHop *hop = &graph->hops[i];
+        if (i > 0) g_string_append(text, " → ");
+        append_hop_text(text, hop, prev_rate, prev_channels);
+        if (hop->rate > 0) prev_rate = hop->rate;
+        if (hop->channels > 0) prev_channels = hop->channels;
+    }
+
+    gboolean changed = !g_string_equal(text, graph->text);
+    g_string_free(graph->text, TRUE);
+    graph->text = text;
+    return changed;
+}
+
+guint pw_graph_get_path(PwGraph *graph, const PwGraphHop **hops) {
+    if (hops) *hops = graph->hops;
+    return graph->hop_count;
+}
+
+const gchar* pw_graph_get_path_text(PwGraph *graph) {
+    return graph->text->str;
+}
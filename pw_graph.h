@@ -0,0 +1,86 @@
+#ifndef PW_GRAPH_H
+#define PW_GRAPH_H
+
+#include <glib.h>
+#include <spa/utils/dict.h>
+
+/**
+ * PipeWire Signal-Path Graph
+ *
+ * An in-memory mirror of the audio nodes, ports and links announced by the
+ * registry, indexed by node so that the path from the player's stream to
+ * the hardware device is walked link by link instead of rescanning every
+ * global. The path is only recomputed when a change touches a node on it
+ * (or a sink it passes through gains or loses another stream).
+ *
+ * Each hop records what happens to the audio there: filter-chain and
+ * loopback halves (joined by node.link-group), resampling and channel
+ * remixing (from known rates and port counts), software volume, and other
+ * streams mixed into the same sink.
+ *
+ * Plain GLib; fed from registry callbacks on the PipeWire thread loop and
+ * not thread-safe by itself.
+ */
+
+#define PW_GRAPH_MAX_HOPS 16
+
+typedef enum {
+    PW_GRAPH_HOP_SOURCE,          // The player's stream
+    PW_GRAPH_HOP_FILTER,          // Virtual sink whose link-group partner re-emits the audio
+    PW_GRAPH_HOP_SINK,            // Virtual sink that goes nowhere
+    PW_GRAPH_HOP_DEVICE,          // Hardware sink (end of the path)
+} PwGraphHopKind;
+
+typedef struct {
+    guint32 node_id;
+    PwGraphHopKind kind;
+    const gchar *name;            // Owned by the graph, valid until the next change
+    guint32 rate;                 // 0 = unknown
+    guint channels;               // 0 = unknown
+    gboolean resampled;           // Rate differs from the previous known rate
+    gboolean remixed;             // Channel count differs from the previous hop
+    gboolean soft_volume;         // Volume or mute applied in software here
+    guint mixed_in;               // Other streams feeding this sink
+} PwGraphHop;
+
+typedef struct PwGraph PwGraph;
+
+PwGraph* pw_graph_new(void);
+void pw_graph_free(PwGraph *graph);
+
+// Registry globals (props as announced); other types are ignored
+void pw_graph_add_node(PwGraph *graph, guint32 id, const struct spa_dict *props);
+void pw_graph_add_port(PwGraph *graph, guint32 id, const struct spa_dict *props);
+void pw_graph_add_link(PwGraph *graph, guint32 id, const struct spa_dict *props);
+
+// A global of any type went away
+void pw_graph_remove(PwGraph *graph, guint32 id);
+
+// Negotiated format and volume state learned from node params
+void pw_graph_set_node_format(PwGraph *graph, guint32 id, guint32 rate, guint channels);
+void pw_graph_set_node_soft_volume(PwGraph *graph, guint32 id, gboolean soft_volume);
+
+// Sink `node_id` is linked to right now (0 = none or not linked yet)
+guint32 pw_graph_get_linked_sink(PwGraph *graph, guint32 node_id);
+
+// Whether link `link_id` starts or ends at `node_id` (FALSE if it is not a known link)
+gboolean pw_graph_link_touches(PwGraph *graph, guint32 link_id, guint32 node_id);
+
+// Node the path starts from (0 = none)
+void pw_graph_set_source(PwGraph *graph, guint32 node_id);
+
+/**
+ * Recompute the path if anything on it changed.
+ *
+ * @return TRUE if the path text changed since the last call
+ */
+gboolean pw_graph_update_path(PwGraph *graph);
+
+// Current path; hops are valid until the next graph change
+guint pw_graph_get_path(PwGraph *graph, const PwGraphHop **hops);
+
+// "Spotify (44.1 kHz, 2ch) → resampled to 48 kHz → EasyEffects [filter] → ..."
+// Empty when there is no source
+const gchar* pw_graph_get_path_text(PwGraph *graph);
+
+#endif // PW_GRAPH_H
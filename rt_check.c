@@ -0,0 +1,84 @@
+#define _GNU_SOURCE
+#include "rt_health.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <glib.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+/**
+ * RT-Thread Allocation / Lock Traps (`make debug` only)
+ *
+ * Interposes the allocator and mutex locks for the whole process. While the
+ * PipeWire process callback runs (rt_health_in_callback), every allocation
+ * or free and every lock that would have to wait is counted in rt_health.c.
+ * With HYPRWAVE_RT_ABORT set in the environment the process aborts instead,
+ * so a debugger lands on the offending call.
+ *
+ * GMutex does not go through pthread on Linux, so g_mutex_lock is wrapped
+ * as well. Locks taken inside GLib itself may bypass the wrapper.
+ */
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static int abort_on_trap = -1;
+
+static void trap(void (*count)(void)) {
+    count();
+    if (abort_on_trap < 0) {
+        abort_on_trap = secure_getenv("HYPRWAVE_RT_ABORT") != NULL;
+    }
+    if (abort_on_trap) {
+        abort();
+    }
+}
+
+void *malloc(size_t size) {
+    if (rt_health_in_callback) trap(rt_health_trap_allocation);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    if (rt_health_in_callback) trap(rt_health_trap_allocation);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (rt_health_in_callback) trap(rt_health_trap_allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (ptr && rt_health_in_callback) trap(rt_health_trap_allocation);
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+    static int (*real_lock)(pthread_mutex_t *) = NULL;
+    if (!real_lock) {
+        real_lock = (int (*)(pthread_mutex_t *))dlsym(RTLD_NEXT, "pthread_mutex_lock");
+    }
+
+    if (rt_health_in_callback) {
+        int res = pthread_mutex_trylock(mutex);
+        if (res != EBUSY) return res;
+        trap(rt_health_trap_mutex_wait);
+    }
+    return real_lock(mutex);
+}
+
+void g_mutex_lock(GMutex *mutex) {
+    static void (*real_lock)(GMutex *) = NULL;
+    if (!real_lock) {
+        real_lock = (void (*)(GMutex *))dlsym(RTLD_NEXT, "g_mutex_lock");
+    }
+
+    if (rt_health_in_callback) {
+        if (g_mutex_trylock(mutex)) return;
+        trap(rt_health_trap_mutex_wait);
+    }
+    real_lock(mutex);
+}
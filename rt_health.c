@@ -0,0 +1,101 @@
+#include "rt_health.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+_Thread_local int rt_health_in_callback = 0;
+atomic_uint rt_health_allocations = 0;
+atomic_uint rt_health_mutex_waits = 0;
+
+static inline void bump(atomic_uint *counter) {
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static inline unsigned load(const atomic_uint *counter) {
+    return atomic_load_explicit((atomic_uint *)counter, memory_order_relaxed);
+}
+
+void rt_health_init(RtHealth *health) {
+    memset(health, 0, sizeof(*health));
+}
+
+uint64_t rt_health_begin(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    rt_health_in_callback = 1;
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void rt_health_end(RtHealth *health, uint64_t start_ns) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    rt_health_in_callback = 0;
+
+    uint64_t elapsed = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec - start_ns;
+    uint64_t us = elapsed / 1000;
+    int bucket = 0;
+    while (us > 0 && bucket < RT_HEALTH_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    bump(&health->histogram[bucket]);
+    bump(&health->callbacks);
+
+    unsigned ns = elapsed > UINT32_MAX ? UINT32_MAX : (unsigned)elapsed;
+    if (ns > load(&health->max_ns)) {
+        atomic_store_explicit(&health->max_ns, ns, memory_order_relaxed);
+    }
+}
+
+void rt_health_cycle(RtHealth *health, uint64_t position, uint64_t duration) {
+    if (health->last_duration > 0 && position > health->last_position + health->last_duration) {
+        uint64_t missed = (position - health->last_position) / health->last_duration - 1;
+        if (missed > 0) {
+            atomic_fetch_add_explicit(&health->missed_quanta, (unsigned)missed, memory_order_relaxed);
+        }
+    }
+    health->last_position = position;
+    health->last_duration = duration;
+}
+
+void rt_health_buffer(RtHealth *health, uint32_t n_frames) {
+    if (n_frames == 0) {
+        bump(&health->null_data);
+        return;
+    }
+    if (n_frames < health->last_frames) {
+        bump(&health->short_chunks);
+    }
+    health->last_frames = n_frames;
+}
+
+void rt_health_trap_allocation(void) {
+    bump(&rt_health_allocations);
+}
+
+void rt_health_trap_mutex_wait(void) {
+    bump(&rt_health_mutex_waits);
+}
+
+int rt_health_format(const RtHealth *health, char *buf, size_t len) {
+    unsigned callbacks = load(&health->callbacks);
+    int n = snprintf(buf, len,
+                     "callbacks: %u  max: %.1f us\n"
+                     "no buffer: %u  null data: %u  short chunks: %u  missed quanta: %u\n"
+                     "RT allocations: %u  RT mutex waits: %u\n"
+                     "durations:",
+                     callbacks, load(&health->max_ns) / 1000.0,
+                     load(&health->no_buffer), load(&health->null_data),
+                     load(&health->short_chunks), load(&health->missed_quanta),
+                     load(&rt_health_allocations), load(&rt_health_mutex_waits));
+
+    for (int b = 0; b < RT_HEALTH_BUCKETS; b++) {
+        unsigned count = load(&health->histogram[b]);
+        if (count == 0) continue;
+        size_t used = n > 0 && (size_t)n < len ? (size_t)n : len;
+        unsigned lo = b == 0 ? 0 : 1u << (b - 1);
+        n += snprintf(buf + used, len - used, "\n  %5u-%-5u us %10u (%.2f%%)",
+                      lo, 1u << b, count, callbacks ? 100.0 * count / callbacks : 0.0);
+    }
+    return n;
+}
@@ -0,0 +1,68 @@
+#ifndef RT_HEALTH_H
+#define RT_HEALTH_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * RT Callback Health
+ *
+ * Counters for the PipeWire process callback, written lock-free from the
+ * data thread (relaxed atomics, single writer) and read from anywhere:
+ *  - a log2 histogram of callback durations (<1 us, 1-2 us, ... >=16 ms)
+ *    and the worst one seen;
+ *  - buffers that could not be dequeued, came without data, or carried
+ *    fewer frames than the previous cycle;
+ *  - quanta the graph clock advanced past without calling us (xruns).
+ *
+ * In a `make debug` build rt_check.c interposes malloc/free and mutex
+ * locks, and every allocation or contended lock made while
+ * rt_health_in_callback is set lands in rt_health_allocations /
+ * rt_health_mutex_waits.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define RT_HEALTH_BUCKETS 16            // Bucket b >= 1 holds [2^(b-1), 2^b) us
+
+typedef struct {
+    atomic_uint callbacks;
+    atomic_uint histogram[RT_HEALTH_BUCKETS];
+    atomic_uint max_ns;
+    atomic_uint no_buffer;              // pw_stream_dequeue_buffer() returned NULL
+    atomic_uint null_data;              // datas[0].data == NULL
+    atomic_uint short_chunks;           // Fewer frames than the previous buffer
+    atomic_uint missed_quanta;          // Clock position jumped by more than one cycle
+
+    // Data thread only
+    uint64_t last_position;
+    uint64_t last_duration;
+    uint32_t last_frames;
+} RtHealth;
+
+// Set while the process callback runs on this thread (read by rt_check.c)
+extern _Thread_local int rt_health_in_callback;
+extern atomic_uint rt_health_allocations;
+extern atomic_uint rt_health_mutex_waits;
+
+void rt_health_init(RtHealth *health);
+
+// Bracket the process callback; begin returns the start time in ns
+uint64_t rt_health_begin(void);
+void rt_health_end(RtHealth *health, uint64_t start_ns);
+
+// Graph clock of this cycle (spa_io_position clock.position / duration, in samples)
+void rt_health_cycle(RtHealth *health, uint64_t position, uint64_t duration);
+
+// A buffer carried n_frames (0 = no data)
+void rt_health_buffer(RtHealth *health, uint32_t n_frames);
+
+// Called by the debug interposers
+void rt_health_trap_allocation(void);
+void rt_health_trap_mutex_wait(void);
+
+// Human-readable summary; returns the length written (like snprintf)
+int rt_health_format(const RtHealth *health, char *buf, size_t len);
+
+#endif // RT_HEALTH_H
@@ -0,0 +1,119 @@
+#include "spectrogram.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void spectrogram_init(Spectrogram *spec) {
+    memset(spec, 0, sizeof(*spec));
+}
+
+void spectrogram_configure(Spectrogram *spec, uint32_t rate, uint32_t channels) {
+    spec->rate = rate;
+    spec->channels = channels;
+    if (rate == 0 || channels == 0) {
+        spec->rate = 0;
+        return;
+    }
+
+    uint32_t n = fft_floor_pow2(rate * SPECTROGRAM_WINDOW_MS / 1000);
+    fft_plan(&spec->plan, n);
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        spec->window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / (n - 1)));
+        sum += spec->window[i];
+    }
+    spec->window_gain = (float)(2.0 / sum);
+
+    spec->hop = rate * SPECTROGRAM_COLUMN_MS / 1000;
+    if (spec->hop == 0) spec->hop = 1;
+
+    // Log-spaced rows; each covers at least one bin
+    double top = SPECTROGRAM_MAX_HZ;
+    if (top > rate * 0.5) top = rate * 0.5;
+    double ratio = pow(top / SPECTROGRAM_MIN_HZ, 1.0 / SPECTROGRAM_ROWS);
+    double bin_hz = (double)rate / n;
+    for (int r = 0; r < SPECTROGRAM_ROWS; r++) {
+        double lo = SPECTROGRAM_MIN_HZ * pow(ratio, r);
+        double hi = lo * ratio;
+        uint32_t first = (uint32_t)floor(lo / bin_hz + 0.5);
+        uint32_t last = (uint32_t)floor(hi / bin_hz + 0.5);
+        if (first < 1) first = 1;
+        if (last > n / 2) last = n / 2;
+        if (last < first) last = first;
+        spec->row_first[r] = first;
+        spec->row_last[r] = last;
+    }
+
+    spectrogram_reset(spec);
+}
+
+void spectrogram_reset(Spectrogram *spec) {
+    memset(spec->history, 0, sizeof(spec->history));
+    spec->history_pos = 0;
+    spec->hop_pos = 0;
+    spec->pending_count = 0;
+}
+
+void spectrogram_clear_pending(Spectrogram *spec) {
+    spec->pending_count = 0;
+}
+
+// FFT the most recent window and append one column
+static void emit_column(Spectrogram *spec) {
+    const uint32_t n = spec->plan.n;
+    const uint32_t mask = n - 1;
+
+    // Oldest sample first: history_pos is the next write slot
+    for (uint32_t i = 0; i < n; i++) {
+        spec->re[i] = spec->history[(spec->history_pos + i) & mask] * spec->window[i];
+        spec->im[i] = 0.0f;
+    }
+    fft_forward(&spec->plan, spec->re, spec->im);
+
+    if (spec->pending_count >= SPECTROGRAM_PENDING) {
+        spec->dropped++;
+        return;
+    }
+    uint8_t *column = spec->pending[spec->pending_count++];
+
+    for (int r = 0; r < SPECTROGRAM_ROWS; r++) {
+        float peak = 0.0f;
+        for (uint32_t b = spec->row_first[r]; b <= spec->row_last[r]; b++) {
+            float power = spec->re[b] * spec->re[b] + spec->im[b] * spec->im[b];
+            if (power > peak) peak = power;
+        }
+
+        double db = peak > 0.0f ? 20.0 * log10(sqrt(peak) * spec->window_gain) : SPECTROGRAM_FLOOR_DB;
+        double level = (db - SPECTROGRAM_FLOOR_DB) / -SPECTROGRAM_FLOOR_DB;
+        if (level < 0.0) level = 0.0;
+        if (level > 1.0) level = 1.0;
+        column[r] = (uint8_t)(level * 255.0 + 0.5);
+    }
+}
+
+void spectrogram_process(Spectrogram *spec, const float *samples, size_t n_frames, uint32_t stride) {
+    if (spec->rate == 0 || spec->plan.n == 0) return;
+
+    const uint32_t channels = spec->channels;
+    const uint32_t mask = spec->plan.n - 1;
+    const float scale = 1.0f / (float)channels;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * stride;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; c++) {
+            sum += frame[c];
+        }
+        spec->history[spec->history_pos] = sum * scale;
+        spec->history_pos = (spec->history_pos + 1) & mask;
+
+        if (++spec->hop_pos >= spec->hop) {
+            spec->hop_pos = 0;
+            emit_column(spec);
+        }
+    }
+}
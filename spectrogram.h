@@ -0,0 +1,68 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fft.h"
+
+/**
+ * Spectrogram Analysis
+ *
+ * Turns the native-rate stream into spectrogram columns: every
+ * SPECTROGRAM_COLUMN_MS a Hann-windowed FFT of the mono downmix is folded
+ * onto SPECTROGRAM_ROWS log-spaced frequency rows and quantized to 0-255
+ * (SPECTROGRAM_FLOOR_DB .. 0 dBFS). Finished columns queue up in `pending`
+ * until the caller takes them.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency; never allocates.
+ */
+
+#define SPECTROGRAM_ROWS 64
+#define SPECTROGRAM_COLUMN_MS 20
+#define SPECTROGRAM_WINDOW_MS 85       // FFT length target (rounded down to a power of two)
+#define SPECTROGRAM_PENDING 64
+#define SPECTROGRAM_MIN_HZ 30.0
+#define SPECTROGRAM_MAX_HZ 20000.0
+#define SPECTROGRAM_FLOOR_DB (-90.0)
+
+typedef struct {
+    uint32_t rate;                     // 0 until configured
+    uint32_t channels;
+
+    FftPlan plan;
+    float window[FFT_MAX_SIZE];
+    float window_gain;                 // Converts |X| to full-scale-sine amplitude
+    float history[FFT_MAX_SIZE];       // Circular mono input
+    uint32_t history_pos;
+    float re[FFT_MAX_SIZE];
+    float im[FFT_MAX_SIZE];
+
+    uint32_t hop;                      // Input frames per column
+    uint32_t hop_pos;
+
+    // FFT bin range folded into each row (row 0 = lowest frequency)
+    uint32_t row_first[SPECTROGRAM_ROWS];
+    uint32_t row_last[SPECTROGRAM_ROWS];
+
+    // Finished columns, oldest first
+    uint8_t pending[SPECTROGRAM_PENDING][SPECTROGRAM_ROWS];
+    uint32_t pending_count;
+    uint32_t dropped;                  // Columns lost because nobody took them
+} Spectrogram;
+
+// Zero all state; the analyzer ignores input until spectrogram_configure()
+void spectrogram_init(Spectrogram *spec);
+
+// Apply a negotiated format: plans the FFT and the row layout for this rate
+void spectrogram_configure(Spectrogram *spec, uint32_t rate, uint32_t channels);
+
+// Clear input history and pending columns (format is kept)
+void spectrogram_reset(Spectrogram *spec);
+
+// Feed interleaved F32 frames with `stride` floats per frame (>= channels)
+void spectrogram_process(Spectrogram *spec, const float *samples, size_t n_frames, uint32_t stride);
+
+// Forget pending columns once the caller has copied them
+void spectrogram_clear_pending(Spectrogram *spec);
+
+#endif // SPECTROGRAM_H
@@ -0,0 +1,226 @@
+#include "transform_bin.h"
+
+struct _TransformBin {
+    GtkWidget parent_instance;
+
+    GtkWidget *child;
+
+    gboolean morphing;
+    gdouble progress;
+    gdouble from_width;           // Size shown when the morph began
+    gdouble from_height;
+    gint hold_width;              // Bin size when the morph began; the old frame
+    gint hold_height;             // was drawn at this size
+    GskRenderNode *from_node;     // What was on screen when the morph began
+    GskRenderNode *last_node;     // Last frame drawn, for the next morph
+
+    gdouble offset_x;             // Drawing shift (transform_bin_set_offset)
+    gdouble offset_y;
+};
+
+G_DEFINE_FINAL_TYPE(TransformBin, transform_bin, GTK_TYPE_WIDGET)
+
+// Size of the area shown right now
+static void get_drawn_size(TransformBin *self, gdouble *width, gdouble *height) {
+    gdouble to_width = gtk_widget_get_width(self->child);
+    gdouble to_height = gtk_widget_get_height(self->child);
+
+    if (!self->morphing) {
+        *width = to_width;
+        *height = to_height;
+        return;
+    }
+    *width = self->from_width + (to_width - self->from_width) * self->progress;
+    *height = self->from_height + (to_height - self->from_height) * self->progress;
+}
+
+static void transform_bin_measure(GtkWidget *widget, GtkOrientation orientation, int for_size,
+                                  int *minimum, int *natural,
+                                  int *minimum_baseline, int *natural_baseline) {
+    TransformBin *self = TRANSFORM_BIN(widget);
+
+    *minimum = *natural = 0;
+    if (!self->child || !gtk_widget_should_layout(self->child)) return;
+
+    if (!self->morphing) {
+        gtk_widget_measure(self->child, orientation, for_size, minimum, natural,
+                           minimum_baseline, natural_baseline);
+        return;
+    }
+
+    // Big enough for both the old and the new size on each axis, so a
+    // growing axis is configured once at the start, a shrinking one once
+    // at the end, and the clip never runs past the surface
+    int child_size;
+    gtk_widget_measure(self->child, orientation, -1, NULL, &child_size, NULL, NULL);
+    int hold = orientation == GTK_ORIENTATION_HORIZONTAL ? self->hold_width : self->hold_height;
+    *minimum = *natural = MAX(hold, child_size);
+}
+
+static void transform_bin_size_allocate(GtkWidget *widget, int width, int height, int baseline) {
+    TransformBin *self = TRANSFORM_BIN(widget);
+
+    if (!self->child || !gtk_widget_should_layout(self->child)) return;
+
+    if (!self->morphing) {
+        gtk_widget_allocate(self->child, width, height, baseline, NULL);
+        return;
+    }
+
+    // The child gets its final size right away, centered; it may overhang the bin
+    int child_width, child_height;
+    gtk_widget_measure(self->child, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &child_width, NULL, NULL);
+    gtk_widget_measure(self->child, GTK_ORIENTATION_VERTICAL, child_width, NULL, &child_height, NULL, NULL);
+
+    GskTransform *transform = gsk_transform_translate(NULL,
+        &GRAPHENE_POINT_INIT((width - child_width) / 2.0f, (height - child_height) / 2.0f));
+    gtk_widget_allocate(self->child, child_width, child_height, -1, transform);
+}
+
+// Old frame fading into the laid-out child, both unscaled, inside a clip
+// that goes from the old size to the new one
+static void snapshot_morph(TransformBin *self, GtkSnapshot *snapshot) {
+    GtkWidget *widget = GTK_WIDGET(self);
+    gdouble width, height;
+    get_drawn_size(self, &width, &height);
+
+    gdouble center_x = gtk_widget_get_width(widget) / 2.0;
+    gdouble center_y = gtk_widget_get_height(widget) / 2.0;
+    gtk_snapshot_push_clip(snapshot, &GRAPHENE_RECT_INIT(center_x - width / 2.0, center_y - height / 2.0,
+                                                         width, height));
+    gtk_snapshot_push_cross_fade(snapshot, self->progress);
+    if (self->from_node) {
+        // The old frame stays centered if the bin grew for the new size
+        gtk_snapshot_save(snapshot);
+        gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(center_x - self->hold_width / 2.0,
+                                                              center_y - self->hold_height / 2.0));
+        gtk_snapshot_append_node(snapshot, self->from_node);
+        gtk_snapshot_restore(snapshot);
+    }
+    gtk_snapshot_pop(snapshot);
+    gtk_widget_snapshot_child(widget, self->child, snapshot);
+    gtk_snapshot_pop(snapshot);
+    gtk_snapshot_pop(snapshot);
+}
+
+static void transform_bin_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    TransformBin *self = TRANSFORM_BIN(widget);
+
+    if (!self->child) return;
+
+    GtkSnapshot *content = gtk_snapshot_new();
+    if (self->morphing && self->progress < 1.0) {
+        snapshot_morph(self, content);
+    } else {
+        gtk_widget_snapshot_child(widget, self->child, content);
+    }
+    GskRenderNode *node = gtk_snapshot_free_to_node(content);
+
+    // The next morph fades out from exactly this frame
+    g_clear_pointer(&self->last_node, gsk_render_node_unref);
+    if (!node) return;
+    self->last_node = gsk_render_node_ref(node);
+
+    gtk_snapshot_save(snapshot);
+    if (self->offset_x != 0.0 || self->offset_y != 0.0) {
+        gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(self->offset_x, self->offset_y));
+    }
+    gtk_snapshot_append_node(snapshot, node);
+    gtk_snapshot_restore(snapshot);
+    gsk_render_node_unref(node);
+}
+
+static void transform_bin_dispose(GObject *object) {
+    TransformBin *self = TRANSFORM_BIN(object);
+
+    g_clear_pointer(&self->child, gtk_widget_unparent);
+    g_clear_pointer(&self->from_node, gsk_render_node_unref);
+    g_clear_pointer(&self->last_node, gsk_render_node_unref);
+
+    G_OBJECT_CLASS(transform_bin_parent_class)->dispose(object);
+}
+
+static void transform_bin_class_init(TransformBinClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+
+    object_class->dispose = transform_bin_dispose;
+    widget_class->measure = transform_bin_measure;
+    widget_class->size_allocate = transform_bin_size_allocate;
+    widget_class->snapshot = transform_bin_snapshot;
+    gtk_widget_class_set_css_name(widget_class, "transform-bin");
+}
+
+static void transform_bin_init(TransformBin *self) {
+    self->child = NULL;
+    self->morphing = FALSE;
+    self->progress = 0.0;
+    self->from_node = NULL;
+    self->last_node = NULL;
+    self->offset_x = 0.0;
+    self->offset_y = 0.0;
+}
+
+GtkWidget* transform_bin_new(GtkWidget *child) {
+    g_return_val_if_fail(GTK_IS_WIDGET(child), NULL);
+
+    TransformBin *self = g_object_new(TRANSFORM_TYPE_BIN, NULL);
+    self->child = child;
+    gtk_widget_set_parent(child, GTK_WIDGET(self));
+
+    // Sit where the child would have
+    gtk_widget_set_halign(GTK_WIDGET(self), gtk_widget_get_halign(child));
+    gtk_widget_set_valign(GTK_WIDGET(self), gtk_widget_get_valign(child));
+    gtk_widget_set_hexpand(GTK_WIDGET(self), gtk_widget_get_hexpand(child));
+    gtk_widget_set_vexpand(GTK_WIDGET(self), gtk_widget_get_vexpand(child));
+    return GTK_WIDGET(self);
+}
+
+void transform_bin_begin_morph(TransformBin *bin) {
+    g_return_if_fail(TRANSFORM_IS_BIN(bin));
+
+    // Never laid out: nothing to morph from
+    if (!bin->child || gtk_widget_get_width(bin->child) <= 0) {
+        transform_bin_end_morph(bin);
+        return;
+    }
+
+    // Start from wherever a running morph has got to; the surface keeps at
+    // least the size it has until transform_bin_end_morph()
+    get_drawn_size(bin, &bin->from_width, &bin->from_height);
+    bin->hold_width = gtk_widget_get_width(GTK_WIDGET(bin));
+    bin->hold_height = gtk_widget_get_height(GTK_WIDGET(bin));
+    g_clear_pointer(&bin->from_node, gsk_render_node_unref);
+    if (bin->last_node) bin->from_node = gsk_render_node_ref(bin->last_node);
+
+    bin->morphing = TRUE;
+    bin->progress = 0.0;
+    gtk_widget_queue_resize(GTK_WIDGET(bin));
+}
+
+void transform_bin_set_progress(TransformBin *bin, gdouble progress) {
+    g_return_if_fail(TRANSFORM_IS_BIN(bin));
+
+    if (!bin->morphing) return;
+    bin->progress = CLAMP(progress, 0.0, 1.0);
+    gtk_widget_queue_draw(GTK_WIDGET(bin));
+}
+
+void transform_bin_end_morph(TransformBin *bin) {
+    g_return_if_fail(TRANSFORM_IS_BIN(bin));
+
+    if (!bin->morphing) return;
+    bin->morphing = FALSE;
+    bin->progress = 1.0;
+    g_clear_pointer(&bin->from_node, gsk_render_node_unref);
+    gtk_widget_queue_resize(GTK_WIDGET(bin));
+}
+
+void transform_bin_set_offset(TransformBin *bin, gdouble x, gdouble y) {
+    g_return_if_fail(TRANSFORM_IS_BIN(bin));
+
+    if (bin->offset_x == x && bin->offset_y == y) return;
+    bin->offset_x = x;
+    bin->offset_y = y;
+    gtk_widget_queue_draw(GTK_WIDGET(bin));
+}
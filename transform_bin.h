@@ -0,0 +1,42 @@
+#ifndef TRANSFORM_BIN_H
+#define TRANSFORM_BIN_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Transform Bin
+ *
+ * Single-child container that morphs its child between sizes without
+ * relaying the window out on every frame. Between begin and end of a morph
+ * the child is laid out once at its new size while the bin keeps the larger
+ * of its old and new size on each axis, so the surface grows once when the
+ * morph begins and shrinks once when it ends. Nothing is
+ * scaled: the last frame before the morph crossfades into the child, both
+ * drawn at their real size inside a clip going from the old size to the
+ * new one.
+ *
+ * The child can also be drawn shifted by an offset, e.g. to slide it in
+ * from outside its surface. Offsets only move the drawing; input still
+ * hits the laid-out position.
+ *
+ * Progress is driven from outside (see animation.h).
+ */
+
+#define TRANSFORM_TYPE_BIN (transform_bin_get_type())
+G_DECLARE_FINAL_TYPE(TransformBin, transform_bin, TRANSFORM, BIN, GtkWidget)
+
+GtkWidget* transform_bin_new(GtkWidget *child);
+
+// Remember the child's size on screen now; change its size request after this
+void transform_bin_begin_morph(TransformBin *bin);
+
+// Draw the morph part way (0 = old frame and size, 1 = new); only redraws
+void transform_bin_set_progress(TransformBin *bin, gdouble progress);
+
+// Drop the old size and commit the new one
+void transform_bin_end_morph(TransformBin *bin);
+
+// Draw the child shifted by (x, y) pixels; only redraws
+void transform_bin_set_offset(TransformBin *bin, gdouble x, gdouble y);
+
+#endif // TRANSFORM_BIN_H
@@ -1,13 +1,17 @@
 #include "vertical_display.h"
+#include "animation.h"
+#include "dot_matrix.h"
 #include <string.h>
-#include <ctype.h>
 
 #define SCROLL_INTERVAL_MS 200
 #define VISIBLE_LINES 8
 #define PAUSE_ANIMATION_FRAMES 4
+#define PAUSE_ANIMATION_CYCLES 2  // Then the PAUSED frame stays still
 
 // Forward declarations
 static gboolean scroll_animation(gpointer user_data);
+static void start_scroll(VerticalDisplayState *state);
+static void sync_timer_ticker(VerticalDisplayState *state);
 
 // Paused animation frames - SHORTER (remove extra newlines)
 static const gchar* PAUSE_FRAMES[] = {
@@ -17,52 +21,69 @@ static const gchar* PAUSE_FRAMES[] = {
     "P\nA\nU\nS\nE\nD\n⣏"
 };
 
-// Sanitize text
+// Uppercase and keep letters and digits of any script plus a little
+// punctuation. Accented Latin becomes the plain ASCII the display font has
+// (É → E, ß → SS); other scripts are kept and drawn with fallback fonts.
 static gchar* sanitize_text(const gchar *text) {
-    if (!text || strlen(text) == 0) return g_strdup("UNKNOWN");
+    if (!text || *text == '\0') return g_strdup("UNKNOWN");
     
     GString *result = g_string_new("");
     
-    for (gsize i = 0; i < strlen(text); i++) {
-        char c = text[i];
-        if (isalnum(c) || c == ' ' || c == '-' || c == '\'' || c == '&') {
-            g_string_append_c(result, c);
+    for (const gchar *p = text; *p; p = g_utf8_next_char(p)) {
+        gunichar c = g_utf8_get_char(p);
+        if (!g_unichar_isalnum(c) && c != ' ' && c != '-' && c != '\'' && c != '&') continue;
+        
+        if (c >= 0x80 && g_unichar_get_script(c) == G_UNICODE_SCRIPT_LATIN) {
+            gchar utf8[8];
+            utf8[g_unichar_to_utf8(c, utf8)] = '\0';
+            gchar *ascii = g_str_to_ascii(utf8, "C");
+            for (const gchar *a = ascii; *a; a++) {
+                if (g_ascii_isalnum(*a)) g_string_append_c(result, g_ascii_toupper(*a));
+            }
+            g_free(ascii);
+        } else {
+            g_string_append_unichar(result, g_unichar_toupper(c));
         }
     }
     
-    gchar *sanitized = g_string_free(result, FALSE);
-    if (strlen(sanitized) < 2) {
-        g_free(sanitized);
+    if (result->len == 0) {
+        g_string_free(result, TRUE);
         return g_strdup("UNKNOWN");
     }
     
-    return sanitized;
+    return g_string_free(result, FALSE);
 }
 
-// Format text vertically
-static gchar* format_vertical_text(const gchar *text) {
-    if (!text || strlen(text) == 0) return g_strdup("");
-    
+// Append text to the line table, one character per line (a space is two blank lines)
+static void append_vertical_lines(GPtrArray *lines, const gchar *text) {
     gchar *clean_text = sanitize_text(text);
-    GString *result = g_string_new("");
     
-    for (gsize i = 0; i < strlen(clean_text); i++) {
-        char c = clean_text[i];
-        
-        if (c >= 'a' && c <= 'z') {
-            c = c - 32;
-        }
-        
-        if (c == ' ') {
-            g_string_append(result, "\n\n");
+    for (const gchar *p = clean_text; *p; p = g_utf8_next_char(p)) {
+        if (*p == ' ') {
+            g_ptr_array_add(lines, g_strdup(""));
+            g_ptr_array_add(lines, g_strdup(""));
         } else {
-            g_string_append_c(result, c);
-            g_string_append_c(result, '\n');
+            g_ptr_array_add(lines, g_strndup(p, g_utf8_next_char(p) - p));
         }
     }
     
     g_free(clean_text);
-    return g_string_free(result, FALSE);
+}
+
+// Build SONG + BY + ARTIST once per track; scrolling only moves through it
+static void build_scroll_column(VerticalDisplayState *state) {
+    if (state->scroll_lines) {
+        g_ptr_array_unref(state->scroll_lines);
+    }
+    state->scroll_lines = g_ptr_array_new_with_free_func(g_free);
+    
+    append_vertical_lines(state->scroll_lines, state->current_title);
+    g_ptr_array_add(state->scroll_lines, g_strdup(""));
+    g_ptr_array_add(state->scroll_lines, g_strdup("B"));
+    g_ptr_array_add(state->scroll_lines, g_strdup("Y"));
+    g_ptr_array_add(state->scroll_lines, g_strdup(""));
+    append_vertical_lines(state->scroll_lines, state->current_artist);
+    g_ptr_array_add(state->scroll_lines, g_strdup(""));
 }
 
 // Format time vertically
@@ -76,18 +97,25 @@ static gchar* format_vertical_time(gint64 position_us, gint64 length_us) {
                           seconds / 10, seconds % 10);
 }
 
-// Status animation (PAUSED loop)
+// Status animation (PAUSED, loops a few times)
 static gboolean animate_paused(gpointer user_data) {
     VerticalDisplayState *state = (VerticalDisplayState *)user_data;
     
     // Only animate if still in PAUSED mode
     if (state->current_mode != DISPLAY_MODE_STATUS_PAUSED) {
-        state->status_animation_timer = 0;
+        state->status_ticker = 0;
         return G_SOURCE_REMOVE;
     }
     
+    // Settle on the first frame so a paused player wakes nothing
+    if (state->animation_frame >= PAUSE_ANIMATION_FRAMES * PAUSE_ANIMATION_CYCLES) {
+        dot_matrix_set_text(DOT_MATRIX(state->display), PAUSE_FRAMES[0]);
+        state->status_ticker = 0;
+        return G_SOURCE_REMOVE;
+    }
+
     const gchar *frame = PAUSE_FRAMES[state->animation_frame % PAUSE_ANIMATION_FRAMES];
-    gtk_label_set_text(GTK_LABEL(state->label), frame);
+    dot_matrix_set_text(DOT_MATRIX(state->display), frame);
     
     state->animation_frame++;
     return G_SOURCE_CONTINUE;
@@ -100,21 +128,22 @@ static gboolean show_playing_status(gpointer user_data) {
     if (state->animation_frame >= 4) {  // Show for 1 second (4 frames * 250ms)
         // Switch back to timer mode
         state->current_mode = DISPLAY_MODE_TIME;
-        state->status_animation_timer = 0;
+        state->status_ticker = 0;
         
         // Show current time
         gchar *time_text = format_vertical_time(state->current_position, state->track_length);
-        gtk_label_set_text(GTK_LABEL(state->label), time_text);
+        dot_matrix_set_text(DOT_MATRIX(state->display), time_text);
         g_free(time_text);
+        sync_timer_ticker(state);
         
         return G_SOURCE_REMOVE;
     }
     
     // Alternate between PLAYING and blank
 if (state->animation_frame % 2 == 0) {
-    gtk_label_set_text(GTK_LABEL(state->label), "P\nL\nA\nY\n▶");  // Removed extra \n
+    dot_matrix_set_text(DOT_MATRIX(state->display), "P\nL\nA\nY\n▶");  // Removed extra \n
 } else {
-    gtk_label_set_text(GTK_LABEL(state->label), "P\nL\nA\nY\n◆");
+    dot_matrix_set_text(DOT_MATRIX(state->display), "P\nL\nA\nY\n◆");
 }
     state->animation_frame++;
     return G_SOURCE_CONTINUE;
@@ -125,19 +154,17 @@ static gboolean show_skip_status(gpointer user_data) {
     VerticalDisplayState *state = (VerticalDisplayState *)user_data;
     
     if (state->animation_frame >= 4) {  // Show for 800ms
-        state->status_animation_timer = 0;
+        state->status_ticker = 0;
         
         // Immediately start track scroll after SKIP finishes
-        state->current_mode = DISPLAY_MODE_SCROLL_TRACK;
-        state->scroll_index = 0;
-        state->scroll_timer = g_timeout_add(SCROLL_INTERVAL_MS, scroll_animation, state);
+        start_scroll(state);
         
         return G_SOURCE_REMOVE;
     }
     
    const gchar *arrows[] = {"►", "►►", "►►►", "►►"};
 gchar *text = g_strdup_printf("S\nK\nI\nP\n%s", arrows[state->animation_frame % 4]);
-    gtk_label_set_text(GTK_LABEL(state->label), text);
+    dot_matrix_set_text(DOT_MATRIX(state->display), text);
     g_free(text);
     
     state->animation_frame++;
@@ -149,92 +176,55 @@ static gboolean scroll_animation(gpointer user_data) {
     VerticalDisplayState *state = (VerticalDisplayState *)user_data;
     
     if (state->current_mode != DISPLAY_MODE_SCROLL_TRACK) {
-        state->scroll_timer = 0;
+        state->scroll_ticker = 0;
         return G_SOURCE_REMOVE;
     }
     
-    // Build full text: SONG + BY + ARTIST (no padding)
-    gchar *song_text = format_vertical_text(state->current_title);
-    gchar *artist_text = format_vertical_text(state->current_artist);
-    
-    GString *full = g_string_new("");
-    g_string_append_printf(full, "%s\nB\nY\n\n%s", song_text, artist_text);
-    
-    gchar *full_text = g_string_free(full, FALSE);
-    gchar **lines = g_strsplit(full_text, "\n", -1);
-    gint total_lines = g_strv_length(lines);
-    
     // Maximum scroll position: when last line reaches bottom of visible window
-    gint max_scroll = total_lines - VISIBLE_LINES;
+    gint max_scroll = (gint)state->scroll_lines->len - VISIBLE_LINES;
     if (max_scroll < 0) max_scroll = 0;
     
     // Check if scrolling is complete
     if (state->scroll_index > max_scroll) {
         state->current_mode = DISPLAY_MODE_TIME;
-        state->scroll_timer = 0;
+        state->scroll_ticker = 0;
         
         gchar *time_text = format_vertical_time(state->current_position, state->track_length);
-        gtk_label_set_text(GTK_LABEL(state->label), time_text);
+        dot_matrix_set_text(DOT_MATRIX(state->display), time_text);
         g_free(time_text);
-        
-        g_strfreev(lines);
-        g_free(full_text);
-        g_free(song_text);
-        g_free(artist_text);
+        sync_timer_ticker(state);
         
         return G_SOURCE_REMOVE;
     }
     
-    // Build visible window - simple sliding window approach
-    GString *visible = g_string_new("");
-    
-    gint start_line = state->scroll_index;
-    gint end_line = start_line + VISIBLE_LINES;
-    
-    if (end_line > total_lines) end_line = total_lines;
-    
-    // Show current window
-    for (gint i = start_line; i < end_line; i++) {
-        if (i > start_line) {
-            g_string_append_c(visible, '\n');
-        }
-        g_string_append(visible, lines[i]);
-    }
-    
-    // If we have fewer lines than VISIBLE_LINES, pad at the bottom
-    gint lines_shown = end_line - start_line;
-    if (lines_shown < VISIBLE_LINES) {
-        for (gint i = 0; i < (VISIBLE_LINES - lines_shown); i++) {
-            g_string_append(visible, "\n");
-        }
-    }
-    
-    gtk_label_set_text(GTK_LABEL(state->label), visible->str);
-    g_string_free(visible, TRUE);
-    
+    dot_matrix_scroll_to(DOT_MATRIX(state->display), state->scroll_index);
     state->scroll_index++;
     
-    g_strfreev(lines);
-    g_free(full_text);
-    g_free(song_text);
-    g_free(artist_text);
-    
     return G_SOURCE_CONTINUE;
 }
 
+// Start scrolling the current track from the top
+static void start_scroll(VerticalDisplayState *state) {
+    state->current_mode = DISPLAY_MODE_SCROLL_TRACK;
+    state->scroll_index = 0;
+    dot_matrix_set_column(DOT_MATRIX(state->display), state->scroll_lines);
+    state->scroll_ticker = animation_add_ticker(state->container, SCROLL_INTERVAL_MS, scroll_animation, state);
+}
+
 
 
 // Update timer display (only updates when in TIME mode)
 static gboolean update_timer_display(gpointer user_data) {
     VerticalDisplayState *state = (VerticalDisplayState *)user_data;
     
-    // CRITICAL: Only update if in TIME mode
-    if (state->current_mode != DISPLAY_MODE_TIME) {
-        return G_SOURCE_CONTINUE;
+    // Only runs in TIME mode while playing (sync_timer_ticker)
+    if (state->current_mode != DISPLAY_MODE_TIME || state->is_paused) {
+        state->update_ticker = 0;
+        return G_SOURCE_REMOVE;
     }
     
     gchar *time_text = format_vertical_time(state->current_position, state->track_length);
-    gtk_label_set_text(GTK_LABEL(state->label), time_text);
+    dot_matrix_set_text(DOT_MATRIX(state->display), time_text);
     g_free(time_text);
     
     state->current_position += 1000000;
@@ -242,6 +232,17 @@ static gboolean update_timer_display(gpointer user_data) {
     return G_SOURCE_CONTINUE;
 }
 
+// The clock ticks only in TIME mode while playing; paused, it shows a still time
+static void sync_timer_ticker(VerticalDisplayState *state) {
+    gboolean wanted = state->current_mode == DISPLAY_MODE_TIME && !state->is_paused;
+
+    if (wanted && state->update_ticker == 0) {
+        state->update_ticker = animation_add_ticker(state->container, 1000, update_timer_display, state);
+    } else if (!wanted) {
+        animation_clear(&state->update_ticker);
+    }
+}
+
 VerticalDisplayState* vertical_display_init() {
     VerticalDisplayState *state = g_new0(VerticalDisplayState, 1);
     
@@ -254,27 +255,24 @@ VerticalDisplayState* vertical_display_init() {
     gtk_widget_set_overflow(state->container, GTK_OVERFLOW_HIDDEN);
     gtk_widget_set_size_request(state->container, 32, 280);
     
-    state->label = gtk_label_new("");
-    gtk_widget_add_css_class(state->label, "vertical-display-label");
-    gtk_label_set_justify(GTK_LABEL(state->label), GTK_JUSTIFY_CENTER);
-    gtk_widget_set_valign(state->label, GTK_ALIGN_CENTER);
-    gtk_widget_set_halign(state->label, GTK_ALIGN_CENTER);
-    gtk_widget_set_vexpand(state->label, TRUE);
+    state->display = dot_matrix_new(VISIBLE_LINES);
+    gtk_widget_add_css_class(state->display, "vertical-display-label");
+    gtk_widget_set_valign(state->display, GTK_ALIGN_CENTER);
+    gtk_widget_set_halign(state->display, GTK_ALIGN_CENTER);
+    gtk_widget_set_vexpand(state->display, TRUE);
     
-    gtk_box_append(GTK_BOX(state->container), state->label);
+    gtk_box_append(GTK_BOX(state->container), state->display);
     
     state->is_showing = FALSE;
     state->scroll_index = 0;
     state->fade_opacity = 0.0;
     state->current_mode = DISPLAY_MODE_TIME;
-    state->is_paused = FALSE;
+    state->is_paused = TRUE;               // Until the player reports Playing
     state->animation_frame = 0;
     
     state->current_title = g_strdup("NO TRACK");
     state->current_artist = g_strdup("NO ARTIST");
-    
-    // Start timer update
-    state->update_timer = g_timeout_add_seconds(1, update_timer_display, state);
+    build_scroll_column(state);
     
     return state;
 }
@@ -307,6 +305,7 @@ void vertical_display_update_track(VerticalDisplayState *state,
     g_free(state->current_artist);
     state->current_title = g_strdup(title);
     state->current_artist = g_strdup(artist);
+    build_scroll_column(state);
     
     // If currently showing SKIP animation, let it finish naturally
     // It will trigger the track scroll when done
@@ -315,19 +314,17 @@ void vertical_display_update_track(VerticalDisplayState *state,
     }
     
     // Cancel other timers
-    if (state->scroll_timer > 0) {
-        g_source_remove(state->scroll_timer);
-        state->scroll_timer = 0;
+    if (state->scroll_ticker > 0) {
+        animation_cancel(state->scroll_ticker);
+        state->scroll_ticker = 0;
     }
-    if (state->status_animation_timer > 0) {
-        g_source_remove(state->status_animation_timer);
-        state->status_animation_timer = 0;
+    if (state->status_ticker > 0) {
+        animation_cancel(state->status_ticker);
+        state->status_ticker = 0;
     }
     
     // Start track scroll
-    state->current_mode = DISPLAY_MODE_SCROLL_TRACK;
-    state->scroll_index = 0;
-    state->scroll_timer = g_timeout_add(SCROLL_INTERVAL_MS, scroll_animation, state);
+    start_scroll(state);
 }
 
 void vertical_display_update_position(VerticalDisplayState *state,
@@ -338,7 +335,12 @@ void vertical_display_update_position(VerticalDisplayState *state,
     state->current_position = position;
     state->track_length = length;
     
-    // Timer display will update automatically if in TIME mode
+    // While playing the clock ticker picks this up; paused (e.g. a seek) it is drawn now
+    if (state->current_mode == DISPLAY_MODE_TIME && state->is_paused) {
+        gchar *time_text = format_vertical_time(position, length);
+        dot_matrix_set_text(DOT_MATRIX(state->display), time_text);
+        g_free(time_text);
+    }
 }
 
 void vertical_display_set_paused(VerticalDisplayState *state, gboolean paused) {
@@ -347,21 +349,22 @@ void vertical_display_set_paused(VerticalDisplayState *state, gboolean paused) {
     state->is_paused = paused;
     
     // Cancel status animations
-    if (state->status_animation_timer > 0) {
-        g_source_remove(state->status_animation_timer);
-        state->status_animation_timer = 0;
+    if (state->status_ticker > 0) {
+        animation_cancel(state->status_ticker);
+        state->status_ticker = 0;
     }
+    animation_clear(&state->update_ticker);
     
     if (paused) {
-        // Enter PAUSED mode - loops forever
+        // Enter PAUSED mode - loops a few times, then holds
         state->current_mode = DISPLAY_MODE_STATUS_PAUSED;
         state->animation_frame = 0;
-        state->status_animation_timer = g_timeout_add(500, animate_paused, state);
+        state->status_ticker = animation_add_ticker(state->container, 500, animate_paused, state);
     } else {
         // Show PLAYING briefly, then return to timer
         state->current_mode = DISPLAY_MODE_STATUS_PLAYING;
         state->animation_frame = 0;
-        state->status_animation_timer = g_timeout_add(250, show_playing_status, state);
+        state->status_ticker = animation_add_ticker(state->container, 250, show_playing_status, state);
     }
 }
 
@@ -369,27 +372,29 @@ void vertical_display_notify_skip(VerticalDisplayState *state) {
     if (!state) return;
     
     // Cancel existing animations
-    if (state->status_animation_timer > 0) {
-        g_source_remove(state->status_animation_timer);
+    if (state->status_ticker > 0) {
+        animation_cancel(state->status_ticker);
     }
-    if (state->scroll_timer > 0) {
-        g_source_remove(state->scroll_timer);
+    if (state->scroll_ticker > 0) {
+        animation_cancel(state->scroll_ticker);
+        state->scroll_ticker = 0;
     }
     
     // Show SKIPPING
     state->current_mode = DISPLAY_MODE_STATUS_SKIPPING;
     state->animation_frame = 0;
-    state->status_animation_timer = g_timeout_add(200, show_skip_status, state);
+    state->status_ticker = animation_add_ticker(state->container, 200, show_skip_status, state);
 }
 
 void vertical_display_cleanup(VerticalDisplayState *state) {
     if (!state) return;
     
-    if (state->scroll_timer > 0) g_source_remove(state->scroll_timer);
-    if (state->status_animation_timer > 0) g_source_remove(state->status_animation_timer);
-    if (state->update_timer > 0) g_source_remove(state->update_timer);
+    if (state->scroll_ticker > 0) animation_cancel(state->scroll_ticker);
+    if (state->status_ticker > 0) animation_cancel(state->status_ticker);
+    if (state->update_ticker > 0) animation_cancel(state->update_ticker);
     
     g_free(state->current_title);
     g_free(state->current_artist);
+    if (state->scroll_lines) g_ptr_array_unref(state->scroll_lines);
     g_free(state);
 }
@@ -15,7 +15,8 @@ typedef enum {
 
 typedef struct {
     GtkWidget *container;
-    GtkWidget *label;
+    GtkWidget *display;            // DotMatrix showing time, status and the track scroll
+    GPtrArray *scroll_lines;       // Line table of the scroll column, built once per track
     
     gboolean is_showing;
     
@@ -24,9 +25,10 @@ typedef struct {
     gint64 current_position;
     gint64 track_length;
     
-    guint scroll_timer;
-    guint update_timer;
-    guint status_animation_timer;
+    // Frame-clock tickers on the container (animation.h)
+    guint scroll_ticker;
+    guint update_ticker;
+    guint status_ticker;
     
     gint scroll_index;
     gdouble fade_opacity;
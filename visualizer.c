@@ -1,16 +1,15 @@
 #include "visualizer.h"
 #include "pipewire_volume.h"
+#include "animation.h"
+#include <pango/pango.h>
 #include <math.h>
 #include <string.h>
+#include <spa/debug/types.h>
+#include <spa/param/audio/type-info.h>
 #include <spa/param/props.h>
 #include <spa/pod/builder.h>
 #include <spa/pod/parser.h>
 
-#define SMOOTHING_FACTOR 0.7
-#define AGC_ATTACK 0.9      // Fast attack - quickly respond to louder audio
-#define AGC_DECAY 0.9995    // Very slow decay - maintain level during quiet parts
-#define AGC_MIN_THRESHOLD 0.0001  // Minimum level to avoid amplifying silence
-
 // Cached audio node info for searching when player changes
 typedef struct {
     guint32 id;
@@ -29,37 +28,35 @@ static void audio_node_info_free(gpointer data) {
     }
 }
 
-// Check if child_pid is a descendant of parent_pid
-static gboolean is_descendant_of(guint32 child_pid, guint32 parent_pid) {
-    if (child_pid == 0 || parent_pid == 0) return FALSE;
-    if (child_pid == parent_pid) return TRUE;
-
-    // Read /proc/<child_pid>/stat to get parent PID
-    gchar *stat_path = g_strdup_printf("/proc/%u/stat", child_pid);
+// Parent PID of `pid` from /proc/<pid>/stat, 0 if it is gone
+static guint32 get_parent_pid(guint32 pid) {
+    gchar *stat_path = g_strdup_printf("/proc/%u/stat", pid);
     gchar *contents = NULL;
     gsize length;
 
     if (!g_file_get_contents(stat_path, &contents, &length, NULL)) {
         g_free(stat_path);
-        return FALSE;
+        return 0;
     }
     g_free(stat_path);
 
     // Parse stat file - format: pid (comm) state ppid ...
     // Find the closing parenthesis of comm, then skip to ppid
     gchar *close_paren = g_strrstr(contents, ")");
-    if (!close_paren) {
-        g_free(contents);
-        return FALSE;
-    }
-
     guint32 ppid = 0;
-    if (sscanf(close_paren + 2, "%*c %u", &ppid) != 1) {
-        g_free(contents);
-        return FALSE;
+    if (!close_paren || sscanf(close_paren + 2, "%*c %u", &ppid) != 1) {
+        ppid = 0;
     }
     g_free(contents);
+    return ppid;
+}
+
+// Check if child_pid is a descendant of parent_pid
+static gboolean is_descendant_of(guint32 child_pid, guint32 parent_pid) {
+    if (child_pid == 0 || parent_pid == 0) return FALSE;
+    if (child_pid == parent_pid) return TRUE;
 
+    guint32 ppid = get_parent_pid(child_pid);
     if (ppid == parent_pid) return TRUE;
     if (ppid <= 1) return FALSE;  // Reached init/systemd
 
@@ -67,6 +64,25 @@ static gboolean is_descendant_of(guint32 child_pid, guint32 parent_pid) {
     return is_descendant_of(ppid, parent_pid);
 }
 
+// Chromium/Electron play audio from a child process: look for a sink-input
+// owned by a direct child of `pid`, scanning /proc instead of spawning pgrep
+static gint find_sink_input_of_children(guint32 pid) {
+    GDir *dir = g_dir_open("/proc", 0, NULL);
+    if (!dir) return -1;
+
+    gint sink_input = -1;
+    const gchar *entry;
+    while (sink_input < 0 && (entry = g_dir_read_name(dir))) {
+        guint32 child_pid = (guint32)g_ascii_strtoull(entry, NULL, 10);
+        if (child_pid == 0 || child_pid == pid) continue;
+        if (get_parent_pid(child_pid) == pid) {
+            sink_input = pw_find_sink_input_by_pid(child_pid);
+        }
+    }
+    g_dir_close(dir);
+    return sink_input;
+}
+
 // Search cached nodes for matching PID and connect if found
 static void search_cached_nodes_for_target(VisualizerState *state);
 
@@ -78,16 +94,26 @@ static void search_cached_nodes_for_target(VisualizerState *state);
  * independent of volume level.
  *
  * Architecture:
- * 1. pw_registry monitors for nodes matching the target PID
- * 2. When found, pw_stream connects to capture that node's audio
- * 3. Audio is processed with AGC normalization
- * 4. GTK widgets are updated from the main thread via render timer
+ * 1. pw_registry monitors for nodes matching the target PID and mirrors the
+ *    audio graph into pw_graph.c for the player -> device signal path
+ * 2. When found, pw_stream links to that node's output ports (target.object)
+ * 3. The RT process callback copies the negotiated native-format frames into
+ *    a lock-free spa_ringbuffer and signals the thread loop
+ * 4. The thread loop drains the ring (the analysis thread): bars via
+ *    visualizer_dsp.c, EBU R128 meter via loudness.c, waterfall columns
+ *    via spectrogram.c, vectorscope via goniometer.c, waveform via oscilloscope.c,
+ *    pitch classes and key via chroma.c; authenticity.c runs in every mode
+ * 5. GTK widgets are updated from the main thread via render timer
  */
 
 // Forward declarations
 static void on_stream_process(void *userdata);
 static void on_stream_state_changed(void *userdata, enum pw_stream_state old,
                                     enum pw_stream_state state, const char *error);
+static void on_stream_param_changed(void *userdata, uint32_t id, const struct spa_pod *param);
+static void queue_format_update(VisualizerState *state);
+static void on_stream_io_changed(void *userdata, uint32_t id, void *area, uint32_t size);
+static void update_output_latency(VisualizerState *state);
 static void on_registry_global(void *data, uint32_t id, uint32_t permissions,
                                const char *type, uint32_t version,
                                const struct spa_dict *props);
@@ -99,6 +125,8 @@ static void disconnect_stream(VisualizerState *state);
 static const struct pw_stream_events stream_events = {
     PW_VERSION_STREAM_EVENTS,
     .state_changed = on_stream_state_changed,
+    .param_changed = on_stream_param_changed,
+    .io_changed = on_stream_io_changed,
     .process = on_stream_process,
 };
 
@@ -109,108 +137,618 @@ static const struct pw_registry_events registry_events = {
     .global_remove = on_registry_global_remove,
 };
 
-// Easing function for smooth transitions
-static gdouble ease_out_sine(gdouble t) {
-    return sin(t * M_PI / 6.0);
-}
-
-// Process audio samples with AGC normalization
-// Handles stereo input by averaging channels
-static void process_audio_samples(VisualizerState *state, const float *samples, size_t n_samples) {
-    if (n_samples == 0) return;
+// PipeWire stream process callback - runs on the PipeWire data (RT) thread.
+// Only copies frames into the lock-free ring and wakes the analysis thread:
+// no mutex, no allocation, no DSP.
+static void capture_buffer(VisualizerState *state) {
+    struct pw_buffer *buf;
+    struct spa_buffer *spa_buf;
 
-    // n_samples is total floats, for stereo that's n_samples/2 frames
-    // We'll process as interleaved stereo and average the channels
-    size_t n_frames = n_samples / 2;  // Stereo frames
-    if (n_frames == 0) n_frames = n_samples;  // Fallback for mono
+    if ((buf = pw_stream_dequeue_buffer(state->pw_stream)) == NULL) {
+        atomic_fetch_add_explicit(&state->rt_health.no_buffer, 1, memory_order_relaxed);
+        return;
+    }
 
-    // Find peak in this buffer (average of L+R)
-    float buffer_peak = 0.0f;
-    for (size_t i = 0; i < n_samples; i += 2) {
-        float left = fabsf(samples[i]);
-        float right = (i + 1 < n_samples) ? fabsf(samples[i + 1]) : left;
-        float avg = (left + right) * 0.5f;
-        if (avg > buffer_peak) {
-            buffer_peak = avg;
+    spa_buf = buf->buffer;
+    const uint32_t channels = state->ring_channels;
+    if (spa_buf->datas[0].data == NULL || channels == 0) {
+        if (spa_buf->datas[0].data == NULL) {
+            rt_health_buffer(&state->rt_health, 0);
         }
+        pw_stream_queue_buffer(state->pw_stream, buf);
+        return;
     }
 
-    // Update AGC peak with attack/decay
-    if (buffer_peak > state->agc_peak) {
-        // Attack: quickly rise to new peak
-        state->agc_peak = AGC_ATTACK * state->agc_peak + (1.0 - AGC_ATTACK) * buffer_peak;
+    uint32_t index;
+    int32_t filled = spa_ringbuffer_get_write_index(&state->ring, &index);
+    uint32_t space = VISUALIZER_RING_FRAMES - (uint32_t)SPA_CLAMP(filled, 0, VISUALIZER_RING_FRAMES);
+    uint32_t n_frames = 0;
+    uint32_t n_copied = 0;
+
+    if (state->format_planar) {
+        // F32P: one data block per channel, all with the same frame count
+        const float *planes[VISUALIZER_RING_CHANNELS];
+        n_frames = UINT32_MAX;
+        for (uint32_t c = 0; c < channels; c++) {
+            struct spa_data *d = &spa_buf->datas[c];
+            if (c >= spa_buf->n_datas || d->data == NULL) {
+                n_frames = 0;
+                break;
+            }
+            planes[c] = SPA_PTROFF(d->data, d->chunk->offset, const float);
+            n_frames = MIN(n_frames, d->chunk->size / (uint32_t)sizeof(float));
+        }
+
+        n_copied = MIN(n_frames, space);
+        for (uint32_t f = 0; f < n_copied; f++) {
+            float *dst = state->ring_data + ((index + f) & (VISUALIZER_RING_FRAMES - 1)) * channels;
+            for (uint32_t c = 0; c < channels; c++) {
+                dst[c] = planes[c][f];
+            }
+        }
     } else {
-        // Decay: slowly fall when audio is quieter
-        state->agc_peak = AGC_DECAY * state->agc_peak;
+        // F32: interleaved; keep the first ring_channels of each frame
+        struct spa_data *d = &spa_buf->datas[0];
+        const uint32_t src_channels = MAX(state->format.channels, channels);
+        const float *src = SPA_PTROFF(d->data, d->chunk->offset, const float);
+        n_frames = d->chunk->size / (src_channels * (uint32_t)sizeof(float));
+
+        n_copied = MIN(n_frames, space);
+        for (uint32_t f = 0; f < n_copied; f++) {
+            float *dst = state->ring_data + ((index + f) & (VISUALIZER_RING_FRAMES - 1)) * channels;
+            memcpy(dst, src + (size_t)f * src_channels, channels * sizeof(float));
+        }
     }
 
-    // Ensure minimum threshold to avoid division by zero or amplifying silence
-    gdouble effective_peak = state->agc_peak;
-    if (effective_peak < AGC_MIN_THRESHOLD) {
-        effective_peak = AGC_MIN_THRESHOLD;
+    if (n_frames > 0 && !state->position) {
+        atomic_store_explicit(&state->quantum_frames, n_frames, memory_order_relaxed);
+    }
+    rt_health_buffer(&state->rt_health, n_frames);
+    if (n_copied < n_frames) {
+        state->ring_overruns++;
     }
+    spa_ringbuffer_write_update(&state->ring, index + n_copied);
 
-    // Calculate gain factor (normalize to ~1.0 peak)
-    gdouble gain = 1.0 / effective_peak;
+    pw_stream_queue_buffer(state->pw_stream, buf);
 
-    // Process into frequency bars (using stereo frames)
-    size_t frames_per_bin = n_frames / VISUALIZER_BARS;
-    if (frames_per_bin == 0) frames_per_bin = 1;
+    if (n_copied > 0) {
+        pw_loop_signal_event(pw_thread_loop_get_loop(state->pw_loop), state->analysis_event);
+    }
+}
 
-    for (int i = 0; i < VISUALIZER_BARS; i++) {
-        gdouble sum = 0.0;
-        size_t start_frame = i * frames_per_bin;
-        size_t end_frame = start_frame + frames_per_bin;
+// Timed and counted in rt_health; in a debug build allocations and lock
+// waits made in here are trapped (rt_check.c)
+static void on_stream_process(void *userdata) {
+    VisualizerState *state = (VisualizerState *)userdata;
+    uint64_t start = rt_health_begin();
+
+    struct spa_io_position *position = state->position;
+    if (position) {
+        rt_health_cycle(&state->rt_health, position->clock.position, position->clock.duration);
+        atomic_store_explicit(&state->quantum_frames, (unsigned int)position->clock.duration,
+                              memory_order_relaxed);
+    }
+    capture_buffer(state);
+
+    rt_health_end(&state->rt_health, start);
+}
+
+static void on_stream_io_changed(void *userdata, uint32_t id, void *area, uint32_t size) {
+    VisualizerState *state = (VisualizerState *)userdata;
+    (void)size;
+
+    if (id == SPA_IO_Position) {
+        state->position = (struct spa_io_position *)area;
+    }
+}
+
+// Log xruns and buffer trouble seen by the process callback since last time
+static void report_rt_problems(VisualizerState *state) {
+    RtHealth *h = &state->rt_health;
+    guint missed = atomic_load_explicit(&h->missed_quanta, memory_order_relaxed);
+    guint no_buffer = atomic_load_explicit(&h->no_buffer, memory_order_relaxed);
+    guint null_data = atomic_load_explicit(&h->null_data, memory_order_relaxed);
+    guint trapped = atomic_load_explicit(&rt_health_allocations, memory_order_relaxed) +
+                    atomic_load_explicit(&rt_health_mutex_waits, memory_order_relaxed);
+    guint total = missed + no_buffer + null_data + trapped;
+
+    if (total != state->rt_problems_reported) {
+        g_printerr("Visualizer: Capture callback trouble: %u missed quanta, %u without buffer, "
+                   "%u without data, %u RT-unsafe calls\n",
+                   missed, no_buffer, null_data, trapped);
+        state->rt_problems_reported = total;
+    }
+}
+
+// Analysis event - runs on the PipeWire thread loop (not the RT thread).
+// Drains everything the data thread queued, runs the DSP for the active
+// mode and publishes the results for the GTK thread.
+static void on_analysis_event(void *data, uint64_t count) {
+    VisualizerState *state = (VisualizerState *)data;
+    const uint32_t channels = state->ring_channels;
+    gint mode = g_atomic_int_get(&state->mode);
+    gboolean meter = mode == VISUALIZER_MODE_LOUDNESS;
+    gboolean waterfall = mode == VISUALIZER_MODE_SPECTROGRAM;
+    gboolean vector = mode == VISUALIZER_MODE_GONIOMETER;
+    gboolean trace = mode == VISUALIZER_MODE_OSCILLOSCOPE;
+    gboolean notes = mode == VISUALIZER_MODE_CHROMA;
+    (void)count;
+
+    if (g_atomic_int_compare_and_exchange(&state->loudness_reset_pending, 1, 0)) {
+        loudness_reset(&state->loudness);
+    }
+    if (g_atomic_int_compare_and_exchange(&state->chroma_reset_pending, 1, 0)) {
+        chroma_reset(&state->chroma);
+    }
+    if (g_atomic_int_compare_and_exchange(&state->authenticity_reset_pending, 1, 0)) {
+        authenticity_reset(&state->authenticity);
+    }
+
+    // Sink latency is partly given in quanta, and the quantum follows the graph
+    if (atomic_load_explicit(&state->quantum_frames, memory_order_relaxed) != state->latency_quantum) {
+        update_output_latency(state);
+    }
+
+    uint32_t index;
+    int32_t avail = spa_ringbuffer_get_read_index(&state->ring, &index);
+    if (avail <= 0 || channels == 0) {
+        return;
+    }
 
-        for (size_t f = start_frame; f < end_frame && f < n_frames; f++) {
-            size_t idx = f * 2;  // Stereo interleaved
-            float left = (idx < n_samples) ? samples[idx] : 0.0f;
-            float right = (idx + 1 < n_samples) ? samples[idx + 1] : left;
-            // Average L+R and apply gain
-            gdouble mono = ((left + right) * 0.5) * gain;
-            sum += mono * mono;
+    while (avail > 0) {
+        uint32_t offset = index & (VISUALIZER_RING_FRAMES - 1);
+        uint32_t n = MIN((uint32_t)avail, VISUALIZER_RING_FRAMES - offset);
+        const float *frames = state->ring_data + (size_t)offset * channels;
+
+        viz_dsp_process_interleaved(&state->dsp, frames, n);
+        authenticity_process(&state->authenticity, frames, n, channels);
+        if (meter) {
+            loudness_process(&state->loudness, frames, n, channels);
+        }
+        if (waterfall) {
+            spectrogram_process(&state->spectrogram, frames, n, channels);
+        }
+        if (vector) {
+            goniometer_process(&state->goniometer, frames, n, channels);
+        }
+        if (trace) {
+            oscilloscope_process(&state->oscilloscope, frames, n, channels);
+        }
+        if (notes) {
+            chroma_process(&state->chroma, frames, n, channels);
         }
 
-        gdouble rms = sqrt(sum / frames_per_bin);
+        index += n;
+        avail -= (int32_t)n;
+    }
+    spa_ringbuffer_read_update(&state->ring, index);
 
-        // Scale for visualization (already normalized by AGC, so smaller multiplier)
-        gdouble normalized = rms * 2.5;
-        if (normalized > 1.0) normalized = 1.0;
+    if (state->ring_overruns != state->ring_overruns_reported) {
+        g_printerr("Visualizer: Analysis fell behind, dropped audio (%u times)\n",
+                   state->ring_overruns);
+        state->ring_overruns_reported = state->ring_overruns;
+    }
 
-        // Smooth the values
-        state->bar_smoothed[i] = (SMOOTHING_FACTOR * state->bar_smoothed[i]) +
-                                 ((1.0 - SMOOTHING_FACTOR) * normalized);
+    // Tone-map / trigger the scopes no faster than the display can show them
+    gint64 now = g_get_monotonic_time();
+    AuthenticityReport report;
+    gboolean check_report = now - state->report_checked_at >= G_USEC_PER_SEC;
+    if (check_report) {
+        authenticity_get_report(&state->authenticity, &report);
+        state->report_checked_at = now;
+        report_rt_problems(state);
+    }
+    gboolean frame = (vector || trace) &&
+                     now - state->frame_rendered_at >= G_USEC_PER_SEC / VISUALIZER_UPDATE_FPS;
+    if (frame) {
+        state->frame_rendered_at = now;
+        if (vector) {
+            goniometer_render(&state->goniometer);
+        }
+        if (trace) {
+            oscilloscope_render(&state->oscilloscope, (uint32_t)MAX(1, g_atomic_int_get(&state->scope_columns)));
+        }
+    }
 
-        state->bar_heights[i] = state->bar_smoothed[i];
+    // Bars are due when the audio they came from leaves the speakers: the
+    // cycle's capture time plus the sink's reported output latency
+    gboolean push_bars = now - state->bars_pushed_at >= G_USEC_PER_SEC / VISUALIZER_BAR_PUSH_HZ;
+    gint64 due = now + state->output_latency_us;
+    gint64 captured = now;
+    if (push_bars) {
+        struct pw_time time;
+        state->bars_pushed_at = now;
+        if (state->pw_stream && pw_stream_get_time_n(state->pw_stream, &time, sizeof(time)) == 0 &&
+            time.now > 0 && time.rate.denom > 0) {
+            captured = MIN(time.now / 1000 -
+                           time.delay * G_USEC_PER_SEC * time.rate.num / time.rate.denom, now);
+            due = captured + state->output_latency_us;
+        }
     }
+
+    g_mutex_lock(&state->data_mutex);
+    if (push_bars) {
+        // Full queue: the oldest frame is overdue anyway
+        if (state->bar_queue_count == VISUALIZER_BAR_QUEUE) {
+            state->bar_queue_tail = (state->bar_queue_tail + 1) & (VISUALIZER_BAR_QUEUE - 1);
+            state->bar_queue_count--;
+            state->bar_queue_dropped++;
+        }
+        VisualizerBarFrame *slot = &state->bar_queue[(state->bar_queue_tail + state->bar_queue_count) &
+                                                     (VISUALIZER_BAR_QUEUE - 1)];
+        slot->captured = captured;
+        slot->analyzed = g_get_monotonic_time();
+        slot->due = due;
+        memcpy(slot->heights, state->dsp.bars, sizeof(slot->heights));
+        state->bar_queue_count++;
+    }
+    if (meter) {
+        loudness_get_readings(&state->loudness, &state->loudness_readings);
+    }
+    if (waterfall) {
+        // Columns the GTK thread has not picked up yet are kept; overflow drops
+        Spectrogram *spec = &state->spectrogram;
+        guint room = SPECTROGRAM_PENDING - state->spec_column_count;
+        guint n = MIN(spec->pending_count, room);
+        memcpy(state->spec_columns[state->spec_column_count], spec->pending, n * SPECTROGRAM_ROWS);
+        state->spec_column_count += n;
+        spectrogram_clear_pending(spec);
+    }
+    if (frame && vector) {
+        memcpy(state->gonio_image, state->goniometer.image, sizeof(state->gonio_image));
+        state->gonio_correlation = state->goniometer.correlation;
+        state->gonio_dirty = TRUE;
+    }
+    if (check_report && (report.verdict != state->report.verdict ||
+                         report.bits != state->report.bits ||
+                         report.cutoff_hz != state->report.cutoff_hz)) {
+        state->report = report;
+        queue_format_update(state);
+    }
+    if (notes) {
+        memcpy(state->chroma_classes, state->chroma.chroma, sizeof(state->chroma_classes));
+        state->chroma_key = state->chroma.key;
+    }
+    if (frame && trace) {
+        Oscilloscope *scope = &state->oscilloscope;
+        memcpy(state->scope_min, scope->col_min, scope->n_columns * sizeof(gfloat));
+        memcpy(state->scope_max, scope->col_max, scope->n_columns * sizeof(gfloat));
+        state->scope_column_count = scope->n_columns;
+        state->scope_triggered = scope->triggered;
+        state->scope_dirty = TRUE;
+    }
+    g_mutex_unlock(&state->data_mutex);
 }
 
-// PipeWire stream process callback - called when audio data is available
-static void on_stream_process(void *userdata) {
+// Format negotiated - read the node's native rate and channel layout
+static void on_stream_param_changed(void *userdata, uint32_t id, const struct spa_pod *param) {
     VisualizerState *state = (VisualizerState *)userdata;
-    struct pw_buffer *buf;
-    struct spa_buffer *spa_buf;
-    float *samples;
-    uint32_t n_samples;
+    struct spa_audio_info info = { 0 };
 
-    if ((buf = pw_stream_dequeue_buffer(state->pw_stream)) == NULL) {
+    if (param == NULL || id != SPA_PARAM_Format) {
         return;
     }
 
-    spa_buf = buf->buffer;
-    if (spa_buf->datas[0].data == NULL) {
-        pw_stream_queue_buffer(state->pw_stream, buf);
+    if (spa_format_parse(param, &info.media_type, &info.media_subtype) < 0 ||
+        info.media_type != SPA_MEDIA_TYPE_audio ||
+        info.media_subtype != SPA_MEDIA_SUBTYPE_raw) {
+        return;
+    }
+
+    if (spa_format_audio_raw_parse(param, &info.info.raw) < 0) {
         return;
     }
 
-    samples = spa_buf->datas[0].data;
-    n_samples = spa_buf->datas[0].chunk->size / sizeof(float);
+    // Runs on the thread loop, like the analysis, so the DSP can be
+    // reconfigured directly
+    uint32_t channels = MIN(info.info.raw.channels, VISUALIZER_RING_CHANNELS);
+    state->format = info.info.raw;
+    state->format_planar = info.info.raw.format == SPA_AUDIO_FORMAT_F32P;
+    viz_dsp_configure(&state->dsp, info.info.raw.rate, channels, state->analysis_rate);
+
+    // BS.1770 channel weights: LFE excluded, surrounds +1.5 dB
+    loudness_configure(&state->loudness, info.info.raw.rate, channels);
+    for (uint32_t c = 0; c < channels; c++) {
+        switch (info.info.raw.position[c]) {
+            case SPA_AUDIO_CHANNEL_LFE:
+            case SPA_AUDIO_CHANNEL_LFE2:
+                loudness_set_channel_weight(&state->loudness, c, 0.0);
+                break;
+            case SPA_AUDIO_CHANNEL_SL:
+            case SPA_AUDIO_CHANNEL_SR:
+            case SPA_AUDIO_CHANNEL_RL:
+            case SPA_AUDIO_CHANNEL_RR:
+                loudness_set_channel_weight(&state->loudness, c, 1.41);
+                break;
+            default:
+                break;
+        }
+    }
+
+    spectrogram_configure(&state->spectrogram, info.info.raw.rate, channels);
+    goniometer_configure(&state->goniometer, info.info.raw.rate, channels);
+    oscilloscope_configure(&state->oscilloscope, info.info.raw.rate, channels);
+    chroma_configure(&state->chroma, info.info.raw.rate, channels);
+    authenticity_configure(&state->authenticity, info.info.raw.rate, channels);
+
+    // Drop anything queued with the previous layout before changing stride
+    uint32_t write_index;
+    spa_ringbuffer_get_write_index(&state->ring, &write_index);
+    spa_ringbuffer_read_update(&state->ring, write_index);
+    state->ring_channels = channels;
 
     g_mutex_lock(&state->data_mutex);
-    process_audio_samples(state, samples, n_samples);
+    memset(&state->report, 0, sizeof(state->report));
+    state->report_rate = info.info.raw.rate;
+    queue_format_update(state);
     g_mutex_unlock(&state->data_mutex);
 
-    pw_stream_queue_buffer(state->pw_stream, buf);
+    g_print("Visualizer: Negotiated %s %u Hz, %u ch (analysis at %u Hz, decimation %u)\n",
+            state->format_planar ? "F32P" : "F32",
+            info.info.raw.rate, info.info.raw.channels,
+            state->dsp.analysis_rate, state->dsp.decimation);
+}
+
+// ========================================
+// NODE FORMAT WATCH
+// ========================================
+
+// Recompute the signal path if a graph change touched it, and publish it
+static void update_signal_path(VisualizerState *state) {
+    if (!state->graph || !pw_graph_update_path(state->graph)) return;
+
+    const gchar *path = pw_graph_get_path_text(state->graph);
+    g_mutex_lock(&state->data_mutex);
+    g_free(state->signal_path);
+    state->signal_path = *path ? g_strdup(path) : NULL;
+    queue_format_update(state);
+    g_mutex_unlock(&state->data_mutex);
+
+    if (*path) {
+        g_print("Visualizer: Signal path: %s\n", path);
+    }
+}
+
+// Copy both watched formats to the GTK side
+static void publish_node_formats(VisualizerState *state) {
+    g_mutex_lock(&state->data_mutex);
+    state->stream_format = state->stream_watch.format;
+    state->sink_format = state->sink_watch.format;
+    queue_format_update(state);
+    g_mutex_unlock(&state->data_mutex);
+}
+
+static void follow_target_sink(VisualizerState *state, guint32 driver_id);
+
+// Sink latency (input side to the device, plus its own processing), in us
+static void update_output_latency(VisualizerState *state) {
+    const NodeFormatWatch *sink = &state->sink_watch;
+    guint32 rate = sink->format.rate ? sink->format.rate : state->format.rate;
+    gint64 latency_us = 0;
+
+    state->latency_quantum = atomic_load_explicit(&state->quantum_frames, memory_order_relaxed);
+    if (sink->proxy && rate > 0) {
+        double quantum = state->latency_quantum;
+        double seconds =
+            (sink->latency.min_quantum * quantum + sink->latency.min_rate) / rate +
+            sink->latency.min_ns / 1e9 +
+            (sink->process_latency.quantum * quantum + sink->process_latency.rate) / rate +
+            sink->process_latency.ns / 1e9;
+        latency_us = (gint64)(seconds * G_USEC_PER_SEC);
+        latency_us = CLAMP(latency_us, 0, VISUALIZER_MAX_LATENCY_MS * 1000);
+    }
+
+    if (latency_us == state->output_latency_us) return;
+    state->output_latency_us = latency_us;
+
+    g_mutex_lock(&state->data_mutex);
+    state->bar_latency_ms = (gint)(latency_us / 1000);
+    queue_format_update(state);
+    g_mutex_unlock(&state->data_mutex);
+
+    g_print("Visualizer: Delaying bars by %" G_GINT64_FORMAT " ms for output latency\n",
+            latency_us / 1000);
+}
+
+static void on_watched_node_info(void *data, const struct pw_node_info *info) {
+    NodeFormatWatch *watch = (NodeFormatWatch *)data;
+    VisualizerState *state = (VisualizerState *)watch->state;
+
+    // The stream's driver changes when it is moved to another sink
+    if (watch == &state->stream_watch && (info->change_mask & PW_NODE_CHANGE_MASK_PROPS) && info->props) {
+        const char *driver = spa_dict_lookup(info->props, PW_KEY_NODE_DRIVER_ID);
+        if (driver) follow_target_sink(state, (guint32)atoi(driver));
+    }
+
+    // A suspended node has no format; the subscription re-sends it on resume
+    if ((info->change_mask & PW_NODE_CHANGE_MASK_STATE) &&
+        (info->state == PW_NODE_STATE_SUSPENDED || info->state == PW_NODE_STATE_ERROR) &&
+        watch->format.rate != 0) {
+        spa_zero(watch->format);
+        publish_node_formats(state);
+        pw_graph_set_node_format(state->graph, watch->id, 0, 0);
+        update_signal_path(state);
+    }
+}
+
+// Software volume: softVolumes when the node reports them (hardware mixers
+// leave these at 1.0), otherwise channelVolumes, which streams apply in software
+static gboolean props_soft_volume(const struct spa_pod *param) {
+    const struct spa_pod_object *obj = (const struct spa_pod_object *)param;
+    const struct spa_pod_prop *prop;
+    float volumes[SPA_AUDIO_MAX_CHANNELS];
+    gboolean have_soft = FALSE, soft = FALSE, channel = FALSE;
+
+    SPA_POD_OBJECT_FOREACH(obj, prop) {
+        bool mute = false;
+        switch (prop->key) {
+            case SPA_PROP_softVolumes:
+            case SPA_PROP_channelVolumes: {
+                uint32_t n = spa_pod_copy_array(&prop->value, SPA_TYPE_Float,
+                                                volumes, SPA_AUDIO_MAX_CHANNELS);
+                gboolean scaled = FALSE;
+                for (uint32_t i = 0; i < n; i++) {
+                    if (fabsf(volumes[i] - 1.0f) > 1e-4f) scaled = TRUE;
+                }
+                if (prop->key == SPA_PROP_softVolumes) {
+                    have_soft = TRUE;
+                    soft = soft || scaled;
+                } else {
+                    channel = scaled;
+                }
+                break;
+            }
+            case SPA_PROP_softMute:
+                if (spa_pod_get_bool(&prop->value, &mute) == 0 && mute) {
+                    have_soft = TRUE;
+                    soft = TRUE;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return have_soft ? soft : channel;
+}
+
+static void on_watched_node_param(void *data, int seq, uint32_t id, uint32_t index,
+                                  uint32_t next, const struct spa_pod *param) {
+    NodeFormatWatch *watch = (NodeFormatWatch *)data;
+    struct spa_audio_info info = { 0 };
+
+    if (param == NULL) return;
+    VisualizerState *state = (VisualizerState *)watch->state;
+
+    if (id == SPA_PARAM_Props && spa_pod_is_object_type(param, SPA_TYPE_OBJECT_Props)) {
+        gboolean soft_volume = props_soft_volume(param);
+        if (soft_volume != watch->soft_volume) {
+            watch->soft_volume = soft_volume;
+            pw_graph_set_node_soft_volume(state->graph, watch->id, soft_volume);
+            update_signal_path(state);
+        }
+        return;
+    }
+
+    if (id == SPA_PARAM_Latency) {
+        struct spa_latency_info latency;
+        if (spa_latency_parse(param, &latency) < 0 || latency.direction != SPA_DIRECTION_INPUT) return;
+        watch->latency = latency;
+        if (watch == &state->sink_watch) update_output_latency(state);
+        return;
+    }
+    if (id == SPA_PARAM_ProcessLatency) {
+        struct spa_process_latency_info process_latency;
+        if (spa_process_latency_parse(param, &process_latency) < 0) return;
+        watch->process_latency = process_latency;
+        if (watch == &state->sink_watch) update_output_latency(state);
+        return;
+    }
+
+    if (id != SPA_PARAM_Format) return;
+    if (spa_format_parse(param, &info.media_type, &info.media_subtype) < 0 ||
+        info.media_type != SPA_MEDIA_TYPE_audio ||
+        info.media_subtype != SPA_MEDIA_SUBTYPE_raw ||
+        spa_format_audio_raw_parse(param, &info.info.raw) < 0) {
+        return;
+    }
+
+    watch->format = info.info.raw;
+    publish_node_formats(state);
+    if (watch == &state->sink_watch) update_output_latency(state);
+    pw_graph_set_node_format(state->graph, watch->id, info.info.raw.rate, info.info.raw.channels);
+    update_signal_path(state);
+}
+
+static const struct pw_node_events watched_node_events = {
+    PW_VERSION_NODE_EVENTS,
+    .info = on_watched_node_info,
+    .param = on_watched_node_param,
+};
+
+static void unwatch_node_format(NodeFormatWatch *watch) {
+    if (watch->proxy) {
+        spa_hook_remove(&watch->listener);
+        pw_proxy_destroy(watch->proxy);
+        watch->proxy = NULL;
+    }
+    watch->id = 0;
+    spa_zero(watch->format);
+    watch->soft_volume = FALSE;
+    spa_zero(watch->latency);
+    spa_zero(watch->process_latency);
+}
+
+// Bind a proxy for node `id` and subscribe to its format (no-op if already watching it)
+static void watch_node_format(VisualizerState *state, NodeFormatWatch *watch, guint32 id) {
+    if (watch->proxy && watch->id == id) return;
+    unwatch_node_format(watch);
+    if (id == 0 || !state->pw_registry) return;
+
+    watch->proxy = pw_registry_bind(state->pw_registry, id, PW_TYPE_INTERFACE_Node,
+                                    PW_VERSION_NODE, 0);
+    if (!watch->proxy) {
+        g_printerr("Visualizer: Failed to bind node %u for format updates\n", id);
+        return;
+    }
+    watch->id = id;
+    watch->state = state;
+
+    spa_zero(watch->listener);
+    pw_node_add_listener((struct pw_node *)watch->proxy, &watch->listener,
+                         &watched_node_events, watch);
+    uint32_t ids[] = { SPA_PARAM_Format, SPA_PARAM_Props, SPA_PARAM_Latency, SPA_PARAM_ProcessLatency };
+    pw_node_subscribe_params((struct pw_node *)watch->proxy, ids, SPA_N_ELEMENTS(ids));
+}
+
+// Follow the current target's stream node and sink
+static void watch_target_formats(VisualizerState *state) {
+    guint32 stream_id = state->target_found ? state->target_node_id : 0;
+    guint32 sink_id = state->target_sink_id > 0 ? (guint32)state->target_sink_id : 0;
+
+    watch_node_format(state, &state->stream_watch, stream_id);
+    watch_node_format(state, &state->sink_watch, sink_id);
+    publish_node_formats(state);
+    update_output_latency(state);
+
+    pw_graph_set_source(state->graph, stream_id);
+    update_signal_path(state);
+}
+
+// The sink the target stream feeds: what its output is linked to, else its driver
+static gint resolve_target_sink(VisualizerState *state, guint32 driver_id) {
+    guint32 sink = pw_graph_get_linked_sink(state->graph, state->target_node_id);
+    if (sink == 0) sink = driver_id;
+    return sink > 0 ? (gint)sink : state->target_sink_id;
+}
+
+// Hi-Fi: The session manager (or the user) moved the player to another sink.
+// Links and node.driver-id changes arrive as registry/node-info events, so
+// this follows within the quantum the move happens in, without pactl.
+static void follow_target_sink(VisualizerState *state, guint32 driver_id) {
+    if (!state->target_found || state->target_node_id == 0) return;
+
+    gint sink = resolve_target_sink(state, driver_id);
+    if (sink <= 0 || sink == state->target_sink_id) return;
+
+    g_print("Visualizer: Stream %u moved to sink %d (was %d)\n",
+            state->target_node_id, sink, state->target_sink_id);
+    state->target_sink_id = sink;
+    watch_node_format(state, &state->sink_watch, (guint32)sink);
+    publish_node_formats(state);
+    update_output_latency(state);
+
+    // The capture itself is linked to the stream node (target.object), not the
+    // sink, so it moves along; a new sink rate arrives via param_changed
+}
+
+static void unwatch_target_formats(VisualizerState *state) {
+    unwatch_node_format(&state->stream_watch);
+    unwatch_node_format(&state->sink_watch);
+    publish_node_formats(state);
+    update_output_latency(state);
+
+    pw_graph_set_source(state->graph, 0);
+    update_signal_path(state);
 }
 
 // Stream state change callback
@@ -241,6 +779,17 @@ static void on_registry_global(void *data, uint32_t id, uint32_t permissions,
                                const struct spa_dict *props) {
     VisualizerState *state = (VisualizerState *)data;
 
+    // Hi-Fi: Mirror nodes, ports and links for the signal path
+    if (strcmp(type, PW_TYPE_INTERFACE_Node) == 0) {
+        pw_graph_add_node(state->graph, id, props);
+    } else if (strcmp(type, PW_TYPE_INTERFACE_Port) == 0) {
+        pw_graph_add_port(state->graph, id, props);
+    } else if (strcmp(type, PW_TYPE_INTERFACE_Link) == 0) {
+        pw_graph_add_link(state->graph, id, props);
+        follow_target_sink(state, 0);
+    }
+    update_signal_path(state);
+
     // Only interested in audio stream nodes
     if (strcmp(type, PW_TYPE_INTERFACE_Node) != 0) {
         return;
@@ -302,13 +851,15 @@ static void on_registry_global(void *data, uint32_t id, uint32_t permissions,
     g_print("✓ Found target audio node: id=%u serial=%d app='%s' sink=%u\n",
             id, node_serial, app_name ? app_name : "?", sink_id);
 
-    // Store target info — use the sink ID for capture (not the stream node)
-    state->target_node_id = sink_id > 0 ? sink_id : id;
+    // Store target info — capture from the player's stream node itself so
+    // other streams mixed into the same sink don't reach the analysis
+    state->target_node_id = id;
+    state->target_sink_id = resolve_target_sink(state, sink_id);
     g_free(state->target_node_name);
     state->target_node_name = g_strdup(app_name ? app_name : node_name);
     state->target_found = TRUE;
 
-    // Connect to the sink's monitor to capture this player's audio
+    // Connect to the player's stream node to capture only its audio
     connect_to_target(state);
 }
 
@@ -324,12 +875,12 @@ static void search_cached_nodes_for_target(VisualizerState *state) {
         AudioNodeInfo *info = (AudioNodeInfo *)value;
         // info->pid is actually the serial number (we stored it there)
         if ((gint)info->pid == state->target_serial) {
-            uint32_t sink_id = info->driver_id > 0 ? info->driver_id : info->id;
             g_print("Found cached audio node for serial %d: id=%u sink=%u app='%s'\n",
-                    state->target_serial, info->id, sink_id,
+                    state->target_serial, info->id, info->driver_id,
                     info->app_name ? info->app_name : "?");
 
-            state->target_node_id = sink_id;
+            state->target_node_id = info->id;
+            state->target_sink_id = resolve_target_sink(state, info->driver_id);
             g_free(state->target_node_name);
             state->target_node_name = g_strdup(info->app_name ? info->app_name : info->name);
             state->target_found = TRUE;
@@ -352,6 +903,19 @@ static void on_registry_global_remove(void *data, uint32_t id) {
         g_hash_table_remove(state->audio_nodes, GUINT_TO_POINTER(id));
     }
 
+    // A move may link the new sink before unlinking the old one, so the sink
+    // has to be looked at again once the old link is gone
+    gboolean target_link = pw_graph_link_touches(state->graph, id, state->target_node_id);
+    pw_graph_remove(state->graph, id);
+    if (target_link) follow_target_sink(state, 0);
+    update_signal_path(state);
+
+    if (id == state->sink_watch.id) {
+        unwatch_node_format(&state->sink_watch);
+        publish_node_formats(state);
+        update_output_latency(state);
+    }
+
     if (id == state->target_node_id) {
         g_print("Target node %u removed, disconnecting visualizer\n", id);
         disconnect_stream(state);
@@ -361,49 +925,81 @@ static void on_registry_global_remove(void *data, uint32_t id) {
 }
 
 // Connect pw_stream to capture audio from a specific player's node
-// Only connects if a target node has been found; no fallback to system audio
+// Prefers the player's own Stream/Output/Audio node (linked to its output
+// ports via target.object), so notification sounds, games and calls mixed
+// into the same sink are not analyzed. Falls back to the sink monitor only
+// while the stream node itself has not been seen in the registry yet.
 static void connect_to_target(VisualizerState *state) {
     if (!state->pw_stream) return;
 
-    // Need either a known sink or a matched target node
-    uint32_t capture_node = 0;
-    if (state->target_sink_id > 0) {
-        capture_node = (uint32_t)state->target_sink_id;
-    } else if (state->target_found && state->target_node_id > 0) {
-        capture_node = state->target_node_id;
-    } else {
-        g_print("Visualizer: No target sink found, skipping connection\n");
+    gboolean capture_stream = state->target_found && state->target_node_id > 0 &&
+                              state->target_serial > 0;
+    if (!capture_stream && state->target_sink_id <= 0) {
+        g_print("Visualizer: No target stream or sink found, skipping connection\n");
         return;
     }
 
     // Disconnect existing connection first
     pw_stream_disconnect(state->pw_stream);
 
+    // Hi-Fi: Follow the player's and the sink's negotiated formats
+    watch_target_formats(state);
+
     // Build stream parameters for audio capture
     uint8_t buffer[1024];
     struct spa_pod_builder b = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
 
-    // Request float audio, stereo, 48kHz
+    // Request float audio but leave rate and channels open, so the node's
+    // native format is used as-is instead of resampling/remixing for us.
+    // Planar is preferred: it is what the graph carries between nodes.
     const struct spa_pod *params[1];
-    params[0] = spa_format_audio_raw_build(&b, SPA_PARAM_EnumFormat,
-            &SPA_AUDIO_INFO_RAW_INIT(
-                .format = SPA_AUDIO_FORMAT_F32,
-                .channels = 2,
-                .rate = 48000));
-
-    g_print("Visualizer: Connecting to sink node %u for '%s' (AGC-normalized)\n",
-            capture_node, state->target_node_name ? state->target_node_name : "?");
-
-    // Capture from the sink's monitor (not a source)
-    pw_stream_update_properties(state->pw_stream,
-        &SPA_DICT_INIT_ARRAY(((struct spa_dict_item[]) {
-            { PW_KEY_STREAM_CAPTURE_SINK, "true" },
-            { PW_KEY_NODE_NAME, "hyprwave-visualizer" },
-        })));
+    params[0] = spa_pod_builder_add_object(&b,
+            SPA_TYPE_OBJECT_Format, SPA_PARAM_EnumFormat,
+            SPA_FORMAT_mediaType,    SPA_POD_Id(SPA_MEDIA_TYPE_audio),
+            SPA_FORMAT_mediaSubtype, SPA_POD_Id(SPA_MEDIA_SUBTYPE_raw),
+            SPA_FORMAT_AUDIO_format, SPA_POD_CHOICE_ENUM_Id(3,
+                    SPA_AUDIO_FORMAT_F32P,
+                    SPA_AUDIO_FORMAT_F32P,
+                    SPA_AUDIO_FORMAT_F32));
+
+    uint32_t target_id;
+    if (capture_stream) {
+        // Link directly to the player's output ports. target.object takes the
+        // object.serial, which is the same number we matched the player by.
+        gchar serial_str[16];
+        g_snprintf(serial_str, sizeof(serial_str), "%d", state->target_serial);
+
+        g_print("Visualizer: Capturing stream node %u (serial %s) for '%s' (AGC-normalized)\n",
+                state->target_node_id, serial_str,
+                state->target_node_name ? state->target_node_name : "?");
+
+        pw_stream_update_properties(state->pw_stream,
+            &SPA_DICT_INIT_ARRAY(((struct spa_dict_item[]) {
+                { PW_KEY_STREAM_CAPTURE_SINK, "false" },
+                { PW_KEY_STREAM_DONT_REMIX, "true" },
+                { PW_KEY_TARGET_OBJECT, serial_str },
+                { PW_KEY_NODE_NAME, "hyprwave-visualizer" },
+            })));
+        target_id = PW_ID_ANY;
+    } else {
+        g_print("Visualizer: Stream node not seen yet, capturing sink %d monitor for '%s'\n",
+                state->target_sink_id,
+                state->target_node_name ? state->target_node_name : "?");
+
+        // Capture from the sink's monitor (not a source)
+        pw_stream_update_properties(state->pw_stream,
+            &SPA_DICT_INIT_ARRAY(((struct spa_dict_item[]) {
+                { PW_KEY_STREAM_CAPTURE_SINK, "true" },
+                { PW_KEY_STREAM_DONT_REMIX, "true" },
+                { PW_KEY_TARGET_OBJECT, NULL },
+                { PW_KEY_NODE_NAME, "hyprwave-visualizer" },
+            })));
+        target_id = (uint32_t)state->target_sink_id;
+    }
 
     pw_stream_connect(state->pw_stream,
                       PW_DIRECTION_INPUT,
-                      capture_node,
+                      target_id,
                       PW_STREAM_FLAG_AUTOCONNECT |
                       PW_STREAM_FLAG_RT_PROCESS |
                       PW_STREAM_FLAG_MAP_BUFFERS,
@@ -415,38 +1011,529 @@ static void disconnect_stream(VisualizerState *state) {
     if (state->pw_stream) {
         pw_stream_disconnect(state->pw_stream);
     }
+    unwatch_target_formats(state);
+
+    // Clear visualization (callers hold the thread loop lock, so the
+    // analysis is not running)
+    viz_dsp_reset(&state->dsp);
+    loudness_reset(&state->loudness);
+    spectrogram_reset(&state->spectrogram);
+    goniometer_reset(&state->goniometer);
+    oscilloscope_reset(&state->oscilloscope);
+    chroma_reset(&state->chroma);
+    authenticity_reset(&state->authenticity);
 
-    // Clear visualization
     g_mutex_lock(&state->data_mutex);
     for (int i = 0; i < VISUALIZER_BARS; i++) {
         state->bar_heights[i] = 0.0;
-        state->bar_smoothed[i] = 0.0;
     }
-    state->agc_peak = AGC_MIN_THRESHOLD;
+    state->bar_queue_count = 0;
+    loudness_get_readings(&state->loudness, &state->loudness_readings);
+    state->spec_column_count = 0;
+    memset(state->gonio_image, 0, sizeof(state->gonio_image));
+    state->gonio_correlation = 0.0f;
+    state->gonio_dirty = TRUE;
+    state->scope_column_count = 0;
+    state->scope_dirty = TRUE;
+    memset(state->chroma_classes, 0, sizeof(state->chroma_classes));
+    state->chroma_key = -1;
+    memset(&state->report, 0, sizeof(state->report));
+    state->report_rate = 0;
+    queue_format_update(state);
+    g_mutex_unlock(&state->data_mutex);
+}
+
+// ========================================
+// SPECTROGRAM TEXTURE RING
+// ========================================
+
+#define SPEC_STRIDE (VISUALIZER_SPECTROGRAM_COLUMNS * 4)
+#define SPEC_PIXELS_SIZE (SPEC_STRIDE * SPECTROGRAM_ROWS)
+
+// Intensity -> theme foreground color with intensity as (premultiplied) alpha
+static void update_intensity_lut(VisualizerState *state) {
+    GdkRGBA fg;
+    gtk_widget_get_color(state->view, &fg);
+    if (gdk_rgba_equal(&fg, &state->intensity_lut_color)) return;
+
+    state->intensity_lut_color = fg;
+    for (int i = 0; i < 256; i++) {
+        gdouble a = (i / 255.0) * fg.alpha;
+        state->intensity_lut[i][0] = (guint8)(fg.red * a * 255.0 + 0.5);
+        state->intensity_lut[i][1] = (guint8)(fg.green * a * 255.0 + 0.5);
+        state->intensity_lut[i][2] = (guint8)(fg.blue * a * 255.0 + 0.5);
+        state->intensity_lut[i][3] = (guint8)(a * 255.0 + 0.5);
+    }
+}
+
+static void spectrogram_clear(VisualizerState *state) {
+    g_mutex_lock(&state->data_mutex);
+    state->spec_column_count = 0;
+    g_mutex_unlock(&state->data_mutex);
+
+    memset(state->spec_pixels, 0, SPEC_PIXELS_SIZE);
+    state->spec_write_col = 0;
+    g_clear_object(&state->spec_texture);
+}
+
+// Move published columns into the pixel ring and upload just those columns.
+// Returns TRUE if the texture changed.
+static gboolean spectrogram_upload(VisualizerState *state) {
+    guint8 columns[SPECTROGRAM_PENDING][SPECTROGRAM_ROWS];
+    guint n_columns;
+
+    g_mutex_lock(&state->data_mutex);
+    n_columns = state->spec_column_count;
+    memcpy(columns, state->spec_columns, n_columns * SPECTROGRAM_ROWS);
+    state->spec_column_count = 0;
+    g_mutex_unlock(&state->data_mutex);
+
+    if (n_columns == 0) return FALSE;
+
+    update_intensity_lut(state);
+
+    // Write columns; if more arrived than fit, only the newest survive
+    guint first = n_columns > VISUALIZER_SPECTROGRAM_COLUMNS ? n_columns - VISUALIZER_SPECTROGRAM_COLUMNS : 0;
+    guint start_col = state->spec_write_col;
+    for (guint c = first; c < n_columns; c++) {
+        guint8 *dst = state->spec_pixels + state->spec_write_col * 4;
+        for (int r = 0; r < SPECTROGRAM_ROWS; r++) {
+            // Row 0 of the texture is the top = highest frequency
+            memcpy(dst + (SPECTROGRAM_ROWS - 1 - r) * SPEC_STRIDE, state->intensity_lut[columns[c][r]], 4);
+        }
+        state->spec_write_col = (state->spec_write_col + 1) % VISUALIZER_SPECTROGRAM_COLUMNS;
+    }
+    guint written = n_columns - first;
+
+    GBytes *bytes = g_bytes_new(state->spec_pixels, SPEC_PIXELS_SIZE);
+    GdkTexture *texture;
+
+#if GTK_CHECK_VERSION(4, 16, 0)
+    GdkMemoryTextureBuilder *builder = gdk_memory_texture_builder_new();
+    gdk_memory_texture_builder_set_bytes(builder, bytes);
+    gdk_memory_texture_builder_set_stride(builder, SPEC_STRIDE);
+    gdk_memory_texture_builder_set_width(builder, VISUALIZER_SPECTROGRAM_COLUMNS);
+    gdk_memory_texture_builder_set_height(builder, SPECTROGRAM_ROWS);
+    gdk_memory_texture_builder_set_format(builder, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED);
+
+    // Only the new columns differ from the previous texture (1 or 2 rects
+    // when the write position wrapped)
+    if (state->spec_texture) {
+        cairo_region_t *region = cairo_region_create();
+        guint span = MIN(written, VISUALIZER_SPECTROGRAM_COLUMNS - start_col);
+        cairo_region_union_rectangle(region, &(cairo_rectangle_int_t) {
+            (int)start_col, 0, (int)span, SPECTROGRAM_ROWS });
+        if (written > span) {
+            cairo_region_union_rectangle(region, &(cairo_rectangle_int_t) {
+                0, 0, (int)(written - span), SPECTROGRAM_ROWS });
+        }
+        gdk_memory_texture_builder_set_update_texture(builder, state->spec_texture);
+        gdk_memory_texture_builder_set_update_region(builder, region);
+        cairo_region_destroy(region);
+    }
+
+    texture = gdk_memory_texture_builder_build(builder);
+    g_object_unref(builder);
+#else
+    // Older GTK: no partial uploads, the whole ring is uploaded
+    (void)start_col;
+    texture = gdk_memory_texture_new(VISUALIZER_SPECTROGRAM_COLUMNS, SPECTROGRAM_ROWS,
+                                     GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, bytes, SPEC_STRIDE);
+#endif
+
+    g_bytes_unref(bytes);
+    g_clear_object(&state->spec_texture);
+    state->spec_texture = texture;
+    return TRUE;
+}
+
+// Spectrogram mode: the ring texture drawn twice, each half clipped, so the
+// oldest column is always at the left edge without moving pixels
+static void snapshot_spectrogram(GtkWidget *widget, GtkSnapshot *snapshot,
+                                 int width, int height, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    (void)widget;
+
+    if (!state->spec_texture) return;
+
+    gfloat col_w = (gfloat)width / VISUALIZER_SPECTROGRAM_COLUMNS;
+    gfloat split = (VISUALIZER_SPECTROGRAM_COLUMNS - state->spec_write_col) * col_w;
+
+    // Oldest part: columns [write_col, end) at the left
+    gtk_snapshot_push_clip(snapshot, &GRAPHENE_RECT_INIT(0, 0, split, height));
+    gtk_snapshot_append_texture(snapshot, state->spec_texture,
+                                &GRAPHENE_RECT_INIT(split - width, 0, width, height));
+    gtk_snapshot_pop(snapshot);
+
+    // Newest part: columns [0, write_col) after it
+    if (state->spec_write_col > 0) {
+        gtk_snapshot_push_clip(snapshot, &GRAPHENE_RECT_INIT(split, 0, width - split, height));
+        gtk_snapshot_append_texture(snapshot, state->spec_texture,
+                                    &GRAPHENE_RECT_INIT(split, 0, width, height));
+        gtk_snapshot_pop(snapshot);
+    }
+}
+
+// ========================================
+// GONIOMETER
+// ========================================
+
+#define GONIO_STRIDE (GONIOMETER_SIZE * 4)
+
+// Rebuild the scope texture from the latest published image. The whole
+// image changes every frame (it decays), so it is one plain upload.
+static gboolean goniometer_upload(VisualizerState *state) {
+    guint8 image[GONIOMETER_SIZE * GONIOMETER_SIZE];
+
+    g_mutex_lock(&state->data_mutex);
+    gboolean dirty = state->gonio_dirty;
+    if (dirty) {
+        memcpy(image, state->gonio_image, sizeof(image));
+        state->gonio_dirty = FALSE;
+    }
+    g_mutex_unlock(&state->data_mutex);
+
+    if (!dirty) return FALSE;
+
+    update_intensity_lut(state);
+    for (int i = 0; i < GONIOMETER_SIZE * GONIOMETER_SIZE; i++) {
+        memcpy(state->gonio_pixels + i * 4, state->intensity_lut[image[i]], 4);
+    }
+
+    GBytes *bytes = g_bytes_new(state->gonio_pixels, GONIO_STRIDE * GONIOMETER_SIZE);
+    g_clear_object(&state->gonio_texture);
+    state->gonio_texture = gdk_memory_texture_new(GONIOMETER_SIZE, GONIOMETER_SIZE,
+                                                  GDK_MEMORY_R8G8B8A8_PREMULTIPLIED,
+                                                  bytes, GONIO_STRIDE);
+    g_bytes_unref(bytes);
+    return TRUE;
+}
+
+// ========================================
+// OSCILLOSCOPE
+// ========================================
+
+// Take the latest decimated trace for drawing; FALSE if nothing changed
+static gboolean oscilloscope_take(VisualizerState *state) {
+    g_mutex_lock(&state->data_mutex);
+    gboolean dirty = state->scope_dirty;
+    if (dirty) {
+        guint n = state->scope_column_count;
+        memcpy(state->scope_draw_min, state->scope_min, n * sizeof(gfloat));
+        memcpy(state->scope_draw_max, state->scope_max, n * sizeof(gfloat));
+        state->scope_draw_count = n;
+        state->scope_draw_triggered = state->scope_triggered;
+        state->scope_dirty = FALSE;
+    }
+    g_mutex_unlock(&state->data_mutex);
+    return dirty;
+}
+
+// ========================================
+// FORMAT LABEL
+// ========================================
+
+// Bits per sample of an integer format, 0 for float or unknown
+static guint format_depth(enum spa_audio_format format) {
+    switch (format) {
+        case SPA_AUDIO_FORMAT_S16_LE:
+        case SPA_AUDIO_FORMAT_S16_BE:
+        case SPA_AUDIO_FORMAT_S16P:
+            return 16;
+        case SPA_AUDIO_FORMAT_S24_LE:
+        case SPA_AUDIO_FORMAT_S24_BE:
+        case SPA_AUDIO_FORMAT_S24P:
+        case SPA_AUDIO_FORMAT_S24_32_LE:
+        case SPA_AUDIO_FORMAT_S24_32_BE:
+        case SPA_AUDIO_FORMAT_S24_32P:
+            return 24;
+        case SPA_AUDIO_FORMAT_S32_LE:
+        case SPA_AUDIO_FORMAT_S32_BE:
+        case SPA_AUDIO_FORMAT_S32P:
+            return 32;
+        default:
+            return 0;
+    }
+}
+
+// Bits a format carries exactly: integer depth, or float mantissa; 0 if unknown
+static guint format_precision(enum spa_audio_format format) {
+    switch (format) {
+        case SPA_AUDIO_FORMAT_F32_LE:
+        case SPA_AUDIO_FORMAT_F32_BE:
+        case SPA_AUDIO_FORMAT_F32P:
+            return 24;
+        case SPA_AUDIO_FORMAT_F64_LE:
+        case SPA_AUDIO_FORMAT_F64_BE:
+        case SPA_AUDIO_FORMAT_F64P:
+            return 53;
+        default:
+            return format_depth(format);
+    }
+}
+
+static const gchar *format_name(enum spa_audio_format format) {
+    const gchar *name = spa_debug_type_find_short_name(spa_type_audio_format, format);
+    return name ? name : "?";
+}
+
+// "S24LE · 96 kHz · 2ch · bit-perfect · upsampled?" plus an explanatory
+// tooltip. Falls back to the capture rate and measured depth until the
+// player's node format is known; hidden without a stream.
+static void update_format_label(VisualizerState *state) {
+    g_mutex_lock(&state->data_mutex);
+    gboolean dirty = state->report_dirty;
+    AuthenticityReport report = state->report;
+    guint32 rate = state->report_rate;
+    struct spa_audio_info_raw stream = state->stream_format;
+    struct spa_audio_info_raw sink = state->sink_format;
+    gchar *path = g_strdup(state->signal_path);
+    gint latency_ms = state->bar_latency_ms;
+    state->report_dirty = FALSE;
+    g_mutex_unlock(&state->data_mutex);
+
+    if (!dirty || !state->format_label) {
+        g_free(path);
+        return;
+    }
+
+    GtkWidget *label = state->format_label;
+    if (rate == 0 && stream.rate == 0) {
+        gtk_widget_set_visible(label, FALSE);
+        g_free(path);
+        return;
+    }
+
+    GString *text = g_string_new(NULL);
+    GString *tooltip = g_string_new(NULL);
+
+    if (stream.rate > 0) {
+        guint depth = format_depth(stream.format);
+        g_string_append_printf(text, "%s · %g kHz · %uch",
+                               format_name(stream.format), stream.rate / 1000.0, stream.channels);
+        g_string_append_printf(tooltip, "Player: %s, %g kHz, %u channels\n",
+                               format_name(stream.format), stream.rate / 1000.0, stream.channels);
+
+        // What the samples actually use, where that tells more than the container
+        if (report.bits == 32 && depth > 0) {
+            g_string_append(tooltip, "Samples are off the integer grid: the player applies volume or DSP\n");
+        } else if (report.bits > 0 && depth > (guint)report.bits) {
+            g_string_append_printf(tooltip, "%d-bit content padded to %u bits\n", report.bits, depth);
+        }
+
+        if (sink.rate > 0) {
+            g_string_append_printf(tooltip, "Sink: %s, %g kHz, %u channels\n",
+                                   format_name(sink.format), sink.rate / 1000.0, sink.channels);
+            // Bit-perfect needs the same rate, no remix and no lost bits
+            guint sink_precision = format_precision(sink.format);
+            gboolean narrowed = sink_precision < format_precision(stream.format);
+            gboolean remixed = sink.channels != stream.channels;
+            if (narrowed && sink_precision > 0) {
+                g_string_append_printf(tooltip, "Sink narrows the samples to %u bits\n", sink_precision);
+            }
+            if (remixed) {
+                g_string_append_printf(tooltip, "Sink remixes %u to %u channels\n",
+                                       stream.channels, sink.channels);
+            }
+
+            if (sink.rate == stream.rate && (narrowed || remixed)) {
+                g_string_append(text, " · same rate");
+            } else if (sink.rate == stream.rate) {
+                g_string_append(text, report.bits == 32 ? " · native rate" : " · bit-perfect");
+            } else {
+                g_string_append_printf(text, " → %g kHz resampled", sink.rate / 1000.0);
+            }
+        }
+    } else {
+        g_string_append_printf(text, "%g kHz", rate / 1000.0);
+
+        switch (report.bits) {
+            case 16:
+                g_string_append(text, " · 16-bit");
+                break;
+            case 24:
+                g_string_append(text, " · 24-bit");
+                break;
+            case 32:
+                g_string_append(text, " · float");
+                g_string_append(tooltip, "Samples are off the 24-bit grid: volume or DSP is altering the stream\n");
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Upsampling done by the graph is not the recording's fault: judge the player's rate
+    if (stream.rate > 0) {
+        if (report.verdict == AUTHENTICITY_UPSAMPLED && stream.rate <= 48000) {
+            report.verdict = AUTHENTICITY_CLEAN;
+        }
+        rate = stream.rate;
+    }
+
+    gboolean suspect = FALSE;
+    switch (report.verdict) {
+        case AUTHENTICITY_HIRES:
+            g_string_append(text, " · hi-res");
+            g_string_append(tooltip, "Real content above 22.05 kHz");
+            break;
+        case AUTHENTICITY_UPSAMPLED:
+            suspect = TRUE;
+            g_string_append(text, " · upsampled?");
+            if (report.cutoff_hz > 0.0) {
+                g_string_append_printf(tooltip, "Content stops at %.1f kHz: likely a CD-rate master upsampled to %g kHz",
+                                       report.cutoff_hz / 1000.0, rate / 1000.0);
+            } else {
+                g_string_append(tooltip, "No content above 22.05 kHz: likely upsampled from 44.1/48 kHz");
+            }
+            break;
+        case AUTHENTICITY_LOSSY:
+            suspect = TRUE;
+            g_string_append(text, " · lossy?");
+            g_string_append_printf(tooltip, "Hard low-pass at %.1f kHz: likely decoded from a lossy (MP3/AAC) source",
+                                   report.cutoff_hz / 1000.0);
+            break;
+        case AUTHENTICITY_CLEAN:
+            g_string_append(tooltip, "No lossy low-pass detected");
+            break;
+        default:
+            g_string_append(tooltip, "Analyzing…");
+            break;
+    }
+
+    if (latency_ms > 0) {
+        g_string_append_printf(tooltip, "\nBars delayed %d ms to match the sink's output latency", latency_ms);
+    }
+    if (path) {
+        g_string_append_printf(tooltip, "\n\nPath: %s", path);
+        g_free(path);
+    }
+
+    gtk_label_set_text(GTK_LABEL(label), text->str);
+    gtk_widget_set_tooltip_text(label, tooltip->str);
+    if (suspect) {
+        gtk_widget_add_css_class(label, "format-suspect");
+    } else {
+        gtk_widget_remove_css_class(label, "format-suspect");
+    }
+    gtk_widget_set_visible(label, TRUE);
+
+    g_string_free(text, TRUE);
+    g_string_free(tooltip, TRUE);
+}
+
+static gboolean on_format_update(gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    g_mutex_lock(&state->data_mutex);
+    state->format_update = 0;
     g_mutex_unlock(&state->data_mutex);
+
+    update_format_label(state);
+    return G_SOURCE_REMOVE;
+}
+
+// Mark the label stale and post one refresh to the GTK main context. Called
+// with data_mutex held, from the PipeWire thread (format, graph, latency and
+// authenticity changes) or the GTK thread; nothing polls the label.
+static void queue_format_update(VisualizerState *state) {
+    state->report_dirty = TRUE;
+    if (state->format_update == 0 && state->format_label) {
+        state->format_update = g_idle_add(on_format_update, state);
+    }
 }
 
-// Update visualizer bars (~60fps) - called from GTK main thread
+// Update visualizer bars once per frame - called from GTK main thread
+// Peak-hold and fall-off use the real time since the previous frame, so bar
+// motion does not depend on the display's refresh rate.
 static gboolean update_visualizer(gpointer user_data) {
     VisualizerState *state = (VisualizerState *)user_data;
 
     if (!state->is_showing) {
+        state->last_render_time = 0;
+        return G_SOURCE_CONTINUE;
+    }
+
+    if (g_atomic_int_get(&state->mode) == VISUALIZER_MODE_SPECTROGRAM) {
+        // Only redraw when new columns arrived
+        if (spectrogram_upload(state)) {
+            gtk_widget_queue_draw(state->view);
+        }
+        state->last_render_time = 0;
+        return G_SOURCE_CONTINUE;
+    }
+
+    if (g_atomic_int_get(&state->mode) == VISUALIZER_MODE_GONIOMETER) {
+        if (goniometer_upload(state)) {
+            gtk_widget_queue_draw(state->view);
+        }
+        state->last_render_time = 0;
+        return G_SOURCE_CONTINUE;
+    }
+
+    if (g_atomic_int_get(&state->mode) == VISUALIZER_MODE_OSCILLOSCOPE) {
+        if (oscilloscope_take(state)) {
+            gtk_widget_queue_draw(state->view);
+        }
+        state->last_render_time = 0;
+        return G_SOURCE_CONTINUE;
+    }
+
+    if (g_atomic_int_get(&state->mode) != VISUALIZER_MODE_BARS) {
+        gtk_widget_queue_draw(state->view);
+        state->last_render_time = 0;
         return G_SOURCE_CONTINUE;
     }
 
+    gint64 now = g_get_monotonic_time();
+    gdouble dt = state->last_render_time > 0 ? (now - state->last_render_time) / 1000000.0 : 0.0;
+    state->last_render_time = now;
+
+    // Newest frame that is due; later ones wait for their audio to be heard
+    gdouble targets[VISUALIZER_BARS];
+    guint taken = 0;
     g_mutex_lock(&state->data_mutex);
+    while (state->bar_queue_count > 0 && state->bar_queue[state->bar_queue_tail].due <= now) {
+        const VisualizerBarFrame *frame = &state->bar_queue[state->bar_queue_tail];
+        memcpy(state->bar_heights, frame->heights, sizeof(state->bar_heights));
+        state->presenting = *frame;
+        state->bar_queue_tail = (state->bar_queue_tail + 1) & (VISUALIZER_BAR_QUEUE - 1);
+        state->bar_queue_count--;
+        taken++;
+    }
+    state->frames_dropped += state->bar_queue_dropped;
+    state->bar_queue_dropped = 0;
+    memcpy(targets, state->bar_heights, sizeof(targets));
+    g_mutex_unlock(&state->data_mutex);
+
+    // Only the newest frame taken gets painted; so does none still waiting for the last paint
+    if (taken > 0) {
+        state->frames_dropped += taken - 1 + (state->presenting_pending ? 1 : 0);
+        state->presenting_pending = TRUE;
+        gtk_widget_queue_draw(state->bars_box);
+    }
 
     for (int i = 0; i < VISUALIZER_BARS; i++) {
         gint min_size = 1;
         gint max_size = state->is_vertical ? 50 : 24;
 
+        if (targets[i] >= state->bar_display[i]) {
+            // New peak: jump to it and hold
+            state->bar_display[i] = targets[i];
+            state->bar_hold_until[i] = now + VISUALIZER_PEAK_HOLD_MS * 1000;
+        } else if (now >= state->bar_hold_until[i]) {
+            // Hold expired: fall toward the analysis value
+            state->bar_display[i] = MAX(targets[i],
+                                        state->bar_display[i] - VISUALIZER_FALL_PER_SEC * dt);
+        }
+
         // Decay to minimum if no audio
-        if (state->bar_heights[i] < 0.01) {
-            state->bar_heights[i] = 0.0;
+        if (state->bar_display[i] < 0.01) {
+            state->bar_display[i] = 0.0;
         }
 
         // Calculate bar size
-        gint bar_size = min_size + (gint)(state->bar_heights[i] * (max_size - min_size));
+        gint bar_size = min_size + (gint)(state->bar_display[i] * (max_size - min_size));
 
         // Update size based on orientation
         if (state->is_vertical) {
@@ -459,38 +1546,393 @@ static gboolean update_visualizer(gpointer user_data) {
         gtk_widget_set_opacity(state->bars[i], bar_size <= min_size ? 0.0 : 1.0);
     }
 
+    return G_SOURCE_CONTINUE;
+}
+
+// Map a dB / LUFS value onto a 0-1 meter scale
+#define METER_FLOOR_DB (-60.0)
+#define METER_CEIL_DB 0.0
+#define METER_TP_WARN_DB (-1.0)   // EBU R128 max true-peak
+
+static gdouble meter_fraction(gdouble db) {
+    if (!isfinite(db) || db <= METER_FLOOR_DB) return 0.0;
+    return MIN(1.0, (db - METER_FLOOR_DB) / (METER_CEIL_DB - METER_FLOOR_DB));
+}
+
+static void snapshot_text(GtkWidget *widget, GtkSnapshot *snapshot, const gchar *text,
+                          PangoFontDescription *font, gfloat x, gfloat y,
+                          gboolean align_right, const GdkRGBA *color) {
+    PangoLayout *layout = gtk_widget_create_pango_layout(widget, text);
+    pango_layout_set_font_description(layout, font);
+
+    if (align_right) {
+        int text_width;
+        pango_layout_get_pixel_size(layout, &text_width, NULL);
+        x -= text_width;
+    }
+
+    gtk_snapshot_save(snapshot);
+    gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(x, y));
+    gtk_snapshot_append_layout(snapshot, layout, color);
+    gtk_snapshot_restore(snapshot);
+    g_object_unref(layout);
+}
+
+// Loudness mode: one row each for momentary, short-term, integrated and true-peak
+static void snapshot_loudness(GtkWidget *widget, GtkSnapshot *snapshot,
+                              int width, int height, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    LoudnessReadings readings;
+    g_mutex_lock(&state->data_mutex);
+    readings = state->loudness_readings;
     g_mutex_unlock(&state->data_mutex);
 
-    return G_SOURCE_CONTINUE;
+    const struct {
+        const gchar *label;
+        gdouble bar;      // Drives the bar
+        gdouble value;    // Printed value
+    } rows[] = {
+        { "M",  readings.momentary,           readings.momentary },
+        { "S",  readings.short_term,          readings.short_term },
+        { "I",  readings.integrated,          readings.integrated },
+        { "TP", readings.true_peak_momentary, readings.true_peak },
+    };
+    const int n_rows = G_N_ELEMENTS(rows);
+
+    GdkRGBA fg;
+    gtk_widget_get_color(widget, &fg);
+    GdkRGBA track = fg;
+    track.alpha *= 0.15f;
+    GdkRGBA fill = fg;
+    fill.alpha *= 0.85f;
+    const GdkRGBA warn = { 0.95f, 0.3f, 0.3f, 0.9f };
+
+    gfloat row_h = (gfloat)height / n_rows;
+    gfloat label_w = 16.0f;
+    gfloat value_w = 40.0f;
+    gfloat bar_w = MAX(0.0f, width - label_w - value_w - 4.0f);
+
+    PangoFontDescription *font = pango_font_description_new();
+    pango_font_description_set_absolute_size(font, MAX(row_h - 2.0f, 1.0f) * PANGO_SCALE);
+
+    for (int i = 0; i < n_rows; i++) {
+        gfloat y = i * row_h;
+        gboolean is_tp = i == n_rows - 1;
+
+        gtk_snapshot_append_color(snapshot, &track,
+                                  &GRAPHENE_RECT_INIT(label_w, y + 1.0f, bar_w, row_h - 2.0f));
+
+        gfloat filled = (gfloat)(meter_fraction(rows[i].bar) * bar_w);
+        gboolean over = is_tp && isfinite(rows[i].bar) && rows[i].bar > METER_TP_WARN_DB;
+        if (filled > 0.0f) {
+            gtk_snapshot_append_color(snapshot, over ? &warn : &fill,
+                                      &GRAPHENE_RECT_INIT(label_w, y + 1.0f, filled, row_h - 2.0f));
+        }
+
+        gchar value[16];
+        if (isfinite(rows[i].value)) {
+            g_snprintf(value, sizeof(value), "%.1f", rows[i].value);
+        } else {
+            g_strlcpy(value, "-inf", sizeof(value));
+        }
+
+        snapshot_text(widget, snapshot, rows[i].label, font, 0.0f, y, FALSE, &fg);
+        snapshot_text(widget, snapshot, value, font, (gfloat)width, y, TRUE,
+                      is_tp && isfinite(rows[i].value) && rows[i].value > METER_TP_WARN_DB
+                          ? &warn : &fg);
+    }
+
+    pango_font_description_free(font);
+}
+
+// Goniometer mode: square scope on the left, correlation meter beside it
+static void snapshot_goniometer(GtkWidget *widget, GtkSnapshot *snapshot,
+                                int width, int height, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    g_mutex_lock(&state->data_mutex);
+    gfloat correlation = state->gonio_correlation;
+    g_mutex_unlock(&state->data_mutex);
+
+    GdkRGBA fg;
+    gtk_widget_get_color(widget, &fg);
+    GdkRGBA track = fg;
+    track.alpha *= 0.15f;
+    GdkRGBA fill = fg;
+    fill.alpha *= 0.85f;
+    const GdkRGBA warn = { 0.95f, 0.3f, 0.3f, 0.9f };
+
+    gfloat side = MIN(width, height);
+    if (state->gonio_texture) {
+        gtk_snapshot_append_texture(snapshot, state->gonio_texture,
+                                    &GRAPHENE_RECT_INIT(0, (height - side) / 2.0f, side, side));
+    }
+
+    // Correlation: -1 .. +1 with the centre at 0; negative values are a
+    // polarity problem and are drawn in the warning color
+    gfloat x0 = side + 8.0f;
+    gfloat value_w = 36.0f;
+    gfloat bar_w = MAX(0.0f, width - x0 - value_w - 4.0f);
+    gfloat bar_h = MIN(8.0f, (gfloat)height);
+    gfloat y = (height - bar_h) / 2.0f;
+    gfloat center = x0 + bar_w / 2.0f;
+
+    gtk_snapshot_append_color(snapshot, &track, &GRAPHENE_RECT_INIT(x0, y, bar_w, bar_h));
+    gfloat extent = CLAMP(correlation, -1.0f, 1.0f) * bar_w / 2.0f;
+    gtk_snapshot_append_color(snapshot, correlation < 0.0f ? &warn : &fill,
+                              &GRAPHENE_RECT_INIT(MIN(center, center + extent), y,
+                                                  fabsf(extent), bar_h));
+    gtk_snapshot_append_color(snapshot, &fg,
+                              &GRAPHENE_RECT_INIT(center - 0.5f, y - 2.0f, 1.0f, bar_h + 4.0f));
+
+    gchar value[16];
+    g_snprintf(value, sizeof(value), "%+.2f", correlation);
+    PangoFontDescription *font = pango_font_description_new();
+    pango_font_description_set_absolute_size(font, MAX(bar_h + 2.0f, 1.0f) * PANGO_SCALE);
+    snapshot_text(widget, snapshot, value, font, (gfloat)width, y - 2.0f, TRUE,
+                  correlation < 0.0f ? &warn : &fg);
+    pango_font_description_free(font);
+}
+
+// Oscilloscope mode: one column per device pixel, each spanning its min..max,
+// stroked as a single zig-zag path. Free-running traces are drawn dimmer.
+static void snapshot_oscilloscope(GtkWidget *widget, GtkSnapshot *snapshot,
+                                  int width, int height, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    int scale = gtk_widget_get_scale_factor(widget);
+
+    // Ask the analysis thread for exactly as many columns as we have pixels
+    g_atomic_int_set(&state->scope_columns, MIN(width * scale, OSCILLOSCOPE_MAX_COLUMNS));
+
+    GdkRGBA fg;
+    gtk_widget_get_color(widget, &fg);
+    GdkRGBA axis = fg;
+    axis.alpha *= 0.15f;
+    GdkRGBA line = fg;
+    if (!state->scope_draw_triggered) line.alpha *= 0.6f;
+
+    gfloat mid = height / 2.0f;
+    gfloat amp = MAX(0.0f, mid - 1.0f);
+    gtk_snapshot_append_color(snapshot, &axis, &GRAPHENE_RECT_INIT(0, mid - 0.5f, width, 1.0f));
+
+    guint n = state->scope_draw_count;
+    if (n == 0) return;
+    gfloat step = (gfloat)width / n;
+
+#if GTK_CHECK_VERSION(4, 14, 0)
+    GskPathBuilder *builder = gsk_path_builder_new();
+    for (guint c = 0; c < n; c++) {
+        gfloat x = (c + 0.5f) * step;
+        gfloat top = mid - state->scope_draw_max[c] * amp;
+        gfloat bottom = mid - state->scope_draw_min[c] * amp;
+        if (c == 0) {
+            gsk_path_builder_move_to(builder, x, top);
+        } else {
+            gsk_path_builder_line_to(builder, x, top);
+        }
+        gsk_path_builder_line_to(builder, x, bottom);
+    }
+    GskPath *path = gsk_path_builder_free_to_path(builder);
+    GskStroke *stroke = gsk_stroke_new(1.0f);
+    gsk_stroke_set_line_join(stroke, GSK_LINE_JOIN_ROUND);
+    gtk_snapshot_append_stroke(snapshot, path, stroke, &line);
+    gsk_stroke_free(stroke);
+    gsk_path_unref(path);
+#else
+    // No path API before 4.14: one thin rectangle per column
+    for (guint c = 0; c < n; c++) {
+        gfloat top = mid - state->scope_draw_max[c] * amp;
+        gfloat bottom = mid - state->scope_draw_min[c] * amp;
+        gtk_snapshot_append_color(snapshot, &line,
+                                  &GRAPHENE_RECT_INIT(c * step, top - 0.5f, MAX(step, 1.0f),
+                                                      MAX(bottom - top, 0.0f) + 1.0f));
+    }
+#endif
+}
+
+// Chroma mode: one bar per pitch class (C..B) with the estimated key on the
+// right. Bars in the key's scale are drawn brighter, the tonic brightest.
+static void snapshot_chroma(GtkWidget *widget, GtkSnapshot *snapshot,
+                            int width, int height, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    static const int major_scale[CHROMA_CLASSES] = { 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1 };
+    static const int minor_scale[CHROMA_CLASSES] = { 1, 0, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0 };
+
+    gfloat classes[CHROMA_CLASSES];
+    g_mutex_lock(&state->data_mutex);
+    memcpy(classes, state->chroma_classes, sizeof(classes));
+    gint key = state->chroma_key;
+    g_mutex_unlock(&state->data_mutex);
+
+    GdkRGBA fg;
+    gtk_widget_get_color(widget, &fg);
+    GdkRGBA dim = fg;
+    dim.alpha *= 0.35f;
+    GdkRGBA in_key = fg;
+    in_key.alpha *= 0.7f;
+
+    gfloat label_h = CLAMP(height * 0.3f, 1.0f, 10.0f);
+    gfloat key_w = 64.0f;
+    gfloat area_w = MAX(0.0f, width - key_w);
+    gfloat slot = area_w / CHROMA_CLASSES;
+    gfloat bar_w = MAX(1.0f, slot - 2.0f);
+    gfloat bar_area = MAX(0.0f, height - label_h - 1.0f);
+
+    PangoFontDescription *font = pango_font_description_new();
+    pango_font_description_set_absolute_size(font, label_h * PANGO_SCALE);
+
+    const int *scale = key >= CHROMA_CLASSES ? minor_scale : major_scale;
+    int tonic = key % CHROMA_CLASSES;
+    for (int c = 0; c < CHROMA_CLASSES; c++) {
+        const GdkRGBA *color = &dim;
+        if (key >= 0 && c == tonic) {
+            color = &fg;
+        } else if (key >= 0 && scale[(c - tonic + CHROMA_CLASSES) % CHROMA_CLASSES]) {
+            color = &in_key;
+        }
+
+        gfloat h = CLAMP(classes[c], 0.0f, 1.0f) * bar_area;
+        gfloat x = c * slot + (slot - bar_w) / 2.0f;
+        if (h > 0.0f) {
+            gtk_snapshot_append_color(snapshot, color, &GRAPHENE_RECT_INIT(x, bar_area - h, bar_w, h));
+        }
+        snapshot_text(widget, snapshot, chroma_class_name(c), font, x, bar_area + 1.0f, FALSE, color);
+    }
+
+    if (key >= 0) {
+        pango_font_description_set_absolute_size(font, CLAMP(height * 0.4f, 1.0f, 14.0f) * PANGO_SCALE);
+        snapshot_text(widget, snapshot, chroma_key_name(key), font, (gfloat)width,
+                      height * 0.3f, TRUE, &fg);
+    }
+    pango_font_description_free(font);
 }
 
 // Fade animation (for smooth show/hide)
-static gboolean fade_visualizer(gpointer user_data) {
+static void fade_step(gdouble progress, gpointer user_data) {
     VisualizerState *state = (VisualizerState *)user_data;
+    gdouble target = state->is_showing ? 1.0 : 0.0;
 
-    if (state->is_showing) {
-        state->fade_opacity += 0.025;  // Slower = smoother
-        if (state->fade_opacity >= 1.0) {
-            state->fade_opacity = 1.0;
-            gtk_widget_set_opacity(state->container, 1.0);
-            state->fade_timer = 0;
-            return G_SOURCE_REMOVE;
-        }
-        // Apply easing for smooth fade-in
-        gdouble eased = ease_out_sine(state->fade_opacity);
-        gtk_widget_set_opacity(state->container, eased);
-    } else {
-        state->fade_opacity -= 0.05;
-        if (state->fade_opacity <= 0.0) {
-            state->fade_opacity = 0.0;
-            state->fade_timer = 0;
-            return G_SOURCE_REMOVE;
+    state->fade_opacity = state->fade_from + (target - state->fade_from) * progress;
+    gtk_widget_set_opacity(state->container, state->fade_opacity);
+}
+
+static void fade_done(gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    state->fade_animation = 0;
+
+    // Faded out: nothing to render until the next show
+    if (!state->is_showing) {
+        animation_clear(&state->render_ticker);
+    }
+}
+
+static void start_fade(VisualizerState *state) {
+    animation_clear(&state->fade_animation);
+    state->fade_from = state->fade_opacity;
+
+    guint duration = state->is_showing
+        ? (guint)(VISUALIZER_FADE_IN_MS * (1.0 - state->fade_opacity))
+        : (guint)(VISUALIZER_FADE_OUT_MS * state->fade_opacity);
+    state->fade_animation = animation_start(state->container, duration,
+                                            state->is_showing ? animation_ease_out_sine : NULL,
+                                            fade_step, fade_done, state);
+}
+
+// ========================================
+// AUDIO-TO-PHOTON INSTRUMENTATION
+// ========================================
+
+// The frame clock just painted: the bars taken last are on screen
+static void record_presented(VisualizerState *state, const VisualizerPaintedFrame *frame, gint64 presented) {
+    latency_series_add(&state->lat_capture_analysis, (frame->analyzed - frame->captured) / 1000.0f);
+    latency_series_add(&state->lat_analysis_present, (presented - frame->analyzed) / 1000.0f);
+    latency_series_add(&state->lat_capture_present, (presented - frame->captured) / 1000.0f);
+    latency_series_add(&state->lat_late, (presented - frame->due) / 1000.0f);
+    state->frames_presented++;
+}
+
+// Record painted frames whose timings are complete, oldest first. Frame
+// time is when a frame starts, not when it is shown, so it is only used when
+// the backend reports no presentation time or the timings are gone.
+static void resolve_painted_frames(VisualizerState *state, GdkFrameClock *clock) {
+    guint done = 0;
+
+    while (done < state->painted_count) {
+        const VisualizerPaintedFrame *frame = &state->painted[done];
+        GdkFrameTimings *timings = gdk_frame_clock_get_timings(clock, frame->frame_counter);
+        // Full: the oldest has waited long enough
+        if (timings && !gdk_frame_timings_get_complete(timings) &&
+            state->painted_count < VISUALIZER_PAINTED_FRAMES) {
+            break;
         }
-        gtk_widget_set_opacity(state->container, state->fade_opacity);
+
+        gint64 presented = timings ? gdk_frame_timings_get_presentation_time(timings) : 0;
+        record_presented(state, frame, presented > 0 ? presented : frame->frame_time);
+        done++;
+        if (state->painted_count == VISUALIZER_PAINTED_FRAMES) break;
     }
 
+    if (done > 0) {
+        state->painted_count -= done;
+        memmove(state->painted, state->painted + done, state->painted_count * sizeof(state->painted[0]));
+    }
+}
 
-    return G_SOURCE_CONTINUE;
+static void on_after_paint(GdkFrameClock *clock, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+
+    resolve_painted_frames(state, clock);
+    if (!state->presenting_pending) return;
+    state->presenting_pending = FALSE;
+
+    VisualizerPaintedFrame *painted = &state->painted[state->painted_count++];
+    painted->captured = state->presenting.captured;
+    painted->analyzed = state->presenting.analyzed;
+    painted->due = state->presenting.due;
+    painted->frame_counter = gdk_frame_clock_get_frame_counter(clock);
+    painted->frame_time = gdk_frame_clock_get_frame_time(clock);
+}
+
+static void on_container_realize(GtkWidget *widget, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    state->frame_clock = gtk_widget_get_frame_clock(widget);
+    if (state->frame_clock) {
+        state->after_paint_handler = g_signal_connect(state->frame_clock, "after-paint",
+                                                      G_CALLBACK(on_after_paint), state);
+    }
+}
+
+static void on_container_unrealize(GtkWidget *widget, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    if (state->frame_clock && state->after_paint_handler > 0) {
+        g_signal_handler_disconnect(state->frame_clock, state->after_paint_handler);
+    }
+    state->after_paint_handler = 0;
+    state->frame_clock = NULL;
+    state->presenting_pending = FALSE;
+    state->painted_count = 0;
+}
+
+static void append_series(GString *text, const gchar *name, const LatencySeries *series) {
+    static const float ps[] = { 50.0f, 95.0f, 99.0f, 100.0f };
+    float values[G_N_ELEMENTS(ps)];
+    guint n = latency_series_percentiles(series, ps, G_N_ELEMENTS(ps), values);
+    if (n == 0) {
+        g_string_append_printf(text, "%-18s no frames yet\n", name);
+        return;
+    }
+    g_string_append_printf(text, "%-18s p50 %6.1f  p95 %6.1f  p99 %6.1f  max %6.1f ms  (n=%u)\n",
+                           name, values[0], values[1], values[2], values[3], n);
+}
+
+static void on_visualizer_clicked(GtkGestureClick *gesture, int n_press,
+                                  double x, double y, gpointer user_data) {
+    VisualizerState *state = (VisualizerState *)user_data;
+    (void)gesture; (void)n_press; (void)x; (void)y;
+
+    VisualizerMode next = (g_atomic_int_get(&state->mode) + 1) % VISUALIZER_MODE_COUNT;
+    visualizer_set_mode(state, next);
 }
 
 // Initialize visualizer
@@ -508,18 +1950,36 @@ VisualizerState* visualizer_init(gboolean is_vertical) {
     state->target_node_id = 0;
     state->target_node_name = NULL;
     state->target_found = FALSE;
-    state->agc_peak = AGC_MIN_THRESHOLD;
+    state->analysis_rate = 0;
+    state->mode = VISUALIZER_MODE_BARS;
+    viz_dsp_init(&state->dsp);
+    loudness_init(&state->loudness);
+    loudness_get_readings(&state->loudness, &state->loudness_readings);
+    spectrogram_init(&state->spectrogram);
+    state->spec_pixels = g_malloc0(SPEC_PIXELS_SIZE);
+    goniometer_init(&state->goniometer);
+    oscilloscope_init(&state->oscilloscope);
+    chroma_init(&state->chroma);
+    authenticity_init(&state->authenticity);
+    rt_health_init(&state->rt_health);
+    state->chroma_key = -1;
+    state->gonio_pixels = g_malloc0(GONIO_STRIDE * GONIOMETER_SIZE);
+
+    // Preallocated so the RT thread never allocates
+    spa_ringbuffer_init(&state->ring);
+    state->ring_data = g_new0(float, VISUALIZER_RING_FRAMES * VISUALIZER_RING_CHANNELS);
+    state->ring_channels = 0;
 
     g_mutex_init(&state->data_mutex);
 
     // Create node cache for searching when player changes
     state->audio_nodes = g_hash_table_new_full(g_direct_hash, g_direct_equal,
                                                 NULL, audio_node_info_free);
+    state->graph = pw_graph_new();
 
     // Zero out audio data
     for (int i = 0; i < VISUALIZER_BARS; i++) {
         state->bar_heights[i] = 0.0;
-        state->bar_smoothed[i] = 0.0;
     }
 
     // Create container based on orientation
@@ -546,6 +2006,29 @@ VisualizerState* visualizer_init(gboolean is_vertical) {
     g_print("✓ Visualizer container: %s layout (PipeWire per-player capture)\n",
             is_vertical ? "vertical" : "horizontal");
 
+    // Bars live in their own box so other modes can replace them
+    GtkWidget *bars_box = gtk_box_new(container_orient, 0);
+    state->bars_box = bars_box;
+    gtk_widget_set_hexpand(bars_box, TRUE);
+    gtk_widget_set_vexpand(bars_box, TRUE);
+    gtk_box_append(GTK_BOX(container), bars_box);
+
+    // Snapshot-rendered view for the meter modes
+    state->view = visualizer_view_new();
+    gtk_widget_set_hexpand(state->view, TRUE);
+    gtk_widget_set_vexpand(state->view, TRUE);
+    gtk_widget_set_visible(state->view, FALSE);
+    gtk_box_append(GTK_BOX(container), state->view);
+
+    // Present timestamps come from the frame clock that paints the bars
+    g_signal_connect(container, "realize", G_CALLBACK(on_container_realize), state);
+    g_signal_connect(container, "unrealize", G_CALLBACK(on_container_unrealize), state);
+
+    // Click cycles through the modes
+    GtkGesture *click = gtk_gesture_click_new();
+    g_signal_connect(click, "released", G_CALLBACK(on_visualizer_clicked), state);
+    gtk_widget_add_controller(container, GTK_EVENT_CONTROLLER(click));
+
     // Create bars
     for (int i = 0; i < VISUALIZER_BARS; i++) {
         GtkOrientation bar_orient = is_vertical ? GTK_ORIENTATION_HORIZONTAL : GTK_ORIENTATION_VERTICAL;
@@ -567,7 +2050,7 @@ VisualizerState* visualizer_init(gboolean is_vertical) {
             gtk_widget_set_halign(bar, GTK_ALIGN_FILL);
         }
 
-        gtk_box_append(GTK_BOX(container), bar);
+        gtk_box_append(GTK_BOX(bars_box), bar);
     }
 
     g_print("✓ %d bars created for %s layout\n", VISUALIZER_BARS, is_vertical ? "vertical" : "horizontal");
@@ -585,8 +2068,9 @@ VisualizerState* visualizer_init(gboolean is_vertical) {
         return state;
     }
 
-    // Start render loop
-    state->render_timer = g_timeout_add(1000 / VISUALIZER_UPDATE_FPS, update_visualizer, state);
+    // Wakes the thread loop to drain the capture ring
+    state->analysis_event = pw_loop_add_event(pw_thread_loop_get_loop(state->pw_loop),
+                                              on_analysis_event, state);
 
     return state;
 }
@@ -596,14 +2080,13 @@ void visualizer_show(VisualizerState *state) {
 
     state->is_showing = TRUE;
 
-    if (state->fade_timer > 0) {
-        g_source_remove(state->fade_timer);
-    }
-
     // Make visible, then fade in
     gtk_widget_set_visible(state->container, TRUE);
+    if (state->render_ticker == 0) {
+        state->render_ticker = animation_add_ticker(state->container, 0, update_visualizer, state);
+    }
     state->fade_opacity = 0.0;
-    state->fade_timer = g_timeout_add(16, fade_visualizer, state);
+    start_fade(state);
     g_print("Visualizer fading in\n");
 }
 
@@ -611,12 +2094,7 @@ void visualizer_hide(VisualizerState *state) {
     if (!state || !state->is_showing) return;
 
     state->is_showing = FALSE;
-
-    if (state->fade_timer > 0) {
-        g_source_remove(state->fade_timer);
-    }
-
-    state->fade_timer = g_timeout_add(16, fade_visualizer, state);
+    start_fade(state);
     g_print("Visualizer fading out\n");
 }
 
@@ -696,6 +2174,10 @@ void visualizer_stop(VisualizerState *state) {
         pw_stream_destroy(state->pw_stream);
         state->pw_stream = NULL;
     }
+    state->position = NULL;
+
+    unwatch_node_format(&state->stream_watch);
+    unwatch_node_format(&state->sink_watch);
 
     if (state->pw_registry) {
         pw_proxy_destroy((struct pw_proxy *)state->pw_registry);
@@ -707,6 +2189,13 @@ void visualizer_stop(VisualizerState *state) {
         state->pw_core = NULL;
     }
 
+    // The next registry announces every global again
+    pw_graph_free(state->graph);
+    state->graph = pw_graph_new();
+    g_mutex_lock(&state->data_mutex);
+    g_clear_pointer(&state->signal_path, g_free);
+    g_mutex_unlock(&state->data_mutex);
+
     state->is_running = FALSE;
     g_print("Visualizer stopped\n");
 }
@@ -734,22 +2223,7 @@ void visualizer_set_target_pid(VisualizerState *state, guint32 pid, const gchar
         // pw_find_sink_input_by_pid walks the process tree
         sink_input = pw_find_sink_input_by_pid(pid);
         if (sink_input < 0) {
-            // Try walking the tree manually
-            gchar *cmd = g_strdup_printf("pgrep -P %u", pid);
-            gchar *output = NULL;
-            if (g_spawn_command_line_sync(cmd, &output, NULL, NULL, NULL) && output) {
-                gchar **child_pids = g_strsplit(output, "\n", -1);
-                for (gchar **p = child_pids; *p && **p; p++) {
-                    guint32 child_pid = (guint32)g_ascii_strtoull(*p, NULL, 10);
-                    if (child_pid > 0) {
-                        sink_input = pw_find_sink_input_by_pid(child_pid);
-                        if (sink_input >= 0) break;
-                    }
-                }
-                g_strfreev(child_pids);
-                g_free(output);
-            }
-            g_free(cmd);
+            sink_input = find_sink_input_of_children(pid);
         }
     }
 
@@ -764,14 +2238,12 @@ void visualizer_set_target_pid(VisualizerState *state, guint32 pid, const gchar
         sink_input = pw_find_sink_input_by_app_name(app_name);
     }
 
+    // The sink comes from the graph once the stream node is found
+    state->target_sink_id = -1;
     if (sink_input >= 0) {
         state->target_serial = sink_input;
-        // Look up which sink this stream outputs to
-        state->target_sink_id = pw_find_sink_for_input(sink_input);
-        g_print("Visualizer: Found sink-input %d for PID %u (sink node %d)\n",
-                sink_input, pid, state->target_sink_id);
+        g_print("Visualizer: Found sink-input %d for PID %u\n", sink_input, pid);
     } else {
-        state->target_sink_id = -1;
         g_print("Visualizer: No sink-input found for PID %u\n", pid);
     }
 
@@ -788,6 +2260,156 @@ void visualizer_set_target_pid(VisualizerState *state, guint32 pid, const gchar
     }
 }
 
+void visualizer_set_analysis_rate(VisualizerState *state, guint32 rate) {
+    if (!state) return;
+
+    // The DSP belongs to the thread loop
+    if (state->pw_loop) pw_thread_loop_lock(state->pw_loop);
+    state->analysis_rate = rate;
+    if (state->dsp.rate > 0) {
+        viz_dsp_configure(&state->dsp, state->dsp.rate, state->dsp.channels, rate);
+    }
+    if (state->pw_loop) pw_thread_loop_unlock(state->pw_loop);
+
+    if (rate > 0) {
+        g_print("Visualizer: Analysis decimated to ~%u Hz mono\n", rate);
+    } else {
+        g_print("Visualizer: Analysis at native rate\n");
+    }
+}
+
+static const gchar *mode_names[VISUALIZER_MODE_COUNT] = {
+    [VISUALIZER_MODE_BARS] = "bars",
+    [VISUALIZER_MODE_LOUDNESS] = "loudness",
+    [VISUALIZER_MODE_SPECTROGRAM] = "spectrogram",
+    [VISUALIZER_MODE_GONIOMETER] = "goniometer",
+    [VISUALIZER_MODE_OSCILLOSCOPE] = "oscilloscope",
+    [VISUALIZER_MODE_CHROMA] = "chroma",
+};
+
+VisualizerMode visualizer_mode_from_string(const gchar *name) {
+    if (name) {
+        for (int i = 0; i < VISUALIZER_MODE_COUNT; i++) {
+            if (g_ascii_strcasecmp(name, mode_names[i]) == 0) {
+                return (VisualizerMode)i;
+            }
+        }
+        g_printerr("Visualizer: Unknown mode '%s', using bars\n", name);
+    }
+    return VISUALIZER_MODE_BARS;
+}
+
+const gchar* visualizer_mode_to_string(VisualizerMode mode) {
+    if (mode < 0 || mode >= VISUALIZER_MODE_COUNT) return "bars";
+    return mode_names[mode];
+}
+
+void visualizer_set_format_label(VisualizerState *state, GtkWidget *label) {
+    if (!state) return;
+
+    g_mutex_lock(&state->data_mutex);
+    state->format_label = label;
+    queue_format_update(state);
+    g_mutex_unlock(&state->data_mutex);
+}
+
+gchar* visualizer_get_latency_stats(VisualizerState *state) {
+    if (!state) return NULL;
+
+    GString *text = g_string_new(NULL);
+    append_series(text, "capture→analysis", &state->lat_capture_analysis);
+    append_series(text, "analysis→present", &state->lat_analysis_present);
+    append_series(text, "capture→present", &state->lat_capture_present);
+    append_series(text, "present-due", &state->lat_late);
+
+    guint64 total = state->frames_presented + state->frames_dropped;
+    g_string_append_printf(text, "frames: %" G_GUINT64_FORMAT " presented, %" G_GUINT64_FORMAT
+                           " dropped (%.1f%%)\n",
+                           state->frames_presented, state->frames_dropped,
+                           total > 0 ? 100.0 * state->frames_dropped / total : 0.0);
+
+    g_mutex_lock(&state->data_mutex);
+    gint latency_ms = state->bar_latency_ms;
+    g_mutex_unlock(&state->data_mutex);
+    g_string_append_printf(text, "output latency compensation: %d ms", latency_ms);
+
+    return g_string_free(text, FALSE);
+}
+
+gchar* visualizer_get_rt_health(VisualizerState *state) {
+    if (!state) return NULL;
+
+    char text[1024];
+    rt_health_format(&state->rt_health, text, sizeof(text));
+    return g_strdup(text);
+}
+
+gchar* visualizer_get_signal_path(VisualizerState *state) {
+    if (!state) return NULL;
+
+    g_mutex_lock(&state->data_mutex);
+    gchar *path = g_strdup(state->signal_path);
+    g_mutex_unlock(&state->data_mutex);
+    return path;
+}
+
+void visualizer_track_changed(VisualizerState *state) {
+    if (!state) return;
+    g_atomic_int_set(&state->authenticity_reset_pending, 1);
+
+    // Drop the previous track's verdict right away; the rate stays
+    g_mutex_lock(&state->data_mutex);
+    memset(&state->report, 0, sizeof(state->report));
+    queue_format_update(state);
+    g_mutex_unlock(&state->data_mutex);
+}
+
+void visualizer_set_mode(VisualizerState *state, VisualizerMode mode) {
+    if (!state || mode < 0 || mode >= VISUALIZER_MODE_COUNT) return;
+
+    VisualizerMode old = (VisualizerMode)g_atomic_int_get(&state->mode);
+    if (old == mode) return;
+
+    // The meter and key finder only run while shown; start them from a clean slate
+    if (mode == VISUALIZER_MODE_LOUDNESS) {
+        g_atomic_int_set(&state->loudness_reset_pending, 1);
+    }
+    if (mode == VISUALIZER_MODE_CHROMA) {
+        g_atomic_int_set(&state->chroma_reset_pending, 1);
+    }
+    g_atomic_int_set(&state->mode, mode);
+
+    switch (mode) {
+        case VISUALIZER_MODE_LOUDNESS:
+            visualizer_view_set_snapshot_func(VISUALIZER_VIEW(state->view), snapshot_loudness, state);
+            break;
+        case VISUALIZER_MODE_SPECTROGRAM:
+            // Start from an empty history; stale columns would show a time gap
+            spectrogram_clear(state);
+            visualizer_view_set_snapshot_func(VISUALIZER_VIEW(state->view), snapshot_spectrogram, state);
+            break;
+        case VISUALIZER_MODE_GONIOMETER:
+            visualizer_view_set_snapshot_func(VISUALIZER_VIEW(state->view), snapshot_goniometer, state);
+            break;
+        case VISUALIZER_MODE_OSCILLOSCOPE:
+            // History only advances while shown; don't flash the old trace
+            state->scope_draw_count = 0;
+            visualizer_view_set_snapshot_func(VISUALIZER_VIEW(state->view), snapshot_oscilloscope, state);
+            break;
+        case VISUALIZER_MODE_CHROMA:
+            visualizer_view_set_snapshot_func(VISUALIZER_VIEW(state->view), snapshot_chroma, state);
+            break;
+        default:
+            visualizer_view_set_snapshot_func(VISUALIZER_VIEW(state->view), NULL, NULL);
+            break;
+    }
+
+    gtk_widget_set_visible(state->bars_box, mode == VISUALIZER_MODE_BARS);
+    gtk_widget_set_visible(state->view, mode != VISUALIZER_MODE_BARS);
+
+    g_print("Visualizer: %s mode\n", mode_names[mode]);
+}
+
 void visualizer_retry_target(VisualizerState *state) {
     if (!state || (state->target_pid == 0 && !state->target_bus_name)) return;
 
@@ -802,21 +2424,7 @@ void visualizer_retry_target(VisualizerState *state) {
         sink_input = pw_find_sink_input_by_pid(state->target_pid);
         if (sink_input < 0) {
             // Try child processes
-            gchar *cmd = g_strdup_printf("pgrep -P %u", state->target_pid);
-            gchar *output = NULL;
-            if (g_spawn_command_line_sync(cmd, &output, NULL, NULL, NULL) && output) {
-                gchar **child_pids = g_strsplit(output, "\n", -1);
-                for (gchar **p = child_pids; *p && **p; p++) {
-                    guint32 child_pid = (guint32)g_ascii_strtoull(*p, NULL, 10);
-                    if (child_pid > 0) {
-                        sink_input = pw_find_sink_input_by_pid(child_pid);
-                        if (sink_input >= 0) break;
-                    }
-                }
-                g_strfreev(child_pids);
-                g_free(output);
-            }
-            g_free(cmd);
+            sink_input = find_sink_input_of_children(state->target_pid);
         }
     }
 
@@ -847,16 +2455,26 @@ void visualizer_retry_target(VisualizerState *state) {
 void visualizer_cleanup(VisualizerState *state) {
     if (!state) return;
 
-    if (state->render_timer > 0) {
-        g_source_remove(state->render_timer);
-    }
+    animation_cancel(state->render_ticker);
+    animation_cancel(state->fade_animation);
 
-    if (state->fade_timer > 0) {
-        g_source_remove(state->fade_timer);
+    if (state->frame_clock && state->after_paint_handler > 0) {
+        g_signal_handler_disconnect(state->frame_clock, state->after_paint_handler);
     }
 
     visualizer_stop(state);
 
+    g_mutex_lock(&state->data_mutex);
+    if (state->format_update > 0) {
+        g_source_remove(state->format_update);
+        state->format_update = 0;
+    }
+    g_mutex_unlock(&state->data_mutex);
+
+    if (state->analysis_event) {
+        pw_loop_destroy_source(pw_thread_loop_get_loop(state->pw_loop), state->analysis_event);
+    }
+
     if (state->pw_context) {
         pw_context_destroy(state->pw_context);
     }
@@ -870,7 +2488,14 @@ void visualizer_cleanup(VisualizerState *state) {
     if (state->audio_nodes) {
         g_hash_table_destroy(state->audio_nodes);
     }
+    pw_graph_free(state->graph);
+    g_free(state->signal_path);
     g_mutex_clear(&state->data_mutex);
+    g_free(state->ring_data);
+    g_clear_object(&state->spec_texture);
+    g_free(state->spec_pixels);
+    g_clear_object(&state->gonio_texture);
+    g_free(state->gonio_pixels);
     g_free(state);
 
     pw_deinit();
@@ -4,14 +4,81 @@
 #include <gtk/gtk.h>
 #include <pipewire/pipewire.h>
 #include <spa/param/audio/format-utils.h>
+#include <spa/param/latency-utils.h>
 #include <spa/utils/hook.h>
+#include <spa/utils/ringbuffer.h>
+#include "authenticity.h"
+#include "chroma.h"
+#include "goniometer.h"
+#include "latency_stats.h"
+#include "loudness.h"
+#include "oscilloscope.h"
+#include "pw_graph.h"
+#include "rt_health.h"
+#include "spectrogram.h"
+#include "visualizer_dsp.h"
+#include "visualizer_view.h"
 
-#define VISUALIZER_BARS 55
+#define VISUALIZER_BARS VIZ_DSP_BANDS
 #define VISUALIZER_UPDATE_FPS 60
+#define VISUALIZER_FADE_IN_MS 640
+#define VISUALIZER_FADE_OUT_MS 320
+#define VISUALIZER_PEAK_HOLD_MS 80       // Rendered bars hold a new peak this long
+#define VISUALIZER_FALL_PER_SEC 2.5      // ...then fall at this fraction of full height per second
+#define VISUALIZER_RING_FRAMES 32768     // RT -> analysis ring (power of two, ~170 ms at 192 kHz)
+#define VISUALIZER_RING_CHANNELS LOUDNESS_MAX_CHANNELS
+#define VISUALIZER_SPECTROGRAM_COLUMNS 300   // Pixel ring width (6 s at 20 ms per column)
+#define VISUALIZER_BAR_QUEUE 128         // Delayed bar frames (power of two, > max latency x push rate)
+#define VISUALIZER_BAR_PUSH_HZ 120       // Bar frames queued per second at most
+#define VISUALIZER_MAX_LATENCY_MS 500    // Output latency compensation is capped here
+#define VISUALIZER_PAINTED_FRAMES 8      // Painted bar frames waiting for presentation feedback
+
+typedef enum {
+    VISUALIZER_MODE_BARS,
+    VISUALIZER_MODE_LOUDNESS,     // EBU R128 momentary/short-term/integrated + true-peak
+    VISUALIZER_MODE_SPECTROGRAM,  // Scrolling waterfall
+    VISUALIZER_MODE_GONIOMETER,   // Stereo vectorscope + phase correlation
+    VISUALIZER_MODE_OSCILLOSCOPE, // Triggered waveform
+    VISUALIZER_MODE_CHROMA,       // 12 pitch classes + estimated key
+    VISUALIZER_MODE_COUNT
+} VisualizerMode;
+
+// Negotiated SPA_PARAM_Format of a graph node, followed through a node
+// proxy subscription (thread loop only)
+typedef struct {
+    struct pw_proxy *proxy;       // NULL = not watching
+    struct spa_hook listener;
+    guint32 id;
+    gpointer state;               // Owning VisualizerState
+    struct spa_audio_info_raw format;   // rate 0 = none (suspended/unknown)
+    gboolean soft_volume;         // Volume/mute applied in software on this node
+    struct spa_latency_info latency;                  // Input-side latency (sinks: to the device)
+    struct spa_process_latency_info process_latency;  // Added by the node itself
+} NodeFormatWatch;
+
+// Bars as analyzed, shown once the audio they came from is audible
+typedef struct {
+    gint64 captured;              // Monotonic time (us) of the capture cycle
+    gint64 analyzed;              // ...when the analysis published it
+    gint64 due;                   // ...when to show it (captured + output latency)
+    gdouble heights[VISUALIZER_BARS];
+} VisualizerBarFrame;
+
+// A painted bar frame until the frame clock knows when it reached the screen
+typedef struct {
+    gint64 captured;
+    gint64 analyzed;
+    gint64 due;
+    gint64 frame_counter;         // Frame clock frame it was painted in
+    gint64 frame_time;            // Fallback if the backend reports no presentation time
+} VisualizerPaintedFrame;
 
 typedef struct {
-    GtkWidget *container;  // Main container with bars
+    GtkWidget *container;  // Main container (bars box or view, by mode)
+    GtkWidget *bars_box;
     GtkWidget *bars[VISUALIZER_BARS];
+    GtkWidget *view;       // VisualizerView for snapshot-rendered modes
+    GtkWidget *format_label;   // Stream/sink format and authenticity verdict (owned by the layout)
 
     // PipeWire context
     struct pw_thread_loop *pw_loop;
@@ -30,29 +97,138 @@ typedef struct {
     gchar *target_bus_name;       // MPRIS bus name for app-name fallback matching
     gint target_serial;           // PipeWire object.serial (same as pactl sink-input index)
     gint target_sink_id;          // PipeWire node ID of the sink the player outputs to
-    guint32 target_node_id;       // PipeWire node ID to capture from
+    guint32 target_node_id;       // PipeWire node ID of the player's stream (capture source)
     gchar *target_node_name;      // Node name for logging
     gboolean target_found;        // Whether we found the target node
 
     // Node cache for searching when target changes
     GHashTable *audio_nodes;      // node_id -> AudioNodeInfo*
 
-    // Audio data
-    gdouble bar_heights[VISUALIZER_BARS];
-    gdouble bar_smoothed[VISUALIZER_BARS];
+    // Mirror of the audio graph, for the player -> device signal path
+    PwGraph *graph;
+
+    // What the player hands PipeWire vs what the sink runs at
+    NodeFormatWatch stream_watch;
+    NodeFormatWatch sink_watch;
+
+    // Negotiated capture format (native rate/channels of the target node)
+    struct spa_audio_info_raw format;
+    gboolean format_planar;       // F32P (one buffer per channel) vs interleaved F32
+    guint32 analysis_rate;        // Decimated analysis rate in Hz, 0 = native
+
+    // RT -> analysis handoff. The data thread only copies frames into the
+    // ring and signals analysis_event; all DSP runs on the thread loop.
+    struct spa_ringbuffer ring;
+    float *ring_data;             // VISUALIZER_RING_FRAMES * ring_channels floats
+    guint32 ring_channels;        // Channels stored per frame (0 = not negotiated)
+    guint ring_overruns;          // Buffers truncated because analysis fell behind
+    guint ring_overruns_reported;
+    atomic_uint quantum_frames;   // Graph quantum in frames (written by the data thread)
+    struct spa_source *analysis_event;
+
+    // Process callback diagnostics (lock-free, written by the data thread)
+    RtHealth rt_health;
+    struct spa_io_position *position;   // Graph clock, from io_changed
+    guint rt_problems_reported;   // Sum of the problem counters last logged (analysis)
+
+    // Analysis (thread loop only)
+    VizDsp dsp;                   // Downmix, decimation, filter bank and AGC
+    LoudnessMeter loudness;
+    gint loudness_reset_pending;  // Set from GTK thread, consumed by analysis
+    Spectrogram spectrogram;
+    Goniometer goniometer;
+    Oscilloscope oscilloscope;
+    Chroma chroma;
+    gint chroma_reset_pending;    // Set from GTK thread, consumed by analysis
+    Authenticity authenticity;    // Runs in every mode, restarted per track
+    gint authenticity_reset_pending;
+    gint64 report_checked_at;
+    gint scope_columns;           // Trace width in device pixels (set by the GTK thread, atomic)
+    gint64 frame_rendered_at;     // Per-frame work (tone-mapping, triggering) runs at most at display rate
+    gint64 output_latency_us;     // Sink latency the bars are delayed by
+    guint32 latency_quantum;      // Quantum output_latency_us was computed for
+    gint64 bars_pushed_at;
+
+    // Published results (data_mutex)
+    VisualizerBarFrame bar_queue[VISUALIZER_BAR_QUEUE];   // Ring, oldest at bar_queue_tail
+    guint bar_queue_tail;
+    guint bar_queue_count;
+    gdouble bar_heights[VISUALIZER_BARS];                // Latest due frame (taken by the GTK thread)
+    gint bar_latency_ms;          // Compensation in effect, for the format label
+    guint bar_queue_dropped;      // Frames pushed out of a full queue, not yet counted
+    LoudnessReadings loudness_readings;
+    guint8 spec_columns[SPECTROGRAM_PENDING][SPECTROGRAM_ROWS];
+    guint spec_column_count;
+    guint8 gonio_image[GONIOMETER_SIZE * GONIOMETER_SIZE];
+    gfloat gonio_correlation;
+    gboolean gonio_dirty;
+    gfloat scope_min[OSCILLOSCOPE_MAX_COLUMNS];
+    gfloat scope_max[OSCILLOSCOPE_MAX_COLUMNS];
+    guint scope_column_count;
+    gboolean scope_triggered;
+    gboolean scope_dirty;
+    gfloat chroma_classes[CHROMA_CLASSES];
+    gint chroma_key;
+    AuthenticityReport report;
+    guint32 report_rate;          // 0 = no stream
+    struct spa_audio_info_raw stream_format;  // Player stream node format (rate 0 = unknown)
+    struct spa_audio_info_raw sink_format;    // Sink node format (rate 0 = unknown)
+    gchar *signal_path;           // pw_graph path text, NULL = none
+    gboolean report_dirty;
+    guint format_update;          // Idle source refreshing the format label, 0 = none
 
-    // Automatic Gain Control (AGC) - makes visualization volume-independent
-    gdouble agc_peak;             // Current tracked peak level
-    gdouble agc_attack;           // How fast peak rises (0-1)
-    gdouble agc_decay;            // How fast peak falls (0-1)
+    // Spectrogram pixel ring (GTK thread only): RGBA premultiplied,
+    // VISUALIZER_SPECTROGRAM_COLUMNS x SPECTROGRAM_ROWS, row 0 = highest
+    // frequency. New columns are written at spec_write_col and uploaded
+    // as an update region of the previous texture.
+    guint8 *spec_pixels;
+    guint spec_write_col;         // Next column to write == oldest column shown
+    GdkTexture *spec_texture;
+
+    // Goniometer texture (GTK thread only), rebuilt whole from gonio_image
+    guint8 *gonio_pixels;
+    GdkTexture *gonio_texture;
+
+    // Oscilloscope trace being drawn (GTK thread only)
+    gfloat scope_draw_min[OSCILLOSCOPE_MAX_COLUMNS];
+    gfloat scope_draw_max[OSCILLOSCOPE_MAX_COLUMNS];
+    guint scope_draw_count;
+    gboolean scope_draw_triggered;
+
+    // Intensity -> premultiplied RGBA in the theme color (spectrogram, goniometer)
+    guint8 intensity_lut[256][4];
+    GdkRGBA intensity_lut_color;
+
+    // Audio-to-photon instrumentation (GTK thread only). A frame taken from
+    // the queue is painted at the next frame-clock paint of the container and
+    // presented when that frame's timings report it on screen.
+    GdkFrameClock *frame_clock;
+    gulong after_paint_handler;
+    VisualizerBarFrame presenting;    // Stamps of the frame waiting for paint
+    gboolean presenting_pending;
+    VisualizerPaintedFrame painted[VISUALIZER_PAINTED_FRAMES];  // Oldest first
+    guint painted_count;
+    LatencySeries lat_capture_analysis;
+    LatencySeries lat_analysis_present;
+    LatencySeries lat_capture_present;
+    LatencySeries lat_late;           // Present - due: >0 means the bars lag the sound
+    guint64 frames_presented;
+    guint64 frames_dropped;           // Analyzed but never painted
+
+    // Rendered bars (GTK thread only): peak-hold and fall-off per frame
+    gdouble bar_display[VISUALIZER_BARS];
+    gint64 bar_hold_until[VISUALIZER_BARS];
+    gint64 last_render_time;
 
     // State
+    gint mode;                    // VisualizerMode (atomic, read by analysis)
     gboolean is_showing;
     gboolean is_running;
     gboolean is_vertical;         // Layout orientation
-    guint render_timer;
-    guint fade_timer;
+    guint render_ticker;          // Every frame from show until the fade-out ends
+    guint fade_animation;
     gdouble fade_opacity;
+    gdouble fade_from;            // Opacity the running fade started at
 
     // Thread safety
     GMutex data_mutex;
@@ -73,6 +249,33 @@ void visualizer_stop(VisualizerState *state);
 // bus_name is used for app-name fallback when PID matching fails (ALSA players)
 void visualizer_set_target_pid(VisualizerState *state, guint32 pid, const gchar *bus_name);
 
+// Set the decimated analysis rate in Hz (0 = analyze at the native rate)
+void visualizer_set_analysis_rate(VisualizerState *state, guint32 rate);
+
+// Show the player's format, sink rate match and authenticity verdict in this label
+void visualizer_set_format_label(VisualizerState *state, GtkWidget *label);
+
+// Player -> device signal path as text (newly allocated, NULL if unknown)
+gchar* visualizer_get_signal_path(VisualizerState *state);
+
+// Rolling capture -> analysis -> present latency percentiles and dropped
+// frames as text (newly allocated)
+gchar* visualizer_get_latency_stats(VisualizerState *state);
+
+// Process callback duration histogram and buffer/xrun/RT-safety counters
+// as text (newly allocated)
+gchar* visualizer_get_rt_health(VisualizerState *state);
+
+// A new track started: restart per-track analysis
+void visualizer_track_changed(VisualizerState *state);
+
+// Switch what the visualizer shows (bars, loudness meter, ...)
+void visualizer_set_mode(VisualizerState *state, VisualizerMode mode);
+
+// Parse a [Visualizer] mode name; unknown names fall back to bars
+VisualizerMode visualizer_mode_from_string(const gchar *name);
+const gchar* visualizer_mode_to_string(VisualizerMode mode);
+
 // Retry finding sink-input for current target (call when playback starts)
 void visualizer_retry_target(VisualizerState *state);
 
@@ -0,0 +1,234 @@
+#include "visualizer_dsp.h"
+#include <math.h>
+#include <string.h>
+
+#define BAND_MIN_HZ 40.0
+#define BAND_MAX_HZ 16000.0
+#define BAND_MAX_NYQUIST 0.45     // Top band stays below this fraction of the analysis rate
+#define LOWPASS_NYQUIST 0.45      // Anti-alias cutoff, as a fraction of the analysis rate
+
+#define ATTACK_MS 25.0            // Bar rise time constant
+#define RELEASE_MS 120.0          // Bar fall time constant
+#define AGC_ATTACK_MS 200.0       // Fast attack - quickly respond to louder audio
+#define AGC_RELEASE_MS 20000.0    // Very slow decay - maintain level during quiet parts
+#define AGC_BAND_WEIGHT 0.5       // 0 = one global gain, 1 = fully independent bands
+#define AGC_MIN_THRESHOLD 0.0001  // Minimum level to avoid amplifying silence
+#define OUTPUT_SCALE 0.9
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// One-pole coefficient for time constant tau_ms evaluated every dt seconds
+static double time_coef(double tau_ms, double dt) {
+    return exp(-dt / (tau_ms / 1000.0));
+}
+
+// RBJ band-pass (0 dB peak gain) centred on freq
+static void band_design(VizBand *band, double freq, double q, double rate) {
+    double w0 = 2.0 * M_PI * freq / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+
+    band->b0 = (float)(alpha / a0);
+    band->b2 = (float)(-alpha / a0);
+    band->a1 = (float)(-2.0 * cos(w0) / a0);
+    band->a2 = (float)((1.0 - alpha) / a0);
+}
+
+// RBJ low-pass; one section of the anti-alias cascade
+static void lowpass_design(VizLowpass *lp, double fc, double q, double rate) {
+    double w0 = 2.0 * M_PI * fc / rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double cosw = cos(w0);
+    double a0 = 1.0 + alpha;
+
+    lp->b0 = (float)((1.0 - cosw) / 2.0 / a0);
+    lp->b1 = (float)((1.0 - cosw) / a0);
+    lp->b2 = lp->b0;
+    lp->a1 = (float)(-2.0 * cosw / a0);
+    lp->a2 = (float)((1.0 - alpha) / a0);
+}
+
+static inline float lowpass_run(VizLowpass *lp, float x) {
+    float y = lp->b0 * x + lp->z1;
+    lp->z1 = lp->b1 * x - lp->a1 * y + lp->z2;
+    lp->z2 = lp->b2 * x - lp->a2 * y;
+    return y;
+}
+
+static void clear_history(VizDsp *dsp) {
+    dsp->dec_count = 0;
+    for (int s = 0; s < VIZ_DSP_LOWPASS_SECTIONS; s++) {
+        dsp->lowpass[s].z1 = 0.0f;
+        dsp->lowpass[s].z2 = 0.0f;
+    }
+    dsp->hop_pos = 0;
+    for (int i = 0; i < VIZ_DSP_BANDS; i++) {
+        dsp->bands[i].z1 = 0.0f;
+        dsp->bands[i].z2 = 0.0f;
+        dsp->band_sum[i] = 0.0;
+        dsp->envelope[i] = 0.0;
+        dsp->agc_peak[i] = AGC_MIN_THRESHOLD;
+        dsp->bars[i] = 0.0;
+    }
+}
+
+void viz_dsp_init(VizDsp *dsp) {
+    memset(dsp, 0, sizeof(*dsp));
+    dsp->decimation = 1;
+    clear_history(dsp);
+}
+
+void viz_dsp_configure(VizDsp *dsp, uint32_t rate, uint32_t channels, uint32_t analysis_rate) {
+    if (channels > VIZ_DSP_MAX_CHANNELS) channels = VIZ_DSP_MAX_CHANNELS;
+
+    dsp->rate = rate;
+    dsp->channels = channels;
+    dsp->decimation = 1;
+    if (analysis_rate > 0 && rate > analysis_rate) {
+        dsp->decimation = rate / analysis_rate;
+    }
+    dsp->analysis_rate = rate / dsp->decimation;
+
+    if (dsp->analysis_rate == 0) {
+        dsp->rate = 0;
+        return;
+    }
+
+    // Everything above the analysis Nyquist has to go before frames are
+    // dropped, or it folds back into the bands. Butterworth section Qs for
+    // 8th order; at 12 kHz analysis, content folding below 2 kHz is down
+    // 60 dB or more, into the top bands 25-35 dB.
+    static const double lowpass_q[VIZ_DSP_LOWPASS_SECTIONS] = {
+        0.50979558, 0.60134489, 0.89997622, 2.56291545
+    };
+    for (int s = 0; s < VIZ_DSP_LOWPASS_SECTIONS; s++) {
+        lowpass_design(&dsp->lowpass[s], dsp->analysis_rate * LOWPASS_NYQUIST, lowpass_q[s], rate);
+    }
+
+    // Log-spaced band centres; Q matches the spacing so neighbours overlap
+    // at roughly -3 dB
+    double top = BAND_MAX_HZ;
+    if (top > dsp->analysis_rate * BAND_MAX_NYQUIST) top = dsp->analysis_rate * BAND_MAX_NYQUIST;
+    double ratio = pow(top / BAND_MIN_HZ, 1.0 / (VIZ_DSP_BANDS - 1));
+    double q = sqrt(ratio) / (ratio - 1.0);
+    for (int i = 0; i < VIZ_DSP_BANDS; i++) {
+        band_design(&dsp->bands[i], BAND_MIN_HZ * pow(ratio, i), q, dsp->analysis_rate);
+    }
+
+    // Fixed-duration hop; coefficients follow from its real length
+    dsp->hop_len = dsp->analysis_rate * VIZ_DSP_HOP_MS / 1000;
+    if (dsp->hop_len == 0) dsp->hop_len = 1;
+    double dt = (double)dsp->hop_len / dsp->analysis_rate;
+    dsp->attack_coef = time_coef(ATTACK_MS, dt);
+    dsp->release_coef = time_coef(RELEASE_MS, dt);
+    dsp->agc_attack_coef = time_coef(AGC_ATTACK_MS, dt);
+    dsp->agc_release_coef = time_coef(AGC_RELEASE_MS, dt);
+
+    clear_history(dsp);
+}
+
+void viz_dsp_reset(VizDsp *dsp) {
+    clear_history(dsp);
+}
+
+// Close a hop: band RMS -> envelope -> per-band AGC -> bars
+static void end_hop(VizDsp *dsp) {
+    double rms[VIZ_DSP_BANDS];
+    double global_peak = AGC_MIN_THRESHOLD;
+
+    for (int s = 0; s < VIZ_DSP_LOWPASS_SECTIONS; s++) {
+        if (fabsf(dsp->lowpass[s].z1) < 1e-15f) dsp->lowpass[s].z1 = 0.0f;
+        if (fabsf(dsp->lowpass[s].z2) < 1e-15f) dsp->lowpass[s].z2 = 0.0f;
+    }
+
+    for (int i = 0; i < VIZ_DSP_BANDS; i++) {
+        // sqrt(2) so a full-scale sine in a band reads 1.0
+        rms[i] = sqrt(2.0 * dsp->band_sum[i] / (double)dsp->hop_len);
+        dsp->band_sum[i] = 0.0;
+
+        // Flush decaying filter state before it turns denormal
+        if (fabsf(dsp->bands[i].z1) < 1e-15f) dsp->bands[i].z1 = 0.0f;
+        if (fabsf(dsp->bands[i].z2) < 1e-15f) dsp->bands[i].z2 = 0.0f;
+
+        double coef = rms[i] > dsp->envelope[i] ? dsp->attack_coef : dsp->release_coef;
+        dsp->envelope[i] = coef * dsp->envelope[i] + (1.0 - coef) * rms[i];
+
+        // Update AGC peak with attack/decay
+        if (dsp->envelope[i] > dsp->agc_peak[i]) {
+            dsp->agc_peak[i] = dsp->agc_attack_coef * dsp->agc_peak[i] +
+                               (1.0 - dsp->agc_attack_coef) * dsp->envelope[i];
+        } else {
+            dsp->agc_peak[i] *= dsp->agc_release_coef;
+        }
+        if (dsp->agc_peak[i] < AGC_MIN_THRESHOLD) dsp->agc_peak[i] = AGC_MIN_THRESHOLD;
+        if (dsp->agc_peak[i] > global_peak) global_peak = dsp->agc_peak[i];
+    }
+
+    // Each band is normalized against a blend of its own peak and the loudest
+    // band, so quiet bands are lifted without flattening the spectrum
+    for (int i = 0; i < VIZ_DSP_BANDS; i++) {
+        double reference = pow(dsp->agc_peak[i], AGC_BAND_WEIGHT) *
+                           pow(global_peak, 1.0 - AGC_BAND_WEIGHT);
+        double normalized = dsp->envelope[i] / reference * OUTPUT_SCALE;
+        if (normalized > 1.0) normalized = 1.0;
+        dsp->bars[i] = normalized;
+    }
+}
+
+// Decimate one mono frame and run it through the filter bank
+static inline void push_mono(VizDsp *dsp, float mono) {
+    float x = mono;
+    if (dsp->decimation > 1) {
+        for (int s = 0; s < VIZ_DSP_LOWPASS_SECTIONS; s++) {
+            x = lowpass_run(&dsp->lowpass[s], x);
+        }
+        if (++dsp->dec_count < dsp->decimation) return;
+        dsp->dec_count = 0;
+    }
+
+    for (int i = 0; i < VIZ_DSP_BANDS; i++) {
+        VizBand *b = &dsp->bands[i];
+        float y = b->b0 * x + b->z1;
+        b->z1 = -b->a1 * y + b->z2;
+        b->z2 = b->b2 * x - b->a2 * y;
+        dsp->band_sum[i] += (double)y * y;
+    }
+
+    if (++dsp->hop_pos >= dsp->hop_len) {
+        dsp->hop_pos = 0;
+        end_hop(dsp);
+    }
+}
+
+void viz_dsp_process_interleaved(VizDsp *dsp, const float *samples, size_t n_frames) {
+    if (dsp->rate == 0 || dsp->channels == 0 || n_frames == 0) return;
+
+    const uint32_t channels = dsp->channels;
+    const float scale = 1.0f / (float)channels;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *frame = samples + f * channels;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; c++) {
+            sum += frame[c];
+        }
+        push_mono(dsp, sum * scale);
+    }
+}
+
+void viz_dsp_process_planar(VizDsp *dsp, const float *const *planes, size_t n_frames) {
+    if (dsp->rate == 0 || dsp->channels == 0 || n_frames == 0) return;
+
+    const uint32_t channels = dsp->channels;
+    const float scale = 1.0f / (float)channels;
+
+    for (size_t f = 0; f < n_frames; f++) {
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; c++) {
+            sum += planes[c][f];
+        }
+        push_mono(dsp, sum * scale);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef VISUALIZER_DSP_H
+#define VISUALIZER_DSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Visualizer DSP
+ *
+ * Format-agnostic analysis behind the bar visualizer. Accepts whatever rate
+ * and channel layout PipeWire negotiated (interleaved or planar F32), folds
+ * it to mono and optionally decimates it to a lower analysis rate (behind an
+ * anti-alias low-pass) before the bars are computed.
+ *
+ * Bars are a log-spaced band-pass filter bank. Band energy is evaluated in
+ * fixed-duration hops rather than per PipeWire buffer, and all attack/release
+ * behaviour is specified in milliseconds, so the output is the same whatever
+ * quantum the graph runs at.
+ *
+ * Plain C with no GTK, GLib or PipeWire dependency: it runs on the PipeWire
+ * data thread, never allocates, and can be linked into offline tools.
+ */
+
+#define VIZ_DSP_BANDS 55
+#define VIZ_DSP_MAX_CHANNELS 64
+#define VIZ_DSP_HOP_MS 10
+
+typedef struct {
+    // Band-pass biquad (direct form II transposed)
+    float b0, b2, a1, a2;   // b1 is always 0 for a band-pass
+    float z1, z2;
+} VizBand;
+
+typedef struct {
+    // Anti-alias low-pass biquad (direct form II transposed)
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+} VizLowpass;
+
+#define VIZ_DSP_LOWPASS_SECTIONS 4  // 8th-order Butterworth ahead of decimation
+
+typedef struct {
+    // Negotiated input format (rate == 0 until configured)
+    uint32_t rate;
+    uint32_t channels;
+
+    // Decimation: input is low-passed below the analysis Nyquist, then every
+    // `decimation`-th frame is kept, so the analysis runs at rate / decimation
+    uint32_t decimation;
+    uint32_t analysis_rate;
+    VizLowpass lowpass[VIZ_DSP_LOWPASS_SECTIONS];
+    uint32_t dec_count;
+
+    // Filter bank and hop accumulators
+    VizBand bands[VIZ_DSP_BANDS];
+    double band_sum[VIZ_DSP_BANDS];
+    uint32_t hop_len;             // Analysis samples per hop
+    uint32_t hop_pos;
+
+    // Per-hop coefficients derived from the millisecond time constants
+    double attack_coef;
+    double release_coef;
+    double agc_attack_coef;
+    double agc_release_coef;
+
+    // Envelope, per-band AGC and output
+    double envelope[VIZ_DSP_BANDS];
+    double agc_peak[VIZ_DSP_BANDS];
+    double bars[VIZ_DSP_BANDS];   // 0.0 - 1.0, read by the renderer
+} VizDsp;
+
+// Zero all state; the DSP ignores input until viz_dsp_configure()
+void viz_dsp_init(VizDsp *dsp);
+
+// Apply a negotiated format. analysis_rate == 0 analyzes at the native rate,
+// otherwise input is decimated by the largest integer factor that keeps the
+// analysis rate at or above the requested one.
+void viz_dsp_configure(VizDsp *dsp, uint32_t rate, uint32_t channels, uint32_t analysis_rate);
+
+// Clear bars, AGC, filter and decimator history (format is kept)
+void viz_dsp_reset(VizDsp *dsp);
+
+// Feed one buffer of interleaved F32 frames
+void viz_dsp_process_interleaved(VizDsp *dsp, const float *samples, size_t n_frames);
+
+// Feed one buffer of planar F32 frames (one pointer per channel)
+void viz_dsp_process_planar(VizDsp *dsp, const float *const *planes, size_t n_frames);
+
+#endif // VISUALIZER_DSP_H
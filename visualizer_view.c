@@ -0,0 +1,48 @@
+#include "visualizer_view.h"
+
+struct _VisualizerView {
+    GtkWidget parent_instance;
+
+    VisualizerViewSnapshotFunc snapshot_func;
+    gpointer user_data;
+};
+
+G_DEFINE_FINAL_TYPE(VisualizerView, visualizer_view, GTK_TYPE_WIDGET)
+
+static void visualizer_view_snapshot(GtkWidget *widget, GtkSnapshot *snapshot) {
+    VisualizerView *self = VISUALIZER_VIEW(widget);
+
+    if (!self->snapshot_func) return;
+
+    int width = gtk_widget_get_width(widget);
+    int height = gtk_widget_get_height(widget);
+    if (width <= 0 || height <= 0) return;
+
+    self->snapshot_func(widget, snapshot, width, height, self->user_data);
+}
+
+static void visualizer_view_class_init(VisualizerViewClass *klass) {
+    GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+
+    widget_class->snapshot = visualizer_view_snapshot;
+    gtk_widget_class_set_css_name(widget_class, "visualizer-view");
+}
+
+static void visualizer_view_init(VisualizerView *self) {
+    self->snapshot_func = NULL;
+    self->user_data = NULL;
+}
+
+GtkWidget* visualizer_view_new(void) {
+    return g_object_new(VISUALIZER_TYPE_VIEW, NULL);
+}
+
+void visualizer_view_set_snapshot_func(VisualizerView *view,
+                                       VisualizerViewSnapshotFunc func,
+                                       gpointer user_data) {
+    g_return_if_fail(VISUALIZER_IS_VIEW(view));
+
+    view->snapshot_func = func;
+    view->user_data = user_data;
+    gtk_widget_queue_draw(GTK_WIDGET(view));
+}
@@ -0,0 +1,28 @@
+#ifndef VISUALIZER_VIEW_H
+#define VISUALIZER_VIEW_H
+
+#include <gtk/gtk.h>
+
+/**
+ * Visualizer View
+ *
+ * Minimal custom widget the non-bar visualizer modes render into. It owns no
+ * audio state: each frame it hands a GtkSnapshot and its allocated size to a
+ * snapshot function, so modes append render nodes directly instead of
+ * driving one GTK widget per element.
+ */
+
+#define VISUALIZER_TYPE_VIEW (visualizer_view_get_type())
+G_DECLARE_FINAL_TYPE(VisualizerView, visualizer_view, VISUALIZER, VIEW, GtkWidget)
+
+typedef void (*VisualizerViewSnapshotFunc)(GtkWidget *widget, GtkSnapshot *snapshot,
+                                           int width, int height, gpointer user_data);
+
+GtkWidget* visualizer_view_new(void);
+
+// Set the function that renders the view (NULL draws nothing)
+void visualizer_view_set_snapshot_func(VisualizerView *view,
+                                       VisualizerViewSnapshotFunc func,
+                                       gpointer user_data);
+
+#endif // VISUALIZER_VIEW_H
@@ -1,5 +1,6 @@
 #include "volume.h"
-#include "paths.h"
+#include "layout.h"
+#include "icon_cache.h"
 #include "pipewire_volume.h"
 #include <math.h>
 
@@ -46,9 +47,8 @@ void volume_update_icon(VolumeState *state, gint percentage) {
         icon_name = "volume-high.svg";
     }
 
-    gchar *icon_path = get_icon_path(icon_name);
-    gtk_image_set_from_file(GTK_IMAGE(state->icon), icon_path);
-    free_path(icon_path);
+    // Called on every slider tick: a cached paintable swap, no file access
+    icon_cache_set_image(state->icon, icon_name);
 }
 
 // Throttled volume setter to prevent lag
@@ -129,7 +129,7 @@ static void on_volume_changed(GtkRange *range, gpointer user_data) {
  * Initialize PipeWire state based on config and available sink-inputs.
  */
 static void init_pipewire_state(VolumeState *state) {
-    VolumeMethod method = get_config_volume_method();
+    VolumeMethod method = layout_get_config()->volume_method;
 
     // Reset PipeWire state
     state->pw_sink_input_index = -1;
@@ -198,11 +198,9 @@ VolumeState* volume_init(GDBusProxy *mpris_proxy, const gchar *mpris_bus_name, g
                                 initial_percentage <= 50 ? "volume-medium.svg" :
                                 "volume-high.svg";
 
-    gchar *icon_path = get_icon_path(initial_icon);
-    GtkWidget *icon = gtk_image_new_from_file(icon_path);
-    free_path(icon_path);
+    GtkWidget *icon = gtk_image_new_from_paintable(icon_cache_get(initial_icon));
     state->icon = icon;
-    gtk_image_set_pixel_size(GTK_IMAGE(icon), 20);
+    gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_CACHE_SIZE);
     gtk_widget_add_css_class(icon, "volume-icon");
 
     // Volume slider
@@ -395,7 +393,7 @@ gboolean volume_is_supported(VolumeState *state) {
     if (!state->mpris_proxy) return FALSE;
 
     // For auto mode, check if MPRIS volume works
-    VolumeMethod method = get_config_volume_method();
+    VolumeMethod method = layout_get_config()->volume_method;
     if (method == VOLUME_METHOD_PIPEWIRE) {
         // PipeWire-only mode but no sink-input
         return FALSE;